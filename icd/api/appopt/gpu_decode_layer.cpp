@@ -531,6 +531,8 @@ static VkResult gpuBlitImage(
     const VkImageCopy*                      pRegions,
     VkFormat                                realStagingFormat)
 {
+    pCmdBuffer->FlushPendingBarriers();
+
     Device* pDevice                 = pCmdBuffer->VkDevice();
     GpuDecoderLayer* pDecodeWrapper = pDevice->GetGpuDecoderLayer();
     const RuntimeSettings& settings = pDevice->GetRuntimeSettings();
@@ -637,6 +639,8 @@ static VkResult gpuBlitBuffer(
     const VkBufferImageCopy*                pRegions,
     VkFormat                                realStagingFormat)
 {
+    pCmdBuffer->FlushPendingBarriers();
+
     Device* pDevice                 = pCmdBuffer->VkDevice();
     GpuDecoderLayer* pDecodeWrapper = pDevice->GetGpuDecoderLayer();
     const RuntimeSettings& settings = pDevice->GetRuntimeSettings();
@@ -0,0 +1,265 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2022 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+#include "include/barrier_accumulator.h"
+#include "include/vk_image.h"
+
+#include "palVectorImpl.h"
+
+namespace vk
+{
+
+// =====================================================================================================================
+BarrierAccumulator::BarrierAccumulator(
+    PalAllocator* pAllocator)
+    :
+    m_srcStageMask(0),
+    m_dstStageMask(0),
+    m_pendingBarrierCount(0),
+    m_hasMemoryBarrier(false),
+    m_memoryBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, 0, 0 },
+    m_bufferBarriers(pAllocator),
+    m_imageBarriers(pAllocator)
+{
+}
+
+// =====================================================================================================================
+// Drops the pending barriers without issuing them, e.g. when the command buffer is reset.
+void BarrierAccumulator::Clear()
+{
+    m_srcStageMask                = 0;
+    m_dstStageMask                = 0;
+    m_pendingBarrierCount         = 0;
+    m_hasMemoryBarrier            = false;
+    m_memoryBarrier.srcAccessMask = 0;
+    m_memoryBarrier.dstAccessMask = 0;
+
+    m_bufferBarriers.Clear();
+    m_imageBarriers.Clear();
+}
+
+// =====================================================================================================================
+// Returns the pending barrier covering exactly the same buffer range and queue family transfer, if any.
+VkBufferMemoryBarrier* BarrierAccumulator::FindBufferBarrier(
+    const VkBufferMemoryBarrier& barrier)
+{
+    VkBufferMemoryBarrier* pMergeTarget = nullptr;
+
+    for (uint32_t i = 0; i < m_bufferBarriers.NumElements(); ++i)
+    {
+        VkBufferMemoryBarrier* pPending = &m_bufferBarriers.At(i);
+
+        if ((pPending->buffer              == barrier.buffer)              &&
+            (pPending->offset              == barrier.offset)              &&
+            (pPending->size                == barrier.size)                &&
+            (pPending->srcQueueFamilyIndex == barrier.srcQueueFamilyIndex) &&
+            (pPending->dstQueueFamilyIndex == barrier.dstQueueFamilyIndex))
+        {
+            pMergeTarget = pPending;
+            break;
+        }
+    }
+
+    return pMergeTarget;
+}
+
+// =====================================================================================================================
+// Looks for pending barriers of the same image.  Returns false if there is one which the given barrier can't be merged
+// with, so the pending barriers must be issued first.  Otherwise, *ppMergeTarget receives the pending barrier to merge
+// with, or nullptr if there is no pending barrier of the image.
+//
+// Two barriers are merged when they cover the same subresource range without a queue family ownership transfer and
+// the second one starts from the layout the first one transitions to.  The merged barrier transitions straight from
+// the first old layout to the second new layout.  Barriers of different images which may alias the same memory are
+// never issued together, since the order of their transitions matters as much as for the same image.
+bool BarrierAccumulator::FindImageBarrier(
+    const VkImageMemoryBarrier& barrier,
+    VkImageMemoryBarrier**      ppMergeTarget)
+{
+    const Image* pImage = Image::ObjectFromHandle(barrier.image);
+
+    bool mergeable = true;
+
+    *ppMergeTarget = nullptr;
+
+    for (uint32_t i = 0; i < m_imageBarriers.NumElements(); ++i)
+    {
+        VkImageMemoryBarrier* pPending = &m_imageBarriers.At(i);
+
+        if (pPending->image == barrier.image)
+        {
+            if ((*ppMergeTarget == nullptr)                                      &&
+                (pPending->newLayout           == barrier.oldLayout)             &&
+                (pPending->srcQueueFamilyIndex == pPending->dstQueueFamilyIndex) &&
+                (barrier.srcQueueFamilyIndex   == barrier.dstQueueFamilyIndex)   &&
+                (memcmp(&pPending->subresourceRange,
+                        &barrier.subresourceRange,
+                        sizeof(VkImageSubresourceRange)) == 0))
+            {
+                *ppMergeTarget = pPending;
+            }
+            else
+            {
+                // Transitions of overlapping ranges can't be issued in one PAL barrier since their order is undefined.
+                mergeable = false;
+                break;
+            }
+        }
+        else if (pImage->MayAliasMemory(Image::ObjectFromHandle(pPending->image)))
+        {
+            // The same goes for transitions of different images sharing memory.
+            mergeable = false;
+            break;
+        }
+    }
+
+    return mergeable;
+}
+
+// =====================================================================================================================
+// Adds the barriers of one vkCmdPipelineBarrier call to the pending barriers.  Nothing is added unless the result is
+// AddResult::Added.
+BarrierAccumulator::AddResult BarrierAccumulator::Add(
+    PipelineStageFlags           srcStageMask,
+    PipelineStageFlags           dstStageMask,
+    uint32_t                     memBarrierCount,
+    const VkMemoryBarrier*       pMemoryBarriers,
+    uint32_t                     bufferMemoryBarrierCount,
+    const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+    uint32_t                     imageMemoryBarrierCount,
+    const VkImageMemoryBarrier*  pImageMemoryBarriers)
+{
+    AddResult result = AddResult::Added;
+
+    // Barriers with extension structures (e.g. sample locations) reference memory of the caller, so they can't be
+    // deferred.  The same goes for barrier batches which wouldn't fit even when nothing else is pending.
+    if ((bufferMemoryBarrierCount + imageMemoryBarrierCount) > MaxPendingBarriers)
+    {
+        result = AddResult::NotDeferrable;
+    }
+
+    for (uint32_t i = 0; (result == AddResult::Added) && (i < memBarrierCount); ++i)
+    {
+        if (pMemoryBarriers[i].pNext != nullptr)
+        {
+            result = AddResult::NotDeferrable;
+        }
+    }
+
+    for (uint32_t i = 0; (result == AddResult::Added) && (i < bufferMemoryBarrierCount); ++i)
+    {
+        if (pBufferMemoryBarriers[i].pNext != nullptr)
+        {
+            result = AddResult::NotDeferrable;
+        }
+    }
+
+    for (uint32_t i = 0; (result == AddResult::Added) && (i < imageMemoryBarrierCount); ++i)
+    {
+        VkImageMemoryBarrier* pMergeTarget = nullptr;
+
+        if (pImageMemoryBarriers[i].pNext != nullptr)
+        {
+            result = AddResult::NotDeferrable;
+        }
+        else if (FindImageBarrier(pImageMemoryBarriers[i], &pMergeTarget) == false)
+        {
+            result = AddResult::FlushRequired;
+        }
+    }
+
+    if ((result == AddResult::Added) &&
+        ((m_bufferBarriers.NumElements() + m_imageBarriers.NumElements() +
+          bufferMemoryBarrierCount + imageMemoryBarrierCount) > MaxPendingBarriers))
+    {
+        result = AddResult::FlushRequired;
+    }
+
+    // Make sure the barriers can't fail to be added half way through.
+    if (result == AddResult::Added)
+    {
+        const uint32_t bufferCapacity = m_bufferBarriers.NumElements() + bufferMemoryBarrierCount;
+        const uint32_t imageCapacity  = m_imageBarriers.NumElements() + imageMemoryBarrierCount;
+
+        if ((m_bufferBarriers.Reserve(bufferCapacity) != Pal::Result::Success) ||
+            (m_imageBarriers.Reserve(imageCapacity) != Pal::Result::Success))
+        {
+            result = AddResult::NotDeferrable;
+        }
+    }
+
+    if (result == AddResult::Added)
+    {
+        m_srcStageMask |= srcStageMask;
+        m_dstStageMask |= dstStageMask;
+
+        for (uint32_t i = 0; i < memBarrierCount; ++i)
+        {
+            m_memoryBarrier.srcAccessMask |= pMemoryBarriers[i].srcAccessMask;
+            m_memoryBarrier.dstAccessMask |= pMemoryBarriers[i].dstAccessMask;
+
+            m_hasMemoryBarrier = true;
+        }
+
+        for (uint32_t i = 0; i < bufferMemoryBarrierCount; ++i)
+        {
+            VkBufferMemoryBarrier* pMergeTarget = FindBufferBarrier(pBufferMemoryBarriers[i]);
+
+            if (pMergeTarget != nullptr)
+            {
+                pMergeTarget->srcAccessMask |= pBufferMemoryBarriers[i].srcAccessMask;
+                pMergeTarget->dstAccessMask |= pBufferMemoryBarriers[i].dstAccessMask;
+            }
+            else
+            {
+                m_bufferBarriers.PushBack(pBufferMemoryBarriers[i]);
+            }
+        }
+
+        for (uint32_t i = 0; i < imageMemoryBarrierCount; ++i)
+        {
+            VkImageMemoryBarrier* pMergeTarget = nullptr;
+
+            FindImageBarrier(pImageMemoryBarriers[i], &pMergeTarget);
+
+            if (pMergeTarget != nullptr)
+            {
+                pMergeTarget->srcAccessMask |= pImageMemoryBarriers[i].srcAccessMask;
+                pMergeTarget->dstAccessMask |= pImageMemoryBarriers[i].dstAccessMask;
+                pMergeTarget->newLayout      = pImageMemoryBarriers[i].newLayout;
+            }
+            else
+            {
+                m_imageBarriers.PushBack(pImageMemoryBarriers[i]);
+            }
+        }
+
+        m_pendingBarrierCount++;
+    }
+
+    return result;
+}
+
+} // namespace vk
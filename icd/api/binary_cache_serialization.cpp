@@ -120,18 +120,35 @@ Util::Result CalculatePipelineBinaryCacheHashId(
     size_t                    dataSize,
     uint8_t*                  pHashId)
 {
-    Util::Result        result       = Util::Result::Success;
-    Util::IHashContext* pContext     = nullptr;
-    size_t              contextSize  = pPlatformKey->GetKeyContext()->GetDuplicateObjectSize();
-    void*               pContextMem  = pAllocationCallbacks->pfnAllocation(pAllocationCallbacks->pUserData,
-                                                                           contextSize,
-                                                                           16,
-                                                                           VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+    Util::Result result      = Util::Result::ErrorOutOfMemory;
+    void*        pContextMem = pAllocationCallbacks->pfnAllocation(pAllocationCallbacks->pUserData,
+                                                                   GetBinaryCacheHashContextSize(pPlatformKey),
+                                                                   16,
+                                                                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
 
     if (pContextMem != nullptr)
     {
-        result = pPlatformKey->GetKeyContext()->Duplicate(pContextMem, &pContext);
+        result = CalculatePipelineBinaryCacheHashId(pContextMem, pPlatformKey, pCacheData, dataSize, pHashId);
+
+        pAllocationCallbacks->pfnFree(pAllocationCallbacks->pUserData, pContextMem);
     }
+
+    return result;
+}
+
+// =====================================================================================================================
+Util::Result CalculatePipelineBinaryCacheHashId(
+    void*                     pContextMem,
+    const Util::IPlatformKey* pPlatformKey,
+    const void*               pCacheData,
+    size_t                    dataSize,
+    uint8_t*                  pHashId)
+{
+    PAL_ASSERT(pContextMem != nullptr);
+
+    Util::IHashContext* pContext = nullptr;
+    Util::Result        result   = pPlatformKey->GetKeyContext()->Duplicate(pContextMem, &pContext);
+
     if (result == Util::Result::Success)
     {
         result = pContext->AddData(pCacheData, dataSize);
@@ -144,26 +161,113 @@ Util::Result CalculatePipelineBinaryCacheHashId(
     {
         pContext->Destroy();
     }
-    if (pContextMem != nullptr)
+
+    return result;
+}
+
+// =====================================================================================================================
+size_t GetBinaryCacheHashContextSize(
+    const Util::IPlatformKey* pPlatformKey)
+{
+    return pPlatformKey->GetKeyContext()->GetDuplicateObjectSize();
+}
+
+// =====================================================================================================================
+// Returns true if the given entry is the digest entry of a pipeline binary cache blob. It must not be treated as a
+// pipeline binary.
+bool IsBinaryCacheDigestEntry(
+    const BinaryCacheEntry& entry)
+{
+    return (entry.hashId.qwords[0] == UINT64_MAX) && (entry.hashId.qwords[1] == UINT64_MAX);
+}
+
+// =====================================================================================================================
+// Looks for a digest entry at the end of the cache data, which follows the private header. Returns false if there is
+// none, in which case the private header hash covers all of the cache data.
+bool ReadBinaryCacheDigestInfo(
+    const void*            pCacheData,
+    size_t                 dataSize,
+    BinaryCacheDigestInfo* pDigestInfo)
+{
+    PAL_ASSERT(pCacheData != nullptr);
+    PAL_ASSERT(pDigestInfo != nullptr);
+
+    bool isValid = false;
+
+    constexpr size_t EntrySize  = sizeof(BinaryCacheEntry);
+    constexpr size_t FooterSize = sizeof(BinaryCacheDigestFooter);
+
+    if (dataSize >= (EntrySize + FooterSize))
     {
-        pAllocationCallbacks->pfnFree(pAllocationCallbacks->pUserData, pContextMem);
+        // Neither the footer nor the entry header are guaranteed to be 8 byte aligned.
+        BinaryCacheDigestFooter footer;
+        memcpy(&footer, Util::VoidPtrInc(pCacheData, dataSize - FooterSize), FooterSize);
+
+        const size_t maxChunkCount = (dataSize - EntrySize - FooterSize) / SHA_DIGEST_LENGTH;
+
+        if ((footer.magic == BinaryCacheDigestMagic) &&
+            (footer.chunkSize > 0) &&
+            (footer.chunkCount <= maxChunkCount))
+        {
+            const size_t digestDataSize = (static_cast<size_t>(footer.chunkCount) * SHA_DIGEST_LENGTH) + FooterSize;
+            const size_t coveredSize    = dataSize - digestDataSize - EntrySize;
+
+            BinaryCacheEntry entry;
+            memcpy(&entry, Util::VoidPtrInc(pCacheData, coveredSize), EntrySize);
+
+            if (IsBinaryCacheDigestEntry(entry) &&
+                (entry.dataSize == digestDataSize) &&
+                (footer.chunkCount == Util::RoundUpQuotient<uint64_t>(coveredSize, footer.chunkSize)))
+            {
+                pDigestInfo->chunkSize   = static_cast<size_t>(footer.chunkSize);
+                pDigestInfo->chunkCount  = static_cast<size_t>(footer.chunkCount);
+                pDigestInfo->coveredSize = coveredSize;
+                pDigestInfo->pDigests    = static_cast<const uint8_t*>(
+                    Util::VoidPtrInc(pCacheData, coveredSize + EntrySize));
+
+                isValid = true;
+            }
+        }
     }
 
-    return result;
+    return isValid;
+}
+
+// =====================================================================================================================
+// Returns the size of the digest entry for the given amount of cache data, or zero if chunk digests are disabled.
+size_t PipelineBinaryCacheSerializer::CalculateDigestEntrySize(
+    size_t cacheDataSize,
+    size_t digestChunkSize)
+{
+    size_t digestEntrySize = 0;
+
+    if ((digestChunkSize > 0) && (cacheDataSize > 0))
+    {
+        digestEntrySize = EntryHeaderSize +
+                          (Util::RoundUpQuotient(cacheDataSize, digestChunkSize) * SHA_DIGEST_LENGTH) +
+                          sizeof(BinaryCacheDigestFooter);
+    }
+
+    return digestEntrySize;
 }
 
 // =====================================================================================================================
 // Returns Util::Result::Success on success or Util::Result::ErrorInvalidMemorySize if the provided buffer is too small
 // to create a valid pipeline binary cache blob.
+//
+// If digestChunkSize is non-zero, Finalize appends a digest entry with a digest for each digestChunkSize bytes of cache
+// data (see BinaryCacheDigestFooter), provided it fits into the buffer.
 Util::Result PipelineBinaryCacheSerializer::Initialize(
     size_t bufferCapacity,
-    void*  pOutputBuffer)
+    void*  pOutputBuffer,
+    size_t digestChunkSize)
 {
     PAL_ASSERT(pOutputBuffer != nullptr);
 
     Util::Result result = Util::Result::ErrorInvalidMemorySize;
 
-    m_pOutputBuffer = pOutputBuffer;
+    m_pOutputBuffer   = pOutputBuffer;
+    m_digestChunkSize = digestChunkSize;
     if (bufferCapacity >= HeaderSize)
     {
         m_bufferCapacity = bufferCapacity;
@@ -213,6 +317,23 @@ Util::Result PipelineBinaryCacheSerializer::Finalize(
     auto pPrivateHeader         = static_cast<PipelineBinaryCachePrivateHeader*>(m_pOutputBuffer);
     void *pCacheDataBegin       = Util::VoidPtrInc(m_pOutputBuffer, HeaderSize);
     const size_t cacheDataBytes = m_bytesUsed - HeaderSize;
+    const size_t digestBytes    = CalculateDigestEntrySize(cacheDataBytes, m_digestChunkSize);
+
+    Util::Result result = Util::Result::Success;
+
+    // Fall back to a single hash over all cache data if there is no room left for the digest entry.
+    if ((digestBytes > 0) && (digestBytes <= (m_bufferCapacity - m_bytesUsed)))
+    {
+        result = WriteDigestEntry(pAllocationCallbacks, pKey);
+    }
+    else
+    {
+        result = CalculatePipelineBinaryCacheHashId(pAllocationCallbacks,
+                                                    pKey,
+                                                    pCacheDataBegin,
+                                                    cacheDataBytes,
+                                                    pPrivateHeader->hashId);
+    }
 
     if (pCacheEntriesWritten != nullptr)
     {
@@ -223,11 +344,74 @@ Util::Result PipelineBinaryCacheSerializer::Finalize(
         *pBytesWritten = m_bytesUsed;
     }
 
-    return CalculatePipelineBinaryCacheHashId(pAllocationCallbacks,
-                                              pKey,
-                                              pCacheDataBegin,
-                                              cacheDataBytes,
-                                              pPrivateHeader->hashId);
+    return result;
+}
+
+// =====================================================================================================================
+// Appends the digest entry for all cache data written so far and stores the hash of the digest entry in the private
+// header.
+Util::Result PipelineBinaryCacheSerializer::WriteDigestEntry(
+    VkAllocationCallbacks*    pAllocationCallbacks,
+    const Util::IPlatformKey* pKey)
+{
+    auto pPrivateHeader          = static_cast<PipelineBinaryCachePrivateHeader*>(m_pOutputBuffer);
+    const void* pCacheDataBegin  = Util::VoidPtrInc(m_pOutputBuffer, HeaderSize);
+    const size_t cacheDataBytes  = m_bytesUsed - HeaderSize;
+    const size_t digestBytes     = CalculateDigestEntrySize(cacheDataBytes, m_digestChunkSize);
+    const size_t chunkCount      = Util::RoundUpQuotient(cacheDataBytes, m_digestChunkSize);
+    void* pDigestEntry           = Util::VoidPtrInc(m_pOutputBuffer, m_bytesUsed);
+    uint8_t* pDigests            = static_cast<uint8_t*>(Util::VoidPtrInc(pDigestEntry, EntryHeaderSize));
+
+    PAL_ASSERT((digestBytes > 0) && (digestBytes <= (m_bufferCapacity - m_bytesUsed)));
+
+    Util::Result result      = Util::Result::ErrorOutOfMemory;
+    void*        pContextMem = pAllocationCallbacks->pfnAllocation(pAllocationCallbacks->pUserData,
+                                                                   GetBinaryCacheHashContextSize(pKey),
+                                                                   16,
+                                                                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+    if (pContextMem != nullptr)
+    {
+        result = Util::Result::Success;
+
+        for (size_t i = 0; (result == Util::Result::Success) && (i < chunkCount); i++)
+        {
+            const size_t offset = i * m_digestChunkSize;
+
+            result = CalculatePipelineBinaryCacheHashId(pContextMem,
+                                                        pKey,
+                                                        Util::VoidPtrInc(pCacheDataBegin, offset),
+                                                        Util::Min(m_digestChunkSize, cacheDataBytes - offset),
+                                                        &pDigests[i * SHA_DIGEST_LENGTH]);
+        }
+
+        if (result == Util::Result::Success)
+        {
+            BinaryCacheEntry entry = {};
+            entry.hashId.qwords[0] = UINT64_MAX;
+            entry.hashId.qwords[1] = UINT64_MAX;
+            entry.dataSize         = digestBytes - EntryHeaderSize;
+
+            BinaryCacheDigestFooter footer = {};
+            footer.chunkSize  = m_digestChunkSize;
+            footer.chunkCount = chunkCount;
+            footer.magic      = BinaryCacheDigestMagic;
+
+            memcpy(pDigestEntry, &entry, EntryHeaderSize);
+            memcpy(&pDigests[chunkCount * SHA_DIGEST_LENGTH], &footer, sizeof(footer));
+            m_bytesUsed += digestBytes;
+
+            result = CalculatePipelineBinaryCacheHashId(pContextMem,
+                                                        pKey,
+                                                        pDigestEntry,
+                                                        digestBytes,
+                                                        pPrivateHeader->hashId);
+        }
+
+        pAllocationCallbacks->pfnFree(pAllocationCallbacks->pUserData, pContextMem);
+    }
+
+    return result;
 }
 
 }
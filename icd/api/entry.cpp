@@ -113,13 +113,12 @@ VKAPI_ATTR void VKAPI_CALL vkCmdBindVertexBuffers(
     const VkBuffer*                             pBuffers,
     const VkDeviceSize*                         pOffsets)
 {
-    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->BindVertexBuffers(
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->VkDevice()->GetEntryPoints().vkCmdBindVertexBuffers(
+        cmdBuffer,
         firstBinding,
         bindingCount,
         pBuffers,
-        pOffsets,
-        nullptr,
-        nullptr);
+        pOffsets);
 }
 
 // =====================================================================================================================
@@ -154,6 +153,42 @@ VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(
         instanceCount);
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawInfoEXT*                   pVertexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->DrawMulti(
+        drawCount,
+        pVertexInfo,
+        instanceCount,
+        firstInstance,
+        stride);
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiIndexedEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawIndexedInfoEXT*            pIndexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride,
+    const int32_t*                              pVertexOffset)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->DrawMultiIndexed(
+        drawCount,
+        pIndexInfo,
+        instanceCount,
+        firstInstance,
+        stride,
+        pVertexOffset);
+}
+
 // =====================================================================================================================
 VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndirect(
     VkCommandBuffer                             cmdBuffer,
@@ -697,7 +732,11 @@ VKAPI_ATTR void VKAPI_CALL vkCmdSetViewport(
     uint32_t                                    viewportCount,
     const VkViewport*                           pViewports)
 {
-    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->SetViewport(firstViewport, viewportCount, pViewports);
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->VkDevice()->GetEntryPoints().vkCmdSetViewport(
+        cmdBuffer,
+        firstViewport,
+        viewportCount,
+        pViewports);
 }
 
 // =====================================================================================================================
@@ -707,7 +746,11 @@ VKAPI_ATTR void VKAPI_CALL vkCmdSetScissor(
     uint32_t                                    scissorCount,
     const VkRect2D*                             pScissors)
 {
-    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->SetScissor(firstScissor, scissorCount, pScissors);
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->VkDevice()->GetEntryPoints().vkCmdSetScissor(
+        cmdBuffer,
+        firstScissor,
+        scissorCount,
+        pScissors);
 }
 
 // =====================================================================================================================
@@ -1064,7 +1107,10 @@ VKAPI_ATTR void VKAPI_CALL vkCmdSetViewportWithCount(
     uint32_t                                    viewportCount,
     const VkViewport*                           pViewports)
 {
-    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->SetViewportWithCount(viewportCount, pViewports);
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->VkDevice()->GetEntryPoints().vkCmdSetViewportWithCount(
+        commandBuffer,
+        viewportCount,
+        pViewports);
 }
 
 // =====================================================================================================================
@@ -1073,7 +1119,10 @@ VKAPI_ATTR void VKAPI_CALL vkCmdSetScissorWithCount(
     uint32_t                                    scissorCount,
     const VkRect2D*                             pScissors)
 {
-    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->SetScissorWithCount(scissorCount, pScissors);
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->VkDevice()->GetEntryPoints().vkCmdSetScissorWithCount(
+        commandBuffer,
+        scissorCount,
+        pScissors);
 }
 
 // =====================================================================================================================
@@ -1086,12 +1135,14 @@ VKAPI_ATTR void VKAPI_CALL vkCmdBindVertexBuffers2(
     const VkDeviceSize*                         pSizes,
     const VkDeviceSize*                         pStrides)
 {
-    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->BindVertexBuffers(firstBinding,
-                                                                     bindingCount,
-                                                                     pBuffers,
-                                                                     pOffsets,
-                                                                     pSizes,
-                                                                     pStrides);
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->VkDevice()->GetEntryPoints().vkCmdBindVertexBuffers2(
+        commandBuffer,
+        firstBinding,
+        bindingCount,
+        pBuffers,
+        pOffsets,
+        pSizes,
+        pStrides);
 }
 
 // =====================================================================================================================
@@ -0,0 +1,115 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2022 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+***********************************************************************************************************************
+* @file  barrier_accumulator.h
+* @brief Declaration of the per command buffer accumulator that coalesces consecutive pipeline barriers.
+***********************************************************************************************************************
+*/
+#pragma once
+
+#include "include/khronos/vulkan.h"
+#include "include/vk_alloccb.h"
+#include "include/vk_utils.h"
+
+#include "palVector.h"
+
+namespace vk
+{
+
+// =====================================================================================================================
+// Collects the memory, buffer and image barriers of consecutive vkCmdPipelineBarrier calls so that they can be issued
+// as one PAL barrier before the next command that does work. Barriers on the same buffer range are merged into one, as
+// are back to back layout transitions of the same image subresource range. A barrier that can't be combined with the
+// pending ones (e.g. a second transition of an image range pending with a different layout, or a transition of an image
+// which may alias the memory of an image pending a transition) requires a flush first.
+class BarrierAccumulator
+{
+public:
+    // Outcome of Add()
+    enum class AddResult : uint32_t
+    {
+        Added,          // The barrier is pending now
+        FlushRequired,  // The pending barriers must be flushed before the barrier can be added
+        NotDeferrable   // The barrier must be executed right away
+    };
+
+    BarrierAccumulator(PalAllocator* pAllocator);
+
+    AddResult Add(
+        PipelineStageFlags           srcStageMask,
+        PipelineStageFlags           dstStageMask,
+        uint32_t                     memBarrierCount,
+        const VkMemoryBarrier*       pMemoryBarriers,
+        uint32_t                     bufferMemoryBarrierCount,
+        const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+        uint32_t                     imageMemoryBarrierCount,
+        const VkImageMemoryBarrier*  pImageMemoryBarriers);
+
+    bool IsEmpty() const
+        { return (m_pendingBarrierCount == 0); }
+
+    void Clear();
+
+    PipelineStageFlags GetSrcStageMask() const { return m_srcStageMask; }
+    PipelineStageFlags GetDstStageMask() const { return m_dstStageMask; }
+
+    uint32_t GetMemoryBarrierCount() const { return m_hasMemoryBarrier ? 1 : 0; }
+    const VkMemoryBarrier* GetMemoryBarriers() const { return &m_memoryBarrier; }
+
+    uint32_t GetBufferMemoryBarrierCount() const { return m_bufferBarriers.NumElements(); }
+    const VkBufferMemoryBarrier* GetBufferMemoryBarriers() const { return m_bufferBarriers.Data(); }
+
+    uint32_t GetImageMemoryBarrierCount() const { return m_imageBarriers.NumElements(); }
+    const VkImageMemoryBarrier* GetImageMemoryBarriers() const { return m_imageBarriers.Data(); }
+
+    // Called by the command buffer after it has issued the pending barriers
+    void OnFlush()
+        { Clear(); }
+
+private:
+    PAL_DISALLOW_DEFAULT_CTOR(BarrierAccumulator);
+    PAL_DISALLOW_COPY_AND_ASSIGN(BarrierAccumulator);
+
+    // Upper bound of pending buffer and image barriers, which keeps the lookups for merge candidates cheap
+    static constexpr uint32_t MaxPendingBarriers = 64;
+
+    VkBufferMemoryBarrier* FindBufferBarrier(const VkBufferMemoryBarrier& barrier);
+
+    bool FindImageBarrier(
+        const VkImageMemoryBarrier& barrier,
+        VkImageMemoryBarrier**      ppMergeTarget);
+
+    PipelineStageFlags m_srcStageMask;        // Union of the source stages of the pending barriers
+    PipelineStageFlags m_dstStageMask;        // Union of the destination stages of the pending barriers
+    uint32_t           m_pendingBarrierCount; // Number of pipeline barriers pending
+    bool               m_hasMemoryBarrier;    // m_memoryBarrier holds the union of all pending memory barriers
+    VkMemoryBarrier    m_memoryBarrier;
+
+    Util::Vector<VkBufferMemoryBarrier, 16, PalAllocator> m_bufferBarriers;
+    Util::Vector<VkImageMemoryBarrier, 16, PalAllocator>  m_imageBarriers;
+};
+
+} // namespace vk
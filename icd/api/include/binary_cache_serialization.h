@@ -117,6 +117,52 @@ Util::Result CalculatePipelineBinaryCacheHashId(
     size_t                    dataSize,
     uint8_t*                  pHashId);
 
+// Same as above, but uses caller provided memory of GetBinaryCacheHashContextSize() bytes for the hash context so that
+// it can be called from threads which must not use the allocation callbacks.
+Util::Result CalculatePipelineBinaryCacheHashId(
+    void*                     pContextMem,
+    const Util::IPlatformKey* pPlatformKey,
+    const void*               pCacheData,
+    size_t                    dataSize,
+    uint8_t*                  pHashId);
+
+size_t GetBinaryCacheHashContextSize(
+    const Util::IPlatformKey* pPlatformKey);
+
+// A pipeline binary cache blob may end with a digest entry, which holds a digest for each fixed size chunk of the cache
+// data in front of it. This allows the chunks to be validated independently. In that case the private header hash
+// only covers the digest entry. The digest entry is a regular entry with a reserved ID, but readers which don't know
+// about it hash the whole blob, fail to match the private header hash and discard the blob. Its data is laid out as
+// follows:
+// ```
+// | Chunk Digest (20B) | Chunk Digest (20B) | ... | BinaryCacheDigestFooter (24B) |
+// ```
+struct BinaryCacheDigestFooter
+{
+    uint64_t chunkSize;     // Size of each chunk, except for the last one which may be smaller
+    uint64_t chunkCount;    // Number of chunk digests in front of the footer
+    uint64_t magic;         // Must be BinaryCacheDigestMagic
+};
+
+constexpr uint64_t BinaryCacheDigestMagic = 0x5453474944434258ull; // "XBCDIGST"
+
+// Location of the chunk digests within a pipeline binary cache blob
+struct BinaryCacheDigestInfo
+{
+    size_t         chunkSize;       // Size of each chunk, except for the last one which may be smaller
+    size_t         chunkCount;      // Number of chunks
+    size_t         coveredSize;     // Size of the cache data covered by the chunks, which is the digest entry offset
+    const uint8_t* pDigests;        // Chunk digests, SHA_DIGEST_LENGTH bytes each
+};
+
+bool IsBinaryCacheDigestEntry(
+    const BinaryCacheEntry& entry);
+
+bool ReadBinaryCacheDigestInfo(
+    const void*            pCacheData,
+    size_t                 dataSize,
+    BinaryCacheDigestInfo* pDigestInfo);
+
 // =====================================================================================================================
 // Class for serializing in-memory cache data into valid pipeline binary cache blobs.
 class PipelineBinaryCacheSerializer
@@ -127,16 +173,20 @@ public:
     // Note that this doesn't take into account the Vulkan pipeline cache data.
     static size_t CalculateAnticipatedCacheBlobSize(
         size_t numEntries,
-        size_t totalPipelineBinariesSize)
+        size_t totalPipelineBinariesSize,
+        size_t digestChunkSize = 0)
     {
-        return HeaderSize + (numEntries * EntryHeaderSize) + totalPipelineBinariesSize;
+        const size_t cacheDataSize = (numEntries * EntryHeaderSize) + totalPipelineBinariesSize;
+
+        return HeaderSize + cacheDataSize + CalculateDigestEntrySize(cacheDataSize, digestChunkSize);
     }
 
     PipelineBinaryCacheSerializer() = default;
 
     Util::Result Initialize(
         size_t bufferCapacity,
-        void*  pOutputBuffer);
+        void*  pOutputBuffer,
+        size_t digestChunkSize = 0);
 
     Util::Result AddPipelineBinary(
         const BinaryCacheEntry* pEntry,
@@ -154,10 +204,19 @@ private:
     static constexpr size_t HeaderSize      = sizeof(PipelineBinaryCachePrivateHeader);
     static constexpr size_t EntryHeaderSize = sizeof(BinaryCacheEntry);
 
-    size_t m_numEntries     = 0;
-    void*  m_pOutputBuffer  = nullptr;
-    size_t m_bufferCapacity = 0;
-    size_t m_bytesUsed      = 0;
+    static size_t CalculateDigestEntrySize(
+        size_t cacheDataSize,
+        size_t digestChunkSize);
+
+    Util::Result WriteDigestEntry(
+        VkAllocationCallbacks*    pAllocationCallbacks,
+        const Util::IPlatformKey* pKey);
+
+    size_t m_numEntries      = 0;
+    void*  m_pOutputBuffer   = nullptr;
+    size_t m_bufferCapacity  = 0;
+    size_t m_bytesUsed       = 0;
+    size_t m_digestChunkSize = 0;   // Chunk size of the digest entry, or zero to hash all cache data at once
 };
 
 }
@@ -36,36 +36,48 @@
 #include "include/vk_alloccb.h"
 #include "palThread.h"
 #include "palMutex.h"
-#include "palList.h"
+#include "palConditionVariable.h"
 #include "palEvent.h"
+#include "palSysUtil.h"
 
 namespace vk
 {
 
 class DeferCompileManager;
-class PalAllocator;
 
+// =====================================================================================================================
+// A task executed by the DeferCompileManager.  Workloads are linked into the worker queues in place, so the memory of
+// a workload must stay valid until it has been executed or successfully revoked.
 struct DeferredCompileWorkload
 {
     void*       pPayloads;
     void        (*Execute)(void*); // Function pointer to the call used to execute the workload
     Util::Event* pEvent;
+
+    // Scheduler state, only valid while the workload is queued.
+    DeferredCompileWorkload* pPrev;
+    DeferredCompileWorkload* pNext;
+    volatile uint32_t        queueIdx;  // Index of the worker queue holding the workload, or InvalidQueueIdx
 };
 
 // =====================================================================================================================
-// Represents the general thread for async shader/pipeline compiler.
+// Represents one worker thread of the async shader/pipeline compile scheduler.  Each worker owns a deque of workloads:
+// the owner takes the newest workload from the back while idle workers steal the oldest workload from the front.
 class DeferCompileThread final : public Util::Thread
 {
 public:
-    DeferCompileThread(PalAllocator* pAllocator)
+    static constexpr uint32_t InvalidQueueIdx = UINT32_MAX;
+
+    DeferCompileThread(
+        DeferCompileManager* pManager,
+        uint32_t             queueIdx)
         :
-        m_taskList(pAllocator),
-        m_stop(false)
+        m_pManager(pManager),
+        m_queueIdx(queueIdx),
+        m_pHead(nullptr),
+        m_pTail(nullptr),
+        m_taskCount(0)
     {
-        Util::EventCreateFlags flags = {};
-        flags.manualReset = true;
-        flags.initiallySignaled = false;
-        m_event.Init(flags);
     }
 
     // Starts a new thread which starts by running function TaskThreadFunc.
@@ -74,31 +86,79 @@ public:
         Util::Thread::Begin(ThreadFunc, this);
     }
 
-    // Adds task to list.
-    void AddTask(DeferredCompileWorkload* pTask)
+    // Adds task to the back of the deque.
+    void PushTask(DeferredCompileWorkload* pTask)
     {
         Util::MutexAuto mutexAuto(&m_lock);
-        m_taskList.PushBack(*pTask);
-        m_event.Set();
+
+        pTask->pPrev    = m_pTail;
+        pTask->pNext    = nullptr;
+        pTask->queueIdx = m_queueIdx;
+
+        if (m_pTail != nullptr)
+        {
+            m_pTail->pNext = pTask;
+        }
+        else
+        {
+            m_pHead = pTask;
+        }
+
+        m_pTail = pTask;
+        m_taskCount++;
     }
 
-    // Set flag stop and trig event.
-    void SetStop()
+    // Takes the newest task from the back of the deque, returns nullptr if the deque is empty.
+    DeferredCompileWorkload* PopTask()
     {
-        m_event.Set();
-        m_stop = true;
+        Util::MutexAuto mutexAuto(&m_lock);
+
+        DeferredCompileWorkload* pTask = m_pTail;
+
+        if (pTask != nullptr)
+        {
+            Unlink(pTask);
+        }
+
+        return pTask;
     }
 
-    // Returns until all tasks are executed.
-    void SyncAll()
+    // Takes the oldest task from the front of the deque on behalf of another worker, returns nullptr if the deque is
+    // empty.
+    DeferredCompileWorkload* StealTask()
     {
-        m_event.Set();
-        while (m_taskList.Begin() != m_taskList.End())
+        Util::MutexAuto mutexAuto(&m_lock);
+
+        DeferredCompileWorkload* pTask = m_pHead;
+
+        if (pTask != nullptr)
         {
-            Util::YieldThread();
+            Unlink(pTask);
         }
+
+        return pTask;
     }
 
+    // Removes a task which has not been picked up by any worker yet.  Returns false if the task has already left the
+    // deque.
+    bool RemoveTask(DeferredCompileWorkload* pTask)
+    {
+        Util::MutexAuto mutexAuto(&m_lock);
+
+        bool removed = false;
+
+        if (pTask->queueIdx == m_queueIdx)
+        {
+            Unlink(pTask);
+            removed = true;
+        }
+
+        return removed;
+    }
+
+    uint32_t GetQueueDepth() const
+        { return m_taskCount; }
+
 protected:
     // Async thread function
     static void ThreadFunc(
@@ -108,90 +168,128 @@ protected:
         pThis->TaskThreadFunc();
     }
 
-    // The implementation of async thread function
-    void TaskThreadFunc()
+    inline void TaskThreadFunc();
+
+    // Unlinks a queued task, the caller must hold m_lock.
+    void Unlink(DeferredCompileWorkload* pTask)
     {
-        while (m_stop == false)
-        {
-            // Waits for new signal.
-            m_event.Wait(1.0f);
-            m_event.Reset();
+        VK_ASSERT(pTask->queueIdx == m_queueIdx);
 
-            DeferredCompileWorkload task;
-            while (FetchTask(&task))
-            {
-                task.Execute(task.pPayloads);
-                if (task.pEvent != nullptr)
-                {
-                    task.pEvent->Set();
-                }
-            }
+        if (pTask->pPrev != nullptr)
+        {
+            pTask->pPrev->pNext = pTask->pNext;
+        }
+        else
+        {
+            m_pHead = pTask->pNext;
         }
-    }
 
-    // Fetches task in list, return false if task list is empty.
-    bool FetchTask(DeferredCompileWorkload* pTask)
-    {
-        Util::MutexAuto mutexAuto(&m_lock);
-        auto beginIt = m_taskList.Begin();
-        if (beginIt != m_taskList.End())
+        if (pTask->pNext != nullptr)
+        {
+            pTask->pNext->pPrev = pTask->pPrev;
+        }
+        else
         {
-            *pTask = *(beginIt.Get());
-            m_taskList.Erase(&beginIt);
-            return true;
+            m_pTail = pTask->pPrev;
         }
-        return false;
+
+        pTask->pPrev    = nullptr;
+        pTask->pNext    = nullptr;
+        pTask->queueIdx = InvalidQueueIdx;
+        m_taskCount--;
     }
 
-    Util::List<DeferredCompileWorkload, vk::PalAllocator> m_taskList;      // Deferred compile task list
-    volatile bool                                         m_stop;          // Flag to stop the thread
-    Util::Mutex                                           m_lock;          // Lock for accessing task list
-    Util::Event                                           m_event;         // Event to notify async thread
+    DeferCompileManager* const m_pManager;   // Scheduler owning this worker
+    const uint32_t             m_queueIdx;   // Index of this worker in the scheduler
+    Util::Mutex                m_lock;       // Lock for accessing the deque
+    DeferredCompileWorkload*   m_pHead;      // Oldest queued task
+    DeferredCompileWorkload*   m_pTail;      // Newest queued task
+    volatile uint32_t          m_taskCount;  // Number of queued tasks
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(DeferCompileThread);
 };
 
 // =====================================================================================================================
-// Class that manage DeferCompileThread instance.
+// Work-stealing scheduler shared by the asynchronous compile work of a PipelineCompiler (deferred optimized pipeline
+// compiles and parallel pipeline batches).  Submitted workloads are spread over per-worker deques and idle workers
+// steal from busy ones, so a single slow compile only delays the tasks its own worker has not handed out yet.  Idle
+// workers and SyncAll() block on condition variables instead of spinning.
 class DeferCompileManager
 {
 public:
+    // Scheduler statistics, see GetStats().
+    struct Stats
+    {
+        uint32_t threadCount;     // Number of worker threads
+        uint32_t queueDepth;      // Number of currently queued tasks
+        uint32_t peakQueueDepth;  // Highest number of queued tasks observed
+        uint64_t executedTasks;   // Number of tasks executed by the workers
+        uint64_t stolenTasks;     // Number of executed tasks taken from another worker's deque
+        uint64_t revokedTasks;    // Number of tasks revoked before any worker picked them up
+    };
+
     DeferCompileManager()
         :
         m_pCompileThreads{},
         m_taskId(0),
-        m_activeThreadCount(0)
+        m_activeThreadCount(0),
+        m_pendingTasks(0),
+        m_outstandingTasks(0),
+        m_peakQueueDepth(0),
+        m_executedTasks(0),
+        m_stolenTasks(0),
+        m_revokedTasks(0),
+        m_stop(false)
     {
     }
 
-    void Init(uint32_t threadCount, PalAllocator* pAllocator)
+    // Returns the number of worker threads created for a requested thread count: 0 disables the workers, UINT32_MAX
+    // selects half the logical cores and any count is clamped to MaxThreads.
+    static uint32_t GetThreadCount(uint32_t requestedCount)
     {
-        if (threadCount == 0)
-        {
-            m_activeThreadCount = 0;
-        }
-        else if (threadCount == UINT32_MAX)
+        uint32_t threadCount = 0;
+
+        if (requestedCount == UINT32_MAX)
         {
             Util::SystemInfo sysInfo = {};
             Util::QuerySystemInfo(&sysInfo);
-            m_activeThreadCount = Util::Min(MaxThreads, sysInfo.cpuLogicalCoreCount / 2);
+            threadCount = Util::Min(MaxThreads, sysInfo.cpuLogicalCoreCount / 2);
         }
         else
         {
-            m_activeThreadCount = Util::Min(MaxThreads, threadCount);
+            threadCount = Util::Min(MaxThreads, requestedCount);
+        }
+
+        return threadCount;
+    }
+
+    void Init(uint32_t threadCount)
+    {
+        m_activeThreadCount = GetThreadCount(threadCount);
+
+        // All deques must exist before the first worker starts stealing.
+        for (uint32_t i = 0; i < m_activeThreadCount; ++i)
+        {
+            m_pCompileThreads[i] = VK_PLACEMENT_NEW(m_compileThreadBuffer[i]) DeferCompileThread(this, i);
         }
 
         for (uint32_t i = 0; i < m_activeThreadCount; ++i)
         {
-            m_pCompileThreads[i] = VK_PLACEMENT_NEW(m_compileThreadBuffer[i])
-                DeferCompileThread(pAllocator);
             m_pCompileThreads[i]->Begin();
         }
     }
 
     ~DeferCompileManager()
     {
+        {
+            Util::MutexAuto mutexAuto(&m_sleepLock);
+            m_stop = true;
+            m_workCondition.WakeAll();
+        }
+
         for (uint32_t i = 0; i < m_activeThreadCount; ++i)
         {
-            m_pCompileThreads[i]->SetStop();
             m_pCompileThreads[i]->Join();
             Util::Destructor(m_pCompileThreads[i]);
             m_pCompileThreads[i] = nullptr;
@@ -199,33 +297,179 @@ public:
         m_activeThreadCount = 0;
     }
 
+    // Queues a task on one of the worker deques.  Must only be called if GetActiveThreadCount() is non-zero.
+    void AddTask(DeferredCompileWorkload* pTask)
+    {
+        VK_ASSERT(m_activeThreadCount > 0);
+
+        Util::AtomicIncrement(&m_outstandingTasks);
+
+        const uint32_t queueDepth = Util::AtomicIncrement(&m_pendingTasks);
+        uint32_t       peakDepth  = m_peakQueueDepth;
+
+        while ((queueDepth > peakDepth) &&
+               (Util::AtomicCompareAndSwap(&m_peakQueueDepth, peakDepth, queueDepth) != peakDepth))
+        {
+            peakDepth = m_peakQueueDepth;
+        }
+
+        m_pCompileThreads[Util::AtomicIncrement(&m_taskId) % m_activeThreadCount]->PushTask(pTask);
+
+        Util::MutexAuto mutexAuto(&m_sleepLock);
+        m_workCondition.WakeOne();
+    }
+
+    // Removes a queued task before any worker has picked it up.  Returns false if the task is already running or has
+    // completed, in which case its event must be waited on as usual.
+    bool RevokeTask(DeferredCompileWorkload* pTask)
+    {
+        bool revoked = false;
+
+        const uint32_t queueIdx = pTask->queueIdx;
+
+        if ((queueIdx < m_activeThreadCount) && m_pCompileThreads[queueIdx]->RemoveTask(pTask))
+        {
+            Util::AtomicDecrement(&m_pendingTasks);
+            Util::AtomicIncrement64(&m_revokedTasks);
+            CompleteTask();
+
+            revoked = true;
+        }
+
+        return revoked;
+    }
+
+    // Returns once all queued tasks are executed.
     void SyncAll()
     {
-        for (uint32_t i = 0; i < m_activeThreadCount; ++i)
+        Util::MutexAuto mutexAuto(&m_sleepLock);
+
+        while (m_outstandingTasks != 0)
+        {
+            m_idleCondition.Wait(&m_sleepLock, WaitTimeoutMs);
+        }
+    }
+
+    uint32_t GetActiveThreadCount() const
+        { return m_activeThreadCount; }
+
+    void GetStats(Stats* pStats) const
+    {
+        pStats->threadCount    = m_activeThreadCount;
+        pStats->queueDepth     = m_pendingTasks;
+        pStats->peakQueueDepth = m_peakQueueDepth;
+        pStats->executedTasks  = m_executedTasks;
+        pStats->stolenTasks    = m_stolenTasks;
+        pStats->revokedTasks   = m_revokedTasks;
+    }
+
+    // Takes a task from the worker's own deque, or steals one from another worker if its own deque is empty.
+    DeferredCompileWorkload* FetchTask(uint32_t queueIdx)
+    {
+        DeferredCompileWorkload* pTask = m_pCompileThreads[queueIdx]->PopTask();
+
+        for (uint32_t i = 1; (pTask == nullptr) && (i < m_activeThreadCount); ++i)
+        {
+            pTask = m_pCompileThreads[(queueIdx + i) % m_activeThreadCount]->StealTask();
+
+            if (pTask != nullptr)
+            {
+                Util::AtomicIncrement64(&m_stolenTasks);
+            }
+        }
+
+        if (pTask != nullptr)
         {
-            m_pCompileThreads[i]->SyncAll();
+            Util::AtomicDecrement(&m_pendingTasks);
         }
+
+        return pTask;
     }
 
-    DeferCompileThread* GetCompileThread()
+    // Executes a fetched task and signals its event.
+    void RunTask(DeferredCompileWorkload* pTask)
     {
-        return (m_activeThreadCount > 0) ?
-            m_pCompileThreads[(m_taskId++) % m_activeThreadCount] :
-            nullptr;
+        // The owner may release the workload as soon as the event is set.
+        Util::Event* pEvent = pTask->pEvent;
+
+        pTask->Execute(pTask->pPayloads);
+
+        if (pEvent != nullptr)
+        {
+            pEvent->Set();
+        }
+
+        Util::AtomicIncrement64(&m_executedTasks);
+        CompleteTask();
+    }
+
+    // Blocks an idle worker until a task is queued.  Returns false once the scheduler is stopped and drained.
+    bool WaitForTask()
+    {
+        Util::MutexAuto mutexAuto(&m_sleepLock);
+
+        while ((m_pendingTasks == 0) && (m_stop == false))
+        {
+            m_workCondition.Wait(&m_sleepLock, WaitTimeoutMs);
+        }
+
+        return (m_pendingTasks != 0);
     }
 
 protected:
-    static constexpr uint32_t        MaxThreads = 8;  // Max thread count for shader module compile
+    void CompleteTask()
+    {
+        if (Util::AtomicDecrement(&m_outstandingTasks) == 0)
+        {
+            Util::MutexAuto mutexAuto(&m_sleepLock);
+            m_idleCondition.WakeAll();
+        }
+    }
+
+    static constexpr uint32_t        MaxThreads    = 8;    // Max thread count for shader module compile
+    static constexpr uint32_t        WaitTimeoutMs = 1000; // Upper bound of a single condition variable wait
+
     DeferCompileThread*              m_pCompileThreads[MaxThreads]; // Async compiler threads
-    uint32_t                         m_taskId;                      // Hint to select compile thread
+    volatile uint32_t                m_taskId;                      // Hint to select the deque of a new task
     uint32_t                         m_activeThreadCount;           // Active thread count
 
+    volatile uint32_t                m_pendingTasks;                // Tasks queued but not picked up yet
+    volatile uint32_t                m_outstandingTasks;            // Tasks queued or running
+    volatile uint32_t                m_peakQueueDepth;              // Highest observed m_pendingTasks
+    volatile uint64_t                m_executedTasks;               // Total executed tasks
+    volatile uint64_t                m_stolenTasks;                 // Total tasks stolen from another deque
+    volatile uint64_t                m_revokedTasks;                // Total tasks revoked before execution
+
+    Util::Mutex                      m_sleepLock;                   // Lock protecting the sleep/wake handshakes
+    Util::ConditionVariable          m_workCondition;               // Signaled when a task is queued
+    Util::ConditionVariable          m_idleCondition;               // Signaled when the last outstanding task ends
+    bool                             m_stop;                        // Flag to stop the workers
+
     // Internal buffer for m_pCompileThreads
-    uint8_t                          m_compileThreadBuffer[MaxThreads][sizeof(DeferCompileThread)];
+    alignas(DeferCompileThread) uint8_t m_compileThreadBuffer[MaxThreads][sizeof(DeferCompileThread)];
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(DeferCompileManager);
 };
 
+// =====================================================================================================================
+// The implementation of async thread function
+void DeferCompileThread::TaskThreadFunc()
+{
+    while (true)
+    {
+        DeferredCompileWorkload* pTask = m_pManager->FetchTask(m_queueIdx);
+
+        if (pTask != nullptr)
+        {
+            m_pManager->RunTask(pTask);
+        }
+        else if (m_pManager->WaitForTask() == false)
+        {
+            break;
+        }
+    }
+}
+
 } // namespace vk
 
 #endif
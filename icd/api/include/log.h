@@ -42,6 +42,11 @@ namespace vk
 enum LogTagId : uint32_t {
     GeneralPrint,
     PipelineCompileTime,
+    PipelineBatchTime,
+    PipelineCacheTime,
+    CmdBufferRecording,
+    PipelineCompilerStats,
+    DescriptorPoolStats,
     LogTagIdCount
 };
 
@@ -49,6 +54,11 @@ static const char* LogTag[LogTagIdCount] =
 {
     "GeneralPrint",
     "PipelineCompileTime",
+    "PipelineBatchTime",
+    "PipelineCacheTime",
+    "CmdBufferRecording",
+    "PipelineCompilerStats",
+    "DescriptorPoolStats",
 };
 
 static void AmdvlkLog(
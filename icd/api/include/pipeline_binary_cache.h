@@ -35,6 +35,9 @@
 #include "palMetroHash.h"
 #include "palVector.h"
 #include "palCacheLayer.h"
+#include "palConditionVariable.h"
+#include "palMutex.h"
+#include "palThread.h"
 #include "cache_adapter.h"
 
 namespace Util
@@ -50,6 +53,9 @@ namespace vk
 {
 
 class CacheAdapter;
+class PipelineBinaryCacheSerializer;
+struct BinaryCacheDigestInfo;
+struct PipelineBinaryCachePrivateHeader;
 
 // Unified pipeline cache interface
 class PipelineBinaryCache
@@ -72,10 +78,11 @@ public:
         bool                       createArchiveLayers);
 
     static bool IsValidBlob(
-        VkAllocationCallbacks* pAllocationCallbacks,
-        Util::IPlatformKey*    pKey,
-        size_t                 dataSize,
-        const void*            pData);
+        VkAllocationCallbacks*    pAllocationCallbacks,
+        const Util::IPlatformKey* pKey,
+        size_t                    dataSize,
+        const void*               pData,
+        PipelineCompiler*         pCompiler);
 
     ~PipelineBinaryCache();
 
@@ -96,7 +103,8 @@ public:
     Util::Result LoadPipelineBinary(
         const CacheId*  pCacheId,
         size_t*         pPipelineBinarySize,
-        const void**    ppPipelineBinary) const;
+        const void**    ppPipelineBinary,
+        bool*           pIsMapped = nullptr) const;
 
     Util::Result StorePipelineBinary(
         const CacheId*  pCacheId,
@@ -126,7 +134,8 @@ public:
 
     VkResult Merge(
         uint32_t                    srcCacheCount,
-        const PipelineBinaryCache** ppSrcCaches);
+        const PipelineBinaryCache** ppSrcCaches,
+        PipelineCompiler*           pCompiler);
 
 #if ICD_GPUOPEN_DEVMODE_BUILD
     Util::Result LoadReinjectionBinary(
@@ -155,6 +164,25 @@ public:
         { return &m_hashMappingLock; }
 #endif
 
+    // Statistics of the memory cache layer
+    struct MemoryLayerStats
+    {
+        uint64_t hits;          // Lookups served by the memory layer
+        uint64_t backingHits;   // Lookups of evicted or never loaded entries served by an archive layer
+        uint64_t misses;        // Lookups which no layer could serve
+        uint64_t evictions;     // Entries evicted from the memory layer to stay within its budget
+        size_t   curCount;      // Number of entries in the memory layer
+        size_t   curDataSize;   // Total size of the entries in the memory layer
+        size_t   budget;        // Byte budget of the memory layer, SIZE_MAX if unlimited
+        uint64_t pendingWrites; // Total size of the entries queued for the archive layers but not written yet
+        uint64_t archiveWrites; // Entries written to the archive layers by the write-behind thread
+    };
+
+    void GetMemoryLayerStats(
+        MemoryLayerStats* pStats) const;
+
+    void FlushArchiveWrites();
+
     void FreePipelineBinary(const void* pPipelineBinary);
 
     void* AllocMem(
@@ -171,11 +199,32 @@ private:
     PAL_DISALLOW_DEFAULT_CTOR(PipelineBinaryCache);
     PAL_DISALLOW_COPY_AND_ASSIGN(PipelineBinaryCache);
 
+    // Location of a pipeline binary within a serialized blob
+    struct BlobEntry
+    {
+        size_t offset;      // Offset of the pipeline binary
+        size_t dataSize;    // Size of the pipeline binary
+    };
+
+    using BlobIndex = Util::HashMap<CacheId, BlobEntry, PalAllocator, Util::JenkinsHashFunc>;
+
+    // Pinned memory layer entries waiting to be written to the archive layers
+    using WriteQueue = Util::Vector<Util::QueryResult, 32, PalAllocator>;
+
     explicit PipelineBinaryCache(
         VkAllocationCallbacks*    pAllocationCallbacks,
         const Vkgc::GfxIpVersion& gfxIp,
         uint32_t                  expectedEntries);
 
+    static bool IsValidChunkedBlob(
+        VkAllocationCallbacks*                  pAllocationCallbacks,
+        const Util::IPlatformKey*               pKey,
+        const PipelineBinaryCachePrivateHeader* pPrivateHeader,
+        size_t                                  dataSize,
+        const void*                             pData,
+        const BinaryCacheDigestInfo&            digestInfo,
+        PipelineCompiler*                       pCompiler);
+
     VkResult InitializePlatformKey(
         const PhysicalDevice*  pPhysicalDevice,
         const RuntimeSettings& settings);
@@ -201,12 +250,100 @@ private:
 #endif
 
     VkResult InitMemoryCacheLayer(
-        const RuntimeSettings& settings);
+        const RuntimeSettings& settings,
+        bool                   hasBackingLayers);
+
+    void TrackLookup(
+        Util::Result             result,
+        const Util::QueryResult* pQuery,
+        bool                     promoted) const;
 
     VkResult InitArchiveLayers(
         const char*            pDefaultCacheFilePath,
         const RuntimeSettings& settings);
 
+    Util::Result SerializeEntry(
+        PipelineBinaryCacheSerializer* pSerializer,
+        const CacheId*                 pCacheId);
+
+    VkResult InitLazyInitData(
+        size_t      initDataSize,
+        const void* pInitData);
+
+    Util::Result PromoteInitDataEntry(
+        const CacheId* pCacheId) const;
+
+    Util::Result PromoteAllInitData() const;
+
+    void DropInitDataEntry(
+        const CacheId* pCacheId);
+
+    void CompactInitData() const;
+
+    void ReleaseInitData() const;
+
+    static VkResult BuildBlobIndex(
+        const void* pBlob,
+        size_t      blobSize,
+        BlobIndex*  pIndex,
+        size_t*     pIndexedBytes);
+
+    bool OpenMappedArchive(
+        const char* pFilePath,
+        const char* pFileName);
+
+    Util::Result FindMappedArchiveEntry(
+        const CacheId* pCacheId,
+        size_t*        pPipelineBinarySize,
+        const void**   ppPipelineBinary) const;
+
+    bool IsMappedArchiveIntact() const;
+
+    bool ValidateMappedArchiveRange(
+        size_t offset,
+        size_t size) const;
+
+    Util::Result LoadMappedArchiveEntry(
+        const CacheId* pCacheId) const;
+
+    void ReleaseMappedArchive();
+
+    void StartArchiveWriter(
+        const RuntimeSettings& settings);
+
+    void StopArchiveWriter();
+
+    Util::Result QueueArchiveWrite(
+        const CacheId* pCacheId);
+
+    static void ArchiveWriterFunc(
+        void* pParam);
+
+    void RunArchiveWriter();
+
+    void WriteArchiveBatch(
+        const WriteQueue& batch);
+
+    // Statistics of a Merge call
+    struct MergeStats
+    {
+        uint64_t mergedEntries;     // Entries copied from a source cache
+        uint64_t skippedEntries;    // Entries which were already present
+        uint64_t mergedBytes;       // Total size of the copied entries
+    };
+
+    static void ExecuteMerge(
+        void* pPayload);
+
+    Util::Result MergeCache(
+        const PipelineBinaryCache* pSrcCache,
+        MergeStats*                pStats);
+
+    Util::Result MergeEntry(
+        Util::ICacheLayer* pSrcLayer,
+        const CacheId*     pCacheId,
+        MergeStats*        pStats);
+
     Util::ICacheLayer*  GetMemoryLayer() const { return m_pMemoryLayer; }
     Util::IArchiveFile* OpenReadOnlyArchive(const char* path, const char* fileName, size_t bufferSize);
     Util::IArchiveFile* OpenWritableArchive(const char* path, const char* fileName, size_t bufferSize);
@@ -234,6 +371,10 @@ private:
 
     Util::ICacheLayer*        m_pTopLayer;                // Top layer of the cache chain where queries are submitted
 
+    uint64_t                  m_logTagIdMask;             // Mask of enabled LogTagIds (see log.h)
+
+    size_t                    m_digestChunkSize;          // Chunk size of the digests written by Serialize
+
 #if ICD_GPUOPEN_DEVMODE_BUILD
     vk::DevModeMgr*           m_pDevModeMgr;
     Util::ICacheLayer*        m_pReinjectionLayer;        // Reinjection interface layer
@@ -246,6 +387,15 @@ private:
 
     uint32_t                  m_expectedEntries;
 
+    size_t                    m_memoryBudget;             // Byte budget of the memory layer, SIZE_MAX if unlimited
+
+    // Memory layer statistics, see MemoryLayerStats
+    mutable volatile uint64_t m_memoryHits;
+    mutable volatile uint64_t m_backingHits;
+    mutable volatile uint64_t m_misses;
+    mutable volatile uint64_t m_memoryInserts;            // Entries added to the memory layer
+    mutable volatile uint64_t m_explicitEvictions;        // Entries removed by EvictEntry or MarkEntryBad
+
     // Archive based cache layers
     using FileVector  = Util::Vector<Util::IArchiveFile*, 8, PalAllocator>;
     using LayerVector = Util::Vector<Util::ICacheLayer*, 8, PalAllocator>;
@@ -255,6 +405,52 @@ private:
 
     CacheAdapter*       m_pCacheAdapter;
 
+    // Lazily loaded pipeline cache initial data. Entries are moved into the cache chain on their first lookup.
+    mutable void*          m_pInitData;            // Private copy of the initial data
+    mutable size_t         m_initDataSize;         // Size of m_pInitData in bytes
+    mutable BlobIndex      m_initDataIndex;        // Maps a cache ID to its entry in m_pInitData
+    mutable size_t         m_initDataPendingBytes; // Total size of the entries which are still in m_initDataIndex
+    mutable volatile bool  m_initDataPending;      // Hint that m_initDataIndex is non-empty, checked without the lock
+    mutable Util::Mutex    m_initDataMutex;        // Protects the lazily loaded initial data
+
+    // Memory-mapped read-only pipeline cache file. LoadPipelineBinary returns its entries in place. If the file has
+    // chunk digests, each chunk is validated on the first lookup of an entry within it rather than when it is opened.
+    void*                      m_pMappedArchive;       // Read-only mapping of the whole file
+    size_t                     m_mappedArchiveSize;    // Size of the mapping in bytes
+    const void*                m_pMappedEntries;       // First entry of the blob within m_pMappedArchive
+    BlobIndex                  m_mappedArchiveIndex;   // Maps a cache ID to its entry relative to m_pMappedEntries,
+                                                       // never modified after InitArchiveLayers
+    const uint8_t*             m_pMappedDigests;       // Chunk digests of the blob, nullptr if it was validated as a
+                                                       // whole when it was opened
+    size_t                     m_mappedChunkSize;      // Size of each digest chunk
+    size_t                     m_mappedChunkCount;     // Number of digest chunks
+    size_t                     m_mappedCoveredSize;    // Size of the blob data covered by the digest chunks
+    mutable volatile uint32_t* m_pMappedChunkState;    // Validation state of each digest chunk, see MappedChunkState
+#if defined(__unix__)
+    int                        m_mappedArchiveFd;      // Descriptor of the mapped file, kept to check it for changes
+    int64_t                    m_mappedArchiveMtime;   // Modification time of the mapped file in ns when it was mapped
+#endif
+    mutable volatile bool      m_mappedArchiveChanged; // Set once the mapped file has been found to have changed
+
+    // Write-behind queue of the archive layers. Stored binaries go to the memory layer right away and stay pinned there
+    // until the writer thread has passed them on to m_pArchiveLayer.
+    Util::Thread            m_archiveWriter;        // Writes queued entries to the archive layers
+    bool                    m_writeBehind;          // Set while m_archiveWriter is running
+    uint32_t                m_writeBehindDelayMs;   // Time the writer waits for further entries before writing a batch
+    uint32_t                m_memoryStorePolicy;    // Store policy of the memory layer before the writer was started
+    WriteQueue              m_writeQueueStorage;    // Storage of the two queues below, which swap after every batch
+    WriteQueue              m_writeBatchStorage;
+    WriteQueue*             m_pWriteQueue;          // Queue new entries are added to
+    WriteQueue*             m_pWriteBatch;          // Batch owned by the writer thread
+    uint32_t                m_pendingWriteCount;    // Entries queued or being written
+    volatile uint64_t       m_pendingWriteBytes;    // Total size of the entries queued or being written
+    volatile uint64_t       m_archiveWrites;        // Entries written by the writer thread
+    uint32_t                m_flushRequests;        // Number of threads waiting in FlushArchiveWrites
+    bool                    m_writerStop;           // Tells the writer thread to write all queued entries and exit
+    Util::Mutex             m_writeQueueLock;       // Protects the write-behind state
+    Util::ConditionVariable m_writeCondition;       // Signaled when an entry is queued or the writer is stopped
+    Util::ConditionVariable m_flushCondition;       // Signaled when the writer has written all queued entries
+
     Util::Mutex         m_entriesMutex;      // Mutex that will be used to get cache state by Query
 };
 
@@ -34,6 +34,7 @@
 #include "include/khronos/vulkan.h"
 #include "include/compiler_solution.h"
 #include "include/shader_cache.h"
+#include "include/shader_module_cache.h"
 
 #include "include/compiler_solution_llpc.h"
 
@@ -242,6 +243,8 @@ public:
 
     void DestroyPipelineBinaryCache();
 
+    void FlushPipelineBinaryCache();
+
     void BuildPipelineInternalBufferData(
         const PipelineLayout*             pPipelineLayout,
         GraphicsPipelineBinaryCreateInfo* pCreateInfo,
@@ -279,6 +282,23 @@ public:
     void ExecuteDeferCompile(
         DeferredCompileWorkload* pWorkload);
 
+    void ExecutePipelineBatchWorkload(
+        DeferredCompileWorkload* pWorkload);
+
+    bool RevokeDeferredWorkload(
+        DeferredCompileWorkload* pWorkload)
+        { return m_deferCompileMgr.RevokeTask(pWorkload); }
+
+    Util::Result FinishPipelineBatchWorkload(
+        DeferredCompileWorkload* pWorkload);
+
+    uint32_t GetPipelineBatchThreadCount() const
+        { return m_pipelineBatchThreadCount; }
+
+    void GetDeferCompileMetricString(char* pOutStr, size_t outStrSize);
+
+    void GetShaderModuleCacheMetricString(char* pOutStr, size_t outStrSize);
+
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(PipelineCompiler);
 
@@ -357,7 +377,8 @@ private:
 
     PhysicalDevice*    m_pPhysicalDevice;      // Vulkan physical device object
     Vkgc::GfxIpVersion m_gfxIp;                // Graphics IP version info, used by Vkgcf
-    DeferCompileManager m_deferCompileMgr;     // Defer compile thread manager
+    DeferCompileManager m_deferCompileMgr;     // Work-stealing scheduler for deferred compiles and pipeline batches
+    uint32_t           m_pipelineBatchThreadCount; // Scheduler threads a parallel vkCreate*Pipelines batch may use
     CompilerSolutionLlpc m_compilerSolutionLlpc;
 
     PipelineBinaryCache* m_pBinaryCache;       // Pipeline binary cache object
@@ -371,10 +392,7 @@ private:
 
     UberFetchShaderFormatInfoMap m_uberFetchShaderInfoFormatMap;  // Uber fetch shader format info map
 
-    typedef Util::HashMap<Util::MetroHash::Hash, ShaderModuleHandle, PalAllocator, Util::JenkinsHashFunc> ShaderModuleHandleMap;
-
-    Util::Mutex           m_shaderModuleCacheLock;
-    ShaderModuleHandleMap m_shaderModuleHandleMap;
+    ShaderModuleCache     m_shaderModuleCache;  // Runtime cache of built shader modules
 
 }; // class PipelineCompiler
 
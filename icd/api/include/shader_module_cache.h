@@ -0,0 +1,136 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2022 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+***********************************************************************************************************************
+* @file  shader_module_cache.h
+* @brief Declaration of the runtime shader module cache of PipelineCompiler.
+***********************************************************************************************************************
+*/
+#pragma once
+
+#include "include/compiler_solution.h"
+#include "include/vk_alloccb.h"
+
+#include "palHashMap.h"
+#include "palMetroHash.h"
+#include "palMutex.h"
+
+namespace vk
+{
+
+class PipelineCompiler;
+
+// =====================================================================================================================
+// Maps shader module cache hashes to built shader modules. The map is split into shards, each guarded by its own
+// reader/writer lock, so concurrent lookups of different modules don't serialize on one mutex and lookups of the same
+// module only take a shared lock. The shader module reference count is updated atomically and a cached module holds
+// one reference of its own. Optionally the number of cached modules is limited, in which case the least recently used
+// module of a full shard is evicted.
+class ShaderModuleCache
+{
+public:
+    // Cache statistics, see GetStats().
+    struct Stats
+    {
+        uint32_t shardCount;     // Number of shards
+        uint32_t entryCount;     // Number of cached shader modules
+        uint64_t lookups;        // Number of Find calls
+        uint64_t hits;           // Number of Find calls which returned a module
+        uint64_t evictions;      // Number of modules evicted to stay within the entry limit
+        uint64_t contendedLocks; // Number of shard lock acquisitions which had to wait for another thread
+    };
+
+    ShaderModuleCache(
+        PipelineCompiler* pCompiler,
+        PalAllocator*     pAllocator);
+
+    ~ShaderModuleCache();
+
+    VkResult Init(
+        uint32_t maxEntries);
+
+    bool Find(
+        const Util::MetroHash::Hash& hash,
+        ShaderModuleHandle*          pShaderModule);
+
+    Util::Result Insert(
+        const Util::MetroHash::Hash& hash,
+        const ShaderModuleHandle&    shaderModule);
+
+    void Reset();
+
+    void GetStats(
+        Stats* pStats) const;
+
+private:
+    PAL_DISALLOW_DEFAULT_CTOR(ShaderModuleCache);
+    PAL_DISALLOW_COPY_AND_ASSIGN(ShaderModuleCache);
+
+    static constexpr uint32_t ShardCount = 16;
+
+    struct Entry
+    {
+        ShaderModuleHandle shaderModule;  // Cached module, owns one reference
+        volatile int64_t   lastUse;       // CPU timestamp of the last lookup, used to pick an eviction victim
+    };
+
+    typedef Util::HashMap<Util::MetroHash::Hash, Entry, PalAllocator, Util::JenkinsHashFunc> EntryMap;
+
+    struct Shard
+    {
+        Shard(PalAllocator* pAllocator)
+            :
+            map(8, pAllocator),
+            lookups(0),
+            hits(0),
+            evictions(0),
+            contendedLocks(0)
+        {
+        }
+
+        Util::RWLock      lock;            // Protects map
+        EntryMap          map;
+        volatile uint64_t lookups;
+        volatile uint64_t hits;
+        volatile uint64_t evictions;
+        volatile uint64_t contendedLocks;
+    };
+
+    Shard* GetShard(const Util::MetroHash::Hash& hash) const
+        { return m_pShards[hash.dwords[3] % ShardCount]; }
+
+    void LockForRead(Shard* pShard);
+    void LockForWrite(Shard* pShard);
+    void EvictLeastRecentlyUsed(Shard* pShard);
+
+    PipelineCompiler* const m_pCompiler;           // Frees the modules released by the cache
+    PalAllocator* const     m_pAllocator;          // Allocator of the shard maps
+    uint32_t                m_maxEntriesPerShard;  // Entry limit of a single shard, UINT32_MAX if unlimited
+    Shard*                  m_pShards[ShardCount]; // Shards, constructed in m_shardBuffer by Init()
+
+    alignas(Shard) uint8_t  m_shardBuffer[ShardCount][sizeof(Shard)];
+};
+
+} // namespace vk
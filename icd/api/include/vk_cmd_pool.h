@@ -40,7 +40,7 @@
 #include "include/vk_alloccb.h"
 
 #include "palCmdAllocator.h"
-#include "palHashSet.h"
+#include "palVector.h"
 
 namespace vk
 {
@@ -48,6 +48,16 @@ namespace vk
 class Device;
 class CmdBuffer;
 
+// Positions of a command buffer in the command buffer lists of its pool.  They are stored in the command buffer itself
+// so that the pool can insert and remove it in constant time without hashing.
+struct CmdPoolSlots
+{
+    static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+    uint32_t registry;  // Index in the list of all command buffers allocated from the pool
+    uint32_t begun;     // Index in the list of begun command buffers, or InvalidSlot if not begun since the last reset
+};
+
 // =====================================================================================================================
 // A Vulkan command buffer pool
 class CmdPool final : public NonDispatchable<VkCommandPool, CmdPool>
@@ -104,6 +114,10 @@ private:
 
     VkResult ResetCmdAllocator(bool releaseResources);
 
+    typedef Util::Vector<CmdBuffer*, 32, PalAllocator> CmdBufferList;
+
+    static void RemoveFromList(CmdBufferList* pList, uint32_t slot, bool isBegunList);
+
     Device*                      m_pDevice;
     Pal::ICmdAllocator*          m_pPalCmdAllocators[MaxPalDevices];
     const VkAllocationCallbacks* m_pAllocator;
@@ -121,12 +135,13 @@ private:
         uint32 u32All;
     } m_flags;
 
-    Util::HashSet<CmdBuffer*, PalAllocator> m_cmdBufferRegistry;
+    // Dense lists of the command buffers of the pool.  Each command buffer knows its own slots in them (CmdPoolSlots).
+    CmdBufferList m_cmdBufferRegistry;
 
-    Util::HashSet<CmdBuffer*, PalAllocator> m_cmdBuffersAlreadyBegun;
+    CmdBufferList m_cmdBuffersAlreadyBegun;
 
     // Indicates that the command pool is currently being reset.  This is used to prevent erasing individual elements
-    // in m_cmdBuffersAlreadyBegun during reset as it is more efficient to reset the entire HashSet all at once after
+    // in m_cmdBuffersAlreadyBegun during reset as it is more efficient to clear the entire list all at once after
     // all individual command buffer resets of the command buffers in m_cmdBuffersAlreadyBegun are completed.
     bool m_cmdPoolResetInProgress = false;
 };
@@ -44,6 +44,7 @@
 #include "include/vk_render_pass.h"
 #include "include/vk_utils.h"
 
+#include "include/barrier_accumulator.h"
 #include "include/barrier_policy.h"
 #include "include/graphics_pipeline_common.h"
 #include "include/internal_mem_mgr.h"
@@ -110,6 +111,13 @@ union PipelineDynamicBindInfo
     Pal::DynamicGraphicsShaderInfos gfx;
 };
 
+// Range of the descriptor set binding data shadow that a descriptor set was last programmed from
+struct SetUserDataRange
+{
+    uint32_t regOffset;
+    uint32_t regCount;
+};
+
 // This structure contains information about currently written user data entries within the command buffer
 struct PipelineBindState
 {
@@ -117,6 +125,10 @@ struct PipelineBindState
     UserDataLayout userDataLayout;
     // High-water mark of the largest number of bound sets
     uint32_t boundSetCount;
+    // Mask of descriptor sets whose binding data shadow is known to match the user data programmed in the PAL
+    // command buffer, and the shadow range each of them occupies
+    uint32_t         validSetMask;
+    SetUserDataRange validSetRange[MaxDescriptorSets];
     // High-water mark of the largest number of pushed constants
     uint32_t pushedConstCount;
     // Currently pushed constant values (relative to an base = 0)
@@ -149,11 +161,95 @@ union DirtyGraphicsState
     uint32 u32All;
 };
 
+// Bit positions of the DirtyGraphicsState flags, in declaration order.  ValidateStates() uses these to index its table
+// of per-state emit functions.
+enum DirtyGraphicsStateBit : uint32
+{
+    DirtyGraphicsViewport = 0,
+    DirtyGraphicsScissor,
+    DirtyGraphicsDepthStencil,
+    DirtyGraphicsRasterState,
+    DirtyGraphicsInputAssembly,
+    DirtyGraphicsStencilRef,
+    DirtyGraphicsVrs,
+    DirtyGraphicsColorWriteEnable,
+    DirtyGraphicsRasterizerDiscardEnable,
+    DirtyGraphicsSamplePattern,
+    DirtyGraphicsStateCount
+};
+
+// Dynamic state which vkCmdSet* functions write to the PAL command buffer immediately rather than at draw time
+union ImmediateGraphicsState
+{
+    struct
+    {
+        uint32 pointLineRasterState :  1;
+        uint32 depthBias            :  1;
+        uint32 blendConst           :  1;
+        uint32 depthBounds          :  1;
+        uint32 lineStipple          :  1;
+        uint32 reserved             : 27;
+    };
+
+    uint32 u32All;
+};
+
+// Number of vkCmdSet* calls of a command buffer which were skipped because they did not change the current state.
+// These are only collected if the EnableCmdBufferRecordingStats setting is set.
+struct RedundantStateStats
+{
+    uint64_t viewport;
+    uint64_t scissor;
+    uint64_t stencilRef;
+    uint64_t depthStencil;
+    uint64_t rasterState;
+    uint64_t inputAssembly;
+    uint64_t pointLineRasterState;
+    uint64_t depthBias;
+    uint64_t blendConst;
+    uint64_t depthBounds;
+    uint64_t lineStipple;
+    uint64_t descriptorSets;
+    uint64_t descriptorSetUserDataBytes;
+};
+
+// CPU side costs of recording a command buffer between vkBeginCommandBuffer and vkEndCommandBuffer.  These are only
+// collected if the EnableCmdBufferRecordingStats setting is set.
+struct CmdBufferRecordingStats
+{
+    uint64_t draws;
+    uint64_t dispatches;
+    uint64_t barriers;            // vkCmdPipelineBarrier and vkCmdWaitEvents calls
+    uint64_t accumulatedBarriers; // Pipeline barriers deferred to the barrier accumulator
+    uint64_t barrierFlushes;      // Combined barriers issued by the barrier accumulator
+    uint64_t mergedBarriers;      // Buffer and image barriers merged into a pending one by the barrier accumulator
+    uint64_t userDataWrites;      // PAL CmdSetUserData calls for descriptor sets and push constants
+    uint64_t stateEmissions;      // Dirty graphics states written by ValidateStates
+    uint64_t pipelineBinds;
+    uint64_t embeddedDataBytes;
+    uint64_t recordingTimeNs;
+};
+
 struct DynamicDepthStencil
 {
     Pal::IDepthStencilState* pPalDepthStencil[MaxPalDevices];
 };
 
+// Slot of the per command buffer cache which maps dynamic depth-stencil create info to the states already created for
+// it. An empty slot has a null pPalDepthStencil[0].
+struct DynamicDepthStencilCacheEntry
+{
+    Pal::DepthStencilStateCreateInfo createInfo;
+    DynamicDepthStencil              states;      // Owned by CmdBuffer::m_palDepthStencilState
+};
+
+// Hit and miss counters of the dynamic depth-stencil state cache of a command buffer
+struct DynamicDepthStencilCacheStats
+{
+    uint64_t hits;    // Dynamic depth-stencil states found in the command buffer's cache
+    uint64_t misses;  // Dynamic depth-stencil states requested from the RenderStateCache
+};
+
 // Members of CmdBufferRenderState that are different for each GPU
 struct PerGpuRenderState
 {
@@ -258,6 +354,12 @@ struct AllGpuRenderState
         uint32_t fragmentShadingRate;
     } staticTokens;
 
+    // Dynamic state whose tracked value below is known to be programmed in the PAL command buffer (or pending through
+    // its dirty bit).  Redundant vkCmdSet* calls are only filtered for such state.  Cleared whenever the state of the
+    // PAL command buffer becomes unknown, e.g. after executing secondary command buffers.
+    DirtyGraphicsState            validGraphics;
+    ImmediateGraphicsState        validImmediate;
+
     // Which Vulkan PipelineBindPoint currently owns the state of each PAL pipeline bind point.  This is
     // relevant because e.g. multiple Vulkan pipeline bind points are implemented as compute pipelines and used through
     // the same PAL pipeline bind point.
@@ -272,6 +374,11 @@ struct AllGpuRenderState
     Pal::ColorWriteMaskParams        colorWriteMaskParams;
     SamplePattern                    samplePattern;
 
+    // Last values written by vkCmdSet* functions for ImmediateGraphicsState
+    Pal::PointLineRasterStateParams  pointLineRasterState;
+    Pal::DepthBiasParams             depthBias;
+    Pal::BlendConstParams            blendConst;
+    Pal::DepthBoundsParams           depthBounds;
 };
 
 // State tracked during a render pass instance when building a command buffer.
@@ -361,6 +468,7 @@ public:
         VkDeviceSize                                offset,
         VkIndexType                                 indexType);
 
+    template <uint32_t numPalDevices>
     void BindVertexBuffers(
         uint32_t                                    firstBinding,
         uint32_t                                    bindingCount,
@@ -382,6 +490,21 @@ public:
         uint32_t                                    firstInstance,
         uint32_t                                    instanceCount);
 
+    void DrawMulti(
+        uint32_t                                    drawCount,
+        const VkMultiDrawInfoEXT*                   pVertexInfo,
+        uint32_t                                    instanceCount,
+        uint32_t                                    firstInstance,
+        uint32_t                                    stride);
+
+    void DrawMultiIndexed(
+        uint32_t                                    drawCount,
+        const VkMultiDrawIndexedInfoEXT*            pIndexInfo,
+        uint32_t                                    instanceCount,
+        uint32_t                                    firstInstance,
+        uint32_t                                    stride,
+        const int32_t*                              pVertexOffset);
+
     template< bool indexed, bool useBufferCount>
     void DrawIndirect(
         VkBuffer                                    buffer,
@@ -516,11 +639,13 @@ public:
         uint32_t                                    rectCount,
         const ImageResolveType*                     pRects);
 
+    template <uint32_t numPalDevices>
     void SetViewport(
         uint32_t                                    firstViewport,
         uint32_t                                    viewportCount,
         const VkViewport*                           pViewports);
 
+    template <uint32_t numPalDevices>
     void SetViewportWithCount(
         uint32_t                                    viewportCount,
         const VkViewport*                           pViewports);
@@ -529,11 +654,13 @@ public:
         const Pal::ViewportParams&                  params,
         uint32_t                                    staticToken);
 
+    template <uint32_t numPalDevices>
     void SetScissor(
         uint32_t                                    firstScissor,
         uint32_t                                    scissorCount,
         const VkRect2D*                             pScissors);
 
+    template <uint32_t numPalDevices>
     void SetScissorWithCount(
         uint32_t                                    scissorCount,
         const VkRect2D*                             pScissors);
@@ -668,6 +795,16 @@ public:
     void PipelineBarrier2(
         const VkDependencyInfoKHR*                  pDependencyInfo);
 
+    // Issues the pipeline barriers deferred by the barrier accumulator.  Must be called before recording any command
+    // that does work.
+    void FlushPendingBarriers()
+    {
+        if (m_barrierAccumulator.IsEmpty() == false)
+        {
+            IssuePendingBarriers();
+        }
+    }
+
     void PipelineBarrierSync2ToSync1(
         const VkDependencyInfoKHR*                  pDependencyInfo);
 
@@ -797,6 +934,18 @@ public:
         VK_ASSERT((m_allGpuState.pRenderPass == nullptr) ||
                   (((m_rpDeviceMask ^ deviceMask) & deviceMask) == 0));
 
+        // Pending barriers apply to the devices they were recorded for, and descriptor sets bound while a device was
+        // masked off were never programmed on it.
+        if (m_curDeviceMask != deviceMask)
+        {
+            FlushPendingBarriers();
+
+            for (uint32_t bindIdx = 0; bindIdx < PipelineBindCount; ++bindIdx)
+            {
+                m_allGpuState.pipelineState[bindIdx].validSetMask = 0;
+            }
+        }
+
         m_curDeviceMask = deviceMask;
     }
 
@@ -830,6 +979,24 @@ public:
         return m_pCmdPool->IsProtected();
     }
 
+    const DynamicDepthStencilCacheStats& GetDynamicDepthStencilCacheStats() const
+    {
+        return m_depthStencilCacheStats;
+    }
+
+    const RedundantStateStats& GetRedundantStateStats() const
+    {
+        return m_redundantStateStats;
+    }
+
+    const CmdBufferRecordingStats& GetRecordingStats() const
+    {
+        return m_recordingStats;
+    }
+
+    CmdPoolSlots* GetCmdPoolSlots()
+        { return &m_cmdPoolSlots; }
+
     VkResult Destroy(void);
 
     VK_FORCEINLINE Device* VkDevice(void) const
@@ -1089,6 +1256,13 @@ public:
 
     static PFN_vkCmdBindDescriptorSets GetCmdBindDescriptorSetsFunc(const Device* pDevice);
 
+    static PFN_vkCmdBindVertexBuffers GetCmdBindVertexBuffersFunc(const Device* pDevice);
+    static PFN_vkCmdBindVertexBuffers2 GetCmdBindVertexBuffers2Func(const Device* pDevice);
+    static PFN_vkCmdSetViewport GetCmdSetViewportFunc(const Device* pDevice);
+    static PFN_vkCmdSetViewportWithCount GetCmdSetViewportWithCountFunc(const Device* pDevice);
+    static PFN_vkCmdSetScissor GetCmdSetScissorFunc(const Device* pDevice);
+    static PFN_vkCmdSetScissorWithCount GetCmdSetScissorWithCountFunc(const Device* pDevice);
+
     static PFN_vkCmdPushDescriptorSetKHR GetCmdPushDescriptorSetKHRFunc(const Device* pDevice);
     static PFN_vkCmdPushDescriptorSetWithTemplateKHR GetCmdPushDescriptorSetWithTemplateKHRFunc(const Device* pDevice);
 
@@ -1124,6 +1298,27 @@ private:
 
     void ValidateStates();
 
+    // Writes the dirty states owned by one ValidateStates() table entry to the PAL command buffers of all devices.
+    typedef void (CmdBuffer::*EmitDirtyStateFunc)(uint32_t dirtyMask);
+
+    struct EmitDirtyStateEntry
+    {
+        EmitDirtyStateFunc pfnEmit;   // Emit function for this state
+        uint32_t           stateMask; // All dirty bits written by pfnEmit, i.e. states emitted together as a group
+    };
+
+    static const EmitDirtyStateEntry EmitDirtyStateTable[DirtyGraphicsStateCount];
+
+    void EmitViewportAndScissor(uint32_t dirtyMask);
+    void EmitDepthStencilState(uint32_t dirtyMask);
+    void EmitTriangleRasterState(uint32_t dirtyMask);
+    void EmitInputAssemblyState(uint32_t dirtyMask);
+    void EmitStencilRefMasks(uint32_t dirtyMask);
+    void EmitVrsRate(uint32_t dirtyMask);
+    void EmitColorWriteMask(uint32_t dirtyMask);
+    void EmitRasterizerDiscardEnable(uint32_t dirtyMask);
+    void EmitSamplePattern(uint32_t dirtyMask);
+
     void ValidateSamplePattern(uint32_t sampleCount, SamplePattern* pSamplePattern);
 
     CmdBuffer(
@@ -1172,6 +1367,28 @@ private:
         const VkImageMemoryBarrier*  pImageMemoryBarriers,
         Pal::BarrierInfo*            pBarrier);
 
+    void RecordPipelineBarrier(
+        PipelineStageFlags           srcStageMask,
+        PipelineStageFlags           dstStageMask,
+        uint32_t                     memBarrierCount,
+        const VkMemoryBarrier*       pMemoryBarriers,
+        uint32_t                     bufferMemoryBarrierCount,
+        const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+        uint32_t                     imageMemoryBarrierCount,
+        const VkImageMemoryBarrier*  pImageMemoryBarriers);
+
+    void ExecutePipelineBarrier(
+        PipelineStageFlags           srcStageMask,
+        PipelineStageFlags           dstStageMask,
+        uint32_t                     memBarrierCount,
+        const VkMemoryBarrier*       pMemoryBarriers,
+        uint32_t                     bufferMemoryBarrierCount,
+        const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+        uint32_t                     imageMemoryBarrierCount,
+        const VkImageMemoryBarrier*  pImageMemoryBarriers);
+
+    void IssuePendingBarriers();
+
     void ExecuteReleaseThenAcquire(
         PipelineStageFlags           srcStageMask,
         PipelineStageFlags           dstStageMask,
@@ -1275,6 +1492,22 @@ private:
 
     void ReleaseResources();
 
+    // Returns true if a vkCmdSet* call that does not change the tracked value of some state can be skipped
+    bool CanFilterState(uint32 stateValid) const
+    {
+        return (m_flags.filterRedundantDynamicState != 0) && (stateValid != 0);
+    }
+
+    void UpdateStencilRefMaskDirty(const Pal::StencilRefMaskParams& prevStencilRefMasks);
+
+    bool FindDynamicDepthStencil(
+        const Pal::DepthStencilStateCreateInfo& createInfo,
+        Pal::IDepthStencilState**               ppPalDepthStencil);
+
+    void CacheDynamicDepthStencil(
+        const Pal::DepthStencilStateCreateInfo& createInfo,
+        Pal::IDepthStencilState* const*         ppPalDepthStencil);
+
 #if VK_ENABLE_DEBUG_BARRIERS
     void DbgCmdBarrier(bool preCmd);
 #endif
@@ -1289,9 +1522,11 @@ private:
         uint32_t                                    dynamicOffsetCount,
         const uint32_t*                             pDynamicOffsets);
 
-void SetUserDataPipelineLayout(
+    template <uint32_t numPalDevices>
+    void SetUserDataPipelineLayout(
         uint32_t                                    firstSet,
         uint32_t                                    setCount,
+        uint32_t                                    setMask,
         const PipelineLayout*                       pLayout,
         const Pal::PipelineBindPoint                palBindPoint,
         const PipelineBindPoint                     apiBindPoint);
@@ -1310,6 +1545,50 @@ void SetUserDataPipelineLayout(
     template <uint32_t numPalDevices>
     static PFN_vkCmdBindDescriptorSets GetCmdBindDescriptorSetsFunc(const Device* pDevice);
 
+    template <uint32_t numPalDevices>
+    static VKAPI_ATTR void VKAPI_CALL CmdBindVertexBuffers(
+        VkCommandBuffer                             cmdBuffer,
+        uint32_t                                    firstBinding,
+        uint32_t                                    bindingCount,
+        const VkBuffer*                             pBuffers,
+        const VkDeviceSize*                         pOffsets);
+
+    template <uint32_t numPalDevices>
+    static VKAPI_ATTR void VKAPI_CALL CmdBindVertexBuffers2(
+        VkCommandBuffer                             cmdBuffer,
+        uint32_t                                    firstBinding,
+        uint32_t                                    bindingCount,
+        const VkBuffer*                             pBuffers,
+        const VkDeviceSize*                         pOffsets,
+        const VkDeviceSize*                         pSizes,
+        const VkDeviceSize*                         pStrides);
+
+    template <uint32_t numPalDevices>
+    static VKAPI_ATTR void VKAPI_CALL CmdSetViewport(
+        VkCommandBuffer                             cmdBuffer,
+        uint32_t                                    firstViewport,
+        uint32_t                                    viewportCount,
+        const VkViewport*                           pViewports);
+
+    template <uint32_t numPalDevices>
+    static VKAPI_ATTR void VKAPI_CALL CmdSetViewportWithCount(
+        VkCommandBuffer                             cmdBuffer,
+        uint32_t                                    viewportCount,
+        const VkViewport*                           pViewports);
+
+    template <uint32_t numPalDevices>
+    static VKAPI_ATTR void VKAPI_CALL CmdSetScissor(
+        VkCommandBuffer                             cmdBuffer,
+        uint32_t                                    firstScissor,
+        uint32_t                                    scissorCount,
+        const VkRect2D*                             pScissors);
+
+    template <uint32_t numPalDevices>
+    static VKAPI_ATTR void VKAPI_CALL CmdSetScissorWithCount(
+        VkCommandBuffer                             cmdBuffer,
+        uint32_t                                    scissorCount,
+        const VkRect2D*                             pScissors);
+
     template <uint32_t numPalDevices>
     VkDescriptorSet InitPushDescriptorSet(
         const DescriptorSetLayout*               pDestSetLayout,
@@ -1401,12 +1680,17 @@ void SetUserDataPipelineLayout(
             uint32_t isRenderingSuspended                :  1;
             uint32_t reserved4                           :  1;
             uint32_t reserved5                           :  1;
-            uint32_t reserved                            : 14;
+            uint32_t filterRedundantDynamicState         :  1;
+            uint32_t accumulatePipelineBarriers          :  1;
+            uint32_t filterRedundantDescriptorSets       :  1;
+            uint32_t collectRecordingStats               :  1;
+            uint32_t reserved                            : 10;
         };
     };
 
     Device* const                 m_pDevice;
     CmdPool* const                m_pCmdPool;
+    CmdPoolSlots                  m_cmdPoolSlots;  // Maintained by m_pCmdPool
     uint32_t                      m_queueFamilyIndex;
     Pal::QueueType                m_palQueueType;
     Pal::EngineType               m_palEngineType;
@@ -1438,6 +1722,20 @@ void SetUserDataPipelineLayout(
 
     Util::Vector<DynamicDepthStencil, 16, PalAllocator> m_palDepthStencilState;
 
+    // Open addressing cache of the dynamic depth-stencil states in m_palDepthStencilState, keyed on their create info
+    static constexpr uint32_t     DepthStencilCacheSize = 32;   // Must be a power of two
+
+    DynamicDepthStencilCacheEntry m_depthStencilCache[DepthStencilCacheSize];
+    uint32_t                      m_depthStencilCacheCount;     // Number of used slots in m_depthStencilCache
+    DynamicDepthStencilCacheStats m_depthStencilCacheStats;
+
+    RedundantStateStats           m_redundantStateStats;
+
+    BarrierAccumulator            m_barrierAccumulator;  // Pipeline barriers deferred to the next command doing work
+
+    CmdBufferRecordingStats       m_recordingStats;
+    uint64_t                      m_recordingStartTicks;  // CPU time of vkBeginCommandBuffer if recording stats
+
     uint32                        m_vbWatermark;  // tracks how many vb entries need to be reset
 
 };
@@ -1507,6 +1805,11 @@ void CmdBuffer::PalCmdBufferSetUserData(
             entryCount,
             pEntryValues + (deviceIdx * perDeviceStride));
     }
+
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.userDataWrites += m_numPalDevices;
+    }
 }
 
 // =====================================================================================================================
@@ -1634,6 +1937,23 @@ VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(
     int32_t                                     vertexOffset,
     uint32_t                                    firstInstance);
 
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawInfoEXT*                   pVertexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiIndexedEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawIndexedInfoEXT*            pIndexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride,
+    const int32_t*                              pVertexOffset);
+
 VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndirect(
     VkCommandBuffer                             commandBuffer,
     VkBuffer                                    buffer,
@@ -48,6 +48,17 @@ namespace vk
 class DescriptorSetLayout;
 class DescriptorPool;
 
+// =====================================================================================================================
+// Statistics of the free GPU memory of a DescriptorGpuMemHeap created with
+// VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT.
+struct DescriptorGpuMemHeapStats
+{
+    Pal::gpusize    freeSize;           // Total size of the free blocks in bytes
+    Pal::gpusize    largestFreeBlock;   // Size of the largest free block in bytes
+    uint32_t        freeBlockCount;     // Number of free blocks
+    float           fragmentation;      // 1 - (largestFreeBlock / freeSize), or 0 if nothing is free
+};
+
 // =====================================================================================================================
 // This class manages GPU memory for descriptor sets.  It is owned by DescriptorPool.
 class DescriptorGpuMemHeap
@@ -67,7 +78,7 @@ public:
         Device* pDevice,
         const VkAllocationCallbacks* pAllocator);
 
-    bool AllocSetGpuMem(
+    VkResult AllocSetGpuMem(
         const DescriptorSetLayout*  pLayout,
         uint32_t                    variableDescriptorCounts,
         Pal::gpusize*               pSetGpuMemOffset,
@@ -84,6 +95,12 @@ public:
 
     void Reset();
 
+    void GetDynamicAllocStats(
+        DescriptorGpuMemHeapStats*  pStats) const;
+
+    void LogDynamicAllocStats(
+        uint64_t                    logTagIdMask) const;
+
     void* CpuAddr(uint32_t deviceIdx) const
         { return m_pCpuAddr[deviceIdx]; }
 
@@ -91,21 +108,31 @@ public:
         { return m_pCpuShadowAddr[deviceIdx]; }
 
 protected:
+    // Dynamic allocations use a two-level segregated fit (TLSF) scheme.  Block sizes are measured in units of
+    // m_gpuMemAddrAlignment.  The first level size class is the power of two of the size, and the second level divides
+    // each first level class linearly into DynamicAllocSlCount sub-classes.  Each size class keeps its own list of free
+    // blocks, and bitmaps of the non-empty lists let allocation find a large enough block in constant time.
+    static constexpr uint32_t DynamicAllocSlBits        = 2;
+    static constexpr uint32_t DynamicAllocSlCount       = (1 << DynamicAllocSlBits);
+    static constexpr uint32_t DynamicAllocFlCount       = 32;
+    static constexpr uint32_t DynamicAllocFreeListCount = DynamicAllocFlCount * DynamicAllocSlCount;
+    static constexpr uint32_t NotFreeListIndex          = UINT32_MAX;
+
     struct DynamicAllocBlock
     {
-        DynamicAllocBlock*    pPrevFree;                // Address of the previous free block (null for non-free blocks)
-        DynamicAllocBlock*    pNextFree;                // Address of next free block (null for non-free blocks)
+        DynamicAllocBlock*    pPrevFree;                // Address of the previous free block in the size class list
+        DynamicAllocBlock*    pNextFree;                // Address of the next free block in the size class list
         DynamicAllocBlock*    pPrev;                    // Address of previous block
         DynamicAllocBlock*    pNext;                    // Address of next block
         Pal::gpusize          gpuMemOffsetRangeStart;   // Start of GPU address range of this block
         Pal::gpusize          gpuMemOffsetRangeEnd;     // End of GPU address range of this block
+        uint32_t              freeListIndex;            // Size class free list of this block or NotFreeListIndex
     };
 
     bool IsDynamicAllocBlockFree(const DynamicAllocBlock* pBlock) const
     {
-        // pPrevFree is never null for free blocks as they are chained after a list header so this is how we determine
-        // whether a block is free. Also, we consider null as a non-free block for simplicity.
-        return (pBlock != nullptr) && (pBlock->pPrevFree != nullptr);
+        // We consider null as a non-free block for simplicity.
+        return (pBlock != nullptr) && (pBlock->freeListIndex != NotFreeListIndex);
     }
 
     uint32_t DynamicAllocBlockIndex(const DynamicAllocBlock* pBlock) const
@@ -114,6 +141,13 @@ protected:
         return static_cast<uint32_t>(Util::VoidPtrDiff(pBlock, m_pDynamicAllocBlocks) / sizeof(DynamicAllocBlock));
     }
 
+    static uint32_t DynamicAllocFreeListIndex(uint32_t sizeInUnits);
+
+    void InsertFreeDynamicAllocBlock(DynamicAllocBlock* pBlock);
+    void RemoveFreeDynamicAllocBlock(DynamicAllocBlock* pBlock);
+
+    DynamicAllocBlock* FindFreeDynamicAllocBlock(Pal::gpusize byteSize) const;
+
 #if DEBUG
     void SanityCheckDynamicAllocBlockList();
 #endif
@@ -122,7 +156,11 @@ protected:
 
     Pal::gpusize              m_oneShotAllocForward;    // Start of free memory for one-shot allocs (allocated forwards)
 
-    DynamicAllocBlock         m_dynamicAllocBlockFreeListHeader;    // Header for the list of free blocks
+    DynamicAllocBlock**       m_ppDynamicAllocFreeLists;            // First free block of each size class
+    uint32_t                  m_dynamicAllocFlBitmap;               // First level classes with any free block
+    uint8_t                   m_dynamicAllocSlBitmap[DynamicAllocFlCount]; // Non-empty second level classes
+    Pal::gpusize              m_dynamicAllocFreeSize;               // Total size of the free blocks
+    uint32_t                  m_dynamicAllocFreeBlockCount;         // Number of free blocks
     DynamicAllocBlock*        m_pDynamicAllocBlocks;                // Storage of block structures
     uint32_t                  m_dynamicAllocBlockCount;             // Number of block structures
     uint32_t*                 m_pDynamicAllocBlockIndexStack;       // Stack of indices of available block structures
@@ -219,6 +219,13 @@ public:
     uint64_t GetApiHash() const
         { return m_apiHash; }
 
+    // Create info data the layout is interned by, or nullptr if the layout is not shared through the intern table
+    const void* GetInternKey(size_t* pKeySize) const
+    {
+        *pKeySize = m_internKeySize;
+        return m_pInternKey;
+    }
+
 protected:
     DescriptorSetLayout(
         const Device*     pDevice,
@@ -262,9 +269,16 @@ protected:
     static uint64_t BuildApiHash(
         const VkDescriptorSetLayoutCreateInfo* pCreateInfo);
 
+    static size_t BuildInternKey(
+        const Device*                          pDevice,
+        const VkDescriptorSetLayoutCreateInfo* pCreateInfo,
+        void*                                  pKey);
+
     const CreateInfo          m_info;    // Create-time information
     const Device* const       m_pDevice; // Device pointer
     const uint64_t            m_apiHash;
+    const void*               m_pInternKey;    // Intern table key stored after the layout data, if interned
+    size_t                    m_internKeySize; // Size of the intern table key in bytes
 
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(DescriptorSetLayout);
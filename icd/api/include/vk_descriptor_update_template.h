@@ -70,20 +70,35 @@ public:
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(DescriptorUpdateTemplate);
 
-    DescriptorUpdateTemplate(
-        VkPipelineBindPoint         pipelineBindPoint,
-        uint32_t                    numEntries);
-
-    ~DescriptorUpdateTemplate();
-
     struct TemplateUpdateInfo;
 
+    // CPU addresses of the destination descriptor set, resolved once per update for all entries.
+    struct UpdateDestination
+    {
+        uint32_t*   pStaticCpuAddr[MaxPalDevices];  // Static section of the set
+        uint32_t*   pFmaskCpuAddr[MaxPalDevices];   // Fmask section of the set
+        uint32_t*   pDynamicData[MaxPalDevices];    // Client memory of the dynamic buffer descriptors
+    };
+
     typedef void(*PfnUpdateEntry)(
         const Device*               pDevice,
-        VkDescriptorSet             descriptorSet,
+        const UpdateDestination&    dest,
         const void*                 pDescriptorInfo,
         const TemplateUpdateInfo&   entry);
 
+    typedef void(*PfnUpdateSet)(
+        const DescriptorUpdateTemplate* pTemplate,
+        const Device*                   pDevice,
+        VkDescriptorSet                 descriptorSet,
+        const void*                     pData);
+
+    DescriptorUpdateTemplate(
+        VkPipelineBindPoint         pipelineBindPoint,
+        uint32_t                    numEntries,
+        PfnUpdateSet                pfnUpdateSet);
+
+    ~DescriptorUpdateTemplate();
+
     struct TemplateUpdateInfo
     {
         PfnUpdateEntry  pFunc;
@@ -121,31 +136,47 @@ private:
         VkDescriptorType                        descriptorType,
         const DescriptorSetLayout::BindingInfo& dstBinding);
 
+    static PfnUpdateSet GetUpdateSetFunc(
+        const Device*                           pDevice);
+
+    static bool CanMergeEntries(
+        const TemplateUpdateInfo&               prevEntry,
+        VkDescriptorType                        prevDescriptorType,
+        const TemplateUpdateInfo&               entry,
+        VkDescriptorType                        descriptorType);
+
+    template <uint32_t numPalDevices>
+    static void UpdateSet(
+        const DescriptorUpdateTemplate* pTemplate,
+        const Device*                   pDevice,
+        VkDescriptorSet                 descriptorSet,
+        const void*                     pData);
+
     template <size_t imageDescSize, size_t fmaskDescSize, bool isShaderStorageDesc, uint32_t numPalDevices>
     static void UpdateEntrySampledImage(
         const Device*               pDevice,
-        VkDescriptorSet             descriptorSet,
+        const UpdateDestination&    dest,
         const void*                 pDescriptorInfo,
         const TemplateUpdateInfo&   entry);
 
     template <size_t samplerDescSize, uint32_t numPalDevices>
     static void UpdateEntrySampler(
         const Device*               pDevice,
-        VkDescriptorSet             descriptorSet,
+        const UpdateDestination&    dest,
         const void*                 pDescriptorInfo,
         const TemplateUpdateInfo&   entry);
 
     template <size_t bufferDescSize, VkDescriptorType descriptorType, uint32_t numPalDevices>
     static void UpdateEntryBuffer(
         const Device*               pDevice,
-        VkDescriptorSet             descriptorSet,
+        const UpdateDestination&    dest,
         const void*                 pDescriptorInfo,
         const TemplateUpdateInfo&   entry);
 
     template <size_t bufferDescSize, VkDescriptorType descriptorType, uint32_t numPalDevices>
     static void UpdateEntryTexelBuffer(
         const Device*               pDevice,
-        VkDescriptorSet             descriptorSet,
+        const UpdateDestination&    dest,
         const void*                 pDescriptorInfo,
         const TemplateUpdateInfo&   entry);
 
@@ -153,19 +184,20 @@ private:
         bool ycbcrUsage, uint32_t numPalDevices>
     static void UpdateEntryCombinedImageSampler(
         const Device*               pDevice,
-        VkDescriptorSet             descriptorSet,
+        const UpdateDestination&    dest,
         const void*                 pDescriptorInfo,
         const TemplateUpdateInfo&   entry);
 
     template <uint32_t numPalDevices>
     static void UpdateEntryInlineUniformBlock(
         const Device*               pDevice,
-        VkDescriptorSet             descriptorSet,
+        const UpdateDestination&    dest,
         const void*                 pDescriptorInfo,
         const TemplateUpdateInfo&   entry);
 
     VkPipelineBindPoint         m_pipelineBindPoint;
-    uint32_t                    m_numEntries;
+    uint32_t                    m_numEntries;       // Number of entries after merging contiguous ones
+    PfnUpdateSet                m_pfnUpdateSet;
 };
 
 namespace entry
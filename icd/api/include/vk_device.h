@@ -93,6 +93,7 @@ class DispatchableQueue;
 class Instance;
 class OptLayer;
 class PhysicalDevice;
+class PipelineCache;
 class Queue;
 class SqttMgr;
 class SwapChain;
@@ -681,6 +682,34 @@ public:
     void FreeUnreservedPrivateData(
         void*                           pMemory) const;
 
+    // Kinds of layout objects shared through the device-level layout intern table
+    enum class InternedLayoutType : uint32_t
+    {
+        DescriptorSet = 0,
+        Pipeline
+    };
+
+    bool UseLayoutInterning() const
+        { return m_useLayoutInterning; }
+
+    void* AcquireInternedLayout(
+        InternedLayoutType              type,
+        uint64_t                        apiHash,
+        const void*                     pKey,
+        size_t                          keySize) const;
+
+    VkResult InternLayout(
+        InternedLayoutType              type,
+        uint64_t                        apiHash,
+        const void*                     pKey,
+        size_t                          keySize,
+        void**                          ppLayout) const;
+
+    bool ReleaseInternedLayout(
+        InternedLayoutType              type,
+        uint64_t                        apiHash,
+        const void*                     pLayout) const;
+
     Util::RWLock* GetPrivateDataRWLock()
     {
         return &m_privateDataRWLock;
@@ -762,6 +791,18 @@ protected:
     VkResult AllocBorderColorPalette();
     void     DestroyBorderColorPalette();
 
+    bool UseParallelPipelineBatch(
+        uint32_t                     count,
+        const VkAllocationCallbacks* pAllocator) const;
+
+    template<typename PipelineCreateInfo>
+    VkResult CreatePipelineBatchParallel(
+        PipelineCache*               pPipelineCache,
+        uint32_t                     count,
+        const PipelineCreateInfo*    pCreateInfos,
+        const VkAllocationCallbacks* pAllocator,
+        VkPipeline*                  pPipelines);
+
     Instance* const                     m_pInstance;
     const RuntimeSettings&              m_settings;
 
@@ -859,6 +900,29 @@ protected:
     bool*                               m_pBorderColorUsedIndexes;
     Util::Mutex                         m_borderColorMutex;
 
+    // Layout object shared by all API handles created from identical layout create infos
+    struct InternedLayout
+    {
+        void*       pObject;   // Layout object owned by the intern table
+        const void* pKey;      // Create info data of the layout, stored within the layout object
+        size_t      keySize;   // Size of the create info data in bytes
+        uint32_t    refCount;  // Number of outstanding API handles referring to the object
+    };
+
+    typedef Util::HashMap<uint64_t, InternedLayout, PalAllocator> InternedLayoutMap;
+
+    static const uint32_t InternedLayoutBuckets = 64;
+
+    InternedLayoutMap* GetInternedLayoutMap(InternedLayoutType type) const
+    {
+        return (type == InternedLayoutType::DescriptorSet) ? &m_internedSetLayouts : &m_internedPipelineLayouts;
+    }
+
+    bool                                m_useLayoutInterning;       // Share layouts with identical API hashes
+    mutable InternedLayoutMap           m_internedSetLayouts;       // Descriptor set layouts keyed by API hash
+    mutable InternedLayoutMap           m_internedPipelineLayouts;  // Pipeline layouts keyed by API hash
+    mutable Util::Mutex                 m_internedLayoutMutex;      // Serializes access to the intern tables
+
     // This goes last.  The memory for the rest of the array is calculated dynamically based on the number of GPUs in
     // use.
     PerGpuInfo              m_perGpu[1];
@@ -342,6 +342,7 @@ public:
         EXT_LOAD_STORE_OP_NONE,
         EXT_MEMORY_BUDGET,
         EXT_MEMORY_PRIORITY,
+        EXT_MULTI_DRAW,
         EXT_NON_SEAMLESS_CUBE_MAP,
         EXT_PAGEABLE_DEVICE_LOCAL_MEMORY,
         EXT_PCI_BUS_INFO,
@@ -196,6 +196,8 @@ public:
         return (m_internalFlags.sparseBinding | m_internalFlags.sparseResidency) != 0;
     }
 
+    bool MayAliasMemory(const Image* pOther) const;
+
     bool Is2dArrayCompatible() const
     {
         return m_internalFlags.is2DArrayCompat != 0;
@@ -435,6 +437,9 @@ private:
 
     VkMemoryRequirements    m_memoryRequirements; // Image's memory requirements, including strict size if used
 
+    const Memory*           m_pBoundMemory;       // Memory object bound to the image, used to detect aliased images
+    VkDeviceSize            m_boundMemOffset;     // Offset of the image data within m_pBoundMemory
+
     // This goes last.  The memory for the rest of the array is calculated dynamically based on the number of GPUs in
     // use.
     PerGpuInfo              m_perGpu[1];
@@ -334,6 +334,10 @@ protected:
     static uint64_t BuildApiHash(
         const VkPipelineLayoutCreateInfo* pCreateInfo);
 
+    static size_t BuildInternKey(
+        const VkPipelineLayoutCreateInfo* pCreateInfo,
+        void*                             pKey);
+
     static Vkgc::ResourceMappingNodeType MapLlpcResourceNodeType(
         VkDescriptorType descriptorType);
 
@@ -351,6 +355,7 @@ protected:
     const PipelineInfo      m_pipelineInfo;
     const Device* const     m_pDevice;
     const uint64_t          m_apiHash;
+    bool                    m_interned; // Shared through the device's layout intern table
 
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(PipelineLayout);
@@ -301,6 +301,39 @@ private:
     uint32_t    m_mask;
 };
 
+// =====================================================================================================================
+// Device mask iterator for code that is instantiated per PAL device count.  The single device specialization visits
+// device 0 exactly once without scanning the mask, so the device loop folds away entirely in that instantiation.
+template <uint32_t numPalDevices>
+class IterateDeviceMask : public IterateMask
+{
+public:
+    IterateDeviceMask(uint32_t mask) :
+        IterateMask(mask)
+    {
+    }
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(IterateDeviceMask);
+};
+
+template <>
+class IterateDeviceMask<1>
+{
+public:
+    IterateDeviceMask(uint32_t mask)
+    {
+        VK_ASSERT(mask == 1);
+    }
+
+    constexpr bool IterateNext() const { return false; }
+
+    constexpr uint32_t Index() const { return 0; }
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(IterateDeviceMask);
+};
+
 // =====================================================================================================================
 // A "view" into an array of elements that are not tightly packed in memory. The use case is iterating over structures
 // nested in an array of structures, e.g. VkSparseImageMemoryRequirements inside VkSparseImageMemoryRequirements2.
@@ -30,11 +30,15 @@
 */
 #include "include/pipeline_binary_cache.h"
 #include "include/binary_cache_serialization.h"
+#include "include/log.h"
+#include "include/vk_alloccb.h"
 
 #include "palArchiveFile.h"
 #include "palAutoBuffer.h"
+#include "palEvent.h"
 #include "palPlatformKey.h"
 #include "palSysMemory.h"
+#include "palSysUtil.h"
 #include "palVectorImpl.h"
 #include "palHashMapImpl.h"
 #include "palFile.h"
@@ -45,6 +49,13 @@
 #endif
 #include <string.h>
 
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace vk
 {
 constexpr char   PipelineBinaryCache::EnvVarPath[];
@@ -56,6 +67,9 @@ static constexpr size_t ArchiveTypeStringLen = sizeof(ArchiveTypeString);
 static constexpr char   ElfTypeString[]      = "VK_PIPELINE_ELF";
 static constexpr size_t ElfTypeStringLen     = sizeof(ElfTypeString);
 
+// Upper bound of a single condition variable wait of the archive write-behind
+static constexpr uint32_t WriteBehindWaitTimeoutMs = 1000;
+
 const uint32_t PipelineBinaryCache::ArchiveType = Util::HashString(ArchiveTypeString, ArchiveTypeStringLen);
 const uint32_t PipelineBinaryCache::ElfType     = Util::HashString(ElfTypeString, ElfTypeStringLen);
 
@@ -63,11 +77,165 @@ const uint32_t PipelineBinaryCache::ElfType     = Util::HashString(ElfTypeString
 static Util::Hash128 ParseHash128(const char* str);
 #endif
 
+// =====================================================================================================================
+// Shared state of the threads validating the chunk digests of a pipeline binary cache blob
+struct DigestValidationState
+{
+    const Util::IPlatformKey*    pKey;
+    const void*                  pCacheData;
+    const BinaryCacheDigestInfo* pDigestInfo;
+    void*                        pContextMem;    // One hash context per participating thread
+    size_t                       contextSize;
+    volatile uint32_t            nextContext;
+    volatile uint32_t            nextChunk;
+    volatile uint32_t            mismatch;
+};
+
+// =====================================================================================================================
+// Claims and validates chunks until every chunk has been claimed or a mismatch has been found. Runs on the calling
+// thread as well as on the pipeline batch helper threads.
+static void ValidateDigestChunks(
+    void* pPayload)
+{
+    DigestValidationState*       pState      = static_cast<DigestValidationState*>(pPayload);
+    const BinaryCacheDigestInfo* pDigestInfo = pState->pDigestInfo;
+
+    void* pContextMem = Util::VoidPtrInc(pState->pContextMem,
+                                         (Util::AtomicIncrement(&pState->nextContext) - 1) * pState->contextSize);
+
+    uint32_t chunk = Util::AtomicIncrement(&pState->nextChunk) - 1;
+
+    while ((chunk < pDigestInfo->chunkCount) && (pState->mismatch == 0))
+    {
+        const size_t offset = chunk * pDigestInfo->chunkSize;
+        uint8_t      hashId[SHA_DIGEST_LENGTH];
+
+        Util::Result result = CalculatePipelineBinaryCacheHashId(
+                                pContextMem,
+                                pState->pKey,
+                                Util::VoidPtrInc(pState->pCacheData, offset),
+                                Util::Min(pDigestInfo->chunkSize, pDigestInfo->coveredSize - offset),
+                                hashId);
+
+        if ((result != Util::Result::Success) ||
+            (memcmp(hashId, &pDigestInfo->pDigests[chunk * SHA_DIGEST_LENGTH], SHA_DIGEST_LENGTH) != 0))
+        {
+            pState->mismatch = 1;
+        }
+
+        chunk = Util::AtomicIncrement(&pState->nextChunk) - 1;
+    }
+}
+
+// =====================================================================================================================
+// Validates a blob that ends with a digest entry. The private header hash only covers the digest entry, while each
+// chunk of the remaining data is checked against its own digest, on the pipeline batch helper threads if available.
+bool PipelineBinaryCache::IsValidChunkedBlob(
+    VkAllocationCallbacks*                  pAllocationCallbacks,
+    const Util::IPlatformKey*               pKey,
+    const PipelineBinaryCachePrivateHeader* pPrivateHeader,
+    size_t                                  dataSize,
+    const void*                             pData,
+    const BinaryCacheDigestInfo&            digestInfo,
+    PipelineCompiler*                       pCompiler)
+{
+    bool    isValid = false;
+    uint8_t hashId[SHA_DIGEST_LENGTH];
+
+    Util::Result result = CalculatePipelineBinaryCacheHashId(pAllocationCallbacks,
+                                                             pKey,
+                                                             Util::VoidPtrInc(pData, digestInfo.coveredSize),
+                                                             dataSize - digestInfo.coveredSize,
+                                                             hashId);
+
+    if ((result == Util::Result::Success) &&
+        (memcmp(hashId, pPrivateHeader->hashId, SHA_DIGEST_LENGTH) == 0))
+    {
+        const uint32_t chunkCount  = static_cast<uint32_t>(digestInfo.chunkCount);
+        const uint32_t helperCount = ((pCompiler != nullptr) && (chunkCount > 1)) ?
+            Util::Min(pCompiler->GetPipelineBatchThreadCount(), chunkCount - 1) : 0;
+
+        const size_t stateSize    = Util::Pow2Align(sizeof(DigestValidationState), VK_DEFAULT_MEM_ALIGN);
+        const size_t contextSize  = Util::Pow2Align(GetBinaryCacheHashContextSize(pKey), VK_DEFAULT_MEM_ALIGN);
+        const size_t contextsSize = contextSize * (helperCount + 1);
+        const size_t workloadSize = Util::Pow2Align(sizeof(DeferredCompileWorkload) * helperCount,
+                                                    VK_DEFAULT_MEM_ALIGN);
+        const size_t eventSize    = sizeof(Util::Event) * helperCount;
+
+        // All memory is allocated here because the allocation callbacks may only be called from the calling thread.
+        void* pMemory = pAllocationCallbacks->pfnAllocation(pAllocationCallbacks->pUserData,
+                                                            stateSize + contextsSize + workloadSize + eventSize,
+                                                            VK_DEFAULT_MEM_ALIGN,
+                                                            VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+
+        if (pMemory != nullptr)
+        {
+            DigestValidationState*   pState     = static_cast<DigestValidationState*>(pMemory);
+            DeferredCompileWorkload* pWorkloads = static_cast<DeferredCompileWorkload*>(
+                Util::VoidPtrInc(pMemory, stateSize + contextsSize));
+            Util::Event*             pEvents    = static_cast<Util::Event*>(
+                Util::VoidPtrInc(pMemory, stateSize + contextsSize + workloadSize));
+
+            pState->pKey        = pKey;
+            pState->pCacheData  = pData;
+            pState->pDigestInfo = &digestInfo;
+            pState->pContextMem = Util::VoidPtrInc(pMemory, stateSize);
+            pState->contextSize = contextSize;
+            pState->nextContext = 0;
+            pState->nextChunk   = 0;
+            pState->mismatch    = 0;
+
+            Util::EventCreateFlags flags = {};
+            flags.manualReset = true;
+
+            for (uint32_t i = 0; i < helperCount; ++i)
+            {
+                VK_PLACEMENT_NEW(&pEvents[i]) Util::Event();
+                pEvents[i].Init(flags);
+
+                pWorkloads[i].pPayloads = pState;
+                pWorkloads[i].Execute   = ValidateDigestChunks;
+                pWorkloads[i].pEvent    = &pEvents[i];
+                pWorkloads[i].queueIdx  = DeferCompileThread::InvalidQueueIdx;
+
+                pCompiler->ExecutePipelineBatchWorkload(&pWorkloads[i]);
+            }
+
+            // The calling thread validates chunks alongside the helpers.
+            ValidateDigestChunks(pState);
+
+            Util::Result waitResult = Util::Result::Success;
+
+            for (uint32_t i = 0; i < helperCount; ++i)
+            {
+                const Util::Result helperResult = pCompiler->FinishPipelineBatchWorkload(&pWorkloads[i]);
+
+                if (helperResult != Util::Result::Success)
+                {
+                    waitResult = helperResult;
+                }
+
+                Util::Destructor(&pEvents[i]);
+            }
+
+            isValid = (waitResult == Util::Result::Success) && (pState->mismatch == 0);
+
+            pAllocationCallbacks->pfnFree(pAllocationCallbacks->pUserData, pMemory);
+        }
+    }
+
+    return isValid;
+}
+
+// =====================================================================================================================
+// Checks that the blob following the private header was serialized with the given platform key and hasn't been
+// corrupted. Both blobs with and without chunk digests are accepted.
 bool PipelineBinaryCache::IsValidBlob(
-    VkAllocationCallbacks* pAllocationCallbacks,
-    Util::IPlatformKey*    pKey,
-    size_t                 dataSize,
-    const void*            pData)
+    VkAllocationCallbacks*    pAllocationCallbacks,
+    const Util::IPlatformKey* pKey,
+    size_t                    dataSize,
+    const void*               pData,
+    PipelineCompiler*         pCompiler)
 {
     VK_ASSERT(pData != nullptr);
 
@@ -81,16 +249,34 @@ bool PipelineBinaryCache::IsValidBlob(
         pData         = Util::VoidPtrInc(pData, sizeof(PipelineBinaryCachePrivateHeader));
         blobSize     -= sizeof(PipelineBinaryCachePrivateHeader);
 
-        Util::Result result = CalculatePipelineBinaryCacheHashId(
-                                pAllocationCallbacks,
-                                pKey,
-                                pData,
-                                blobSize,
-                                hashId);
+        BinaryCacheDigestInfo digestInfo = {};
 
-        if (result == Util::Result::Success)
+        if (ReadBinaryCacheDigestInfo(pData, blobSize, &digestInfo))
         {
-            isValid = (memcmp(hashId, pBinaryPrivateHeader->hashId, SHA_DIGEST_LENGTH) == 0);
+            isValid = IsValidChunkedBlob(pAllocationCallbacks,
+                                         pKey,
+                                         pBinaryPrivateHeader,
+                                         blobSize,
+                                         pData,
+                                         digestInfo,
+                                         pCompiler);
+        }
+
+        // Blobs written without chunk digests are hashed as a whole. This also covers the unlikely case of such a blob
+        // happening to end with something that looks like a digest footer.
+        if (isValid == false)
+        {
+            Util::Result result = CalculatePipelineBinaryCacheHashId(
+                                    pAllocationCallbacks,
+                                    pKey,
+                                    pData,
+                                    blobSize,
+                                    hashId);
+
+            if (result == Util::Result::Success)
+            {
+                isValid = (memcmp(hashId, pBinaryPrivateHeader->hashId, SHA_DIGEST_LENGTH) == 0);
+            }
         }
     }
 
@@ -135,13 +321,18 @@ PipelineBinaryCache* PipelineBinaryCache::Create(
             pObj = nullptr;
         }
         else if ((pInitData != nullptr) &&
-                 (initDataSize > (sizeof(BinaryCacheEntry) + sizeof(PipelineBinaryCachePrivateHeader))))
+                 (initDataSize > (sizeof(BinaryCacheEntry) + sizeof(PipelineBinaryCachePrivateHeader))) &&
+                 ((settings.lazyPipelineCacheInitialData == false) ||
+                  (pObj->InitLazyInitData(initDataSize, pInitData) != VK_SUCCESS)))
         {
             // The pipeline binary cache data format is as follows:
             // ```
             // | Public Header | Private Header (20B) | BinaryCacheEntry (24B) | Blob (n) | BinaryCacheEntry (24B) | ...
             // ```
             //
+            // In lazy mode the entries are only indexed by InitLazyInitData. They are stored here up front if lazy mode
+            // is disabled or indexing failed.
+            //
             const void* pBlob           = pInitData;
             size_t   blobSize           = initDataSize;
             constexpr size_t EntrySize  = sizeof(BinaryCacheEntry);
@@ -160,8 +351,12 @@ PipelineBinaryCache* PipelineBinaryCache::Create(
 
                 if (blobSize >= entryAndDataSize)
                 {
-                    //add to cache
-                    Util::Result result = pObj->StorePipelineBinary(&entry.hashId, entry.dataSize, pData);
+                    //add to cache, the digest entry is only used to validate the blob
+                    Util::Result result = Util::Result::Success;
+                    if (IsBinaryCacheDigestEntry(entry) == false)
+                    {
+                        result = pObj->StorePipelineBinary(&entry.hashId, entry.dataSize, pData);
+                    }
                     if (result != Util::Result::Success)
                     {
                         break;
@@ -189,6 +384,8 @@ PipelineBinaryCache::PipelineBinaryCache(
     m_palAllocator         { pAllocationCallbacks },
     m_pPlatformKey         { nullptr },
     m_pTopLayer            { nullptr },
+    m_logTagIdMask         { 0 },
+    m_digestChunkSize      { 0 },
 #if ICD_GPUOPEN_DEVMODE_BUILD
     m_pDevModeMgr          { nullptr },
     m_pReinjectionLayer    { nullptr },
@@ -196,10 +393,47 @@ PipelineBinaryCache::PipelineBinaryCache(
 #endif
     m_pMemoryLayer         { nullptr },
     m_expectedEntries      { expectedEntries },
+    m_memoryBudget         { SIZE_MAX },
+    m_memoryHits           { 0 },
+    m_backingHits          { 0 },
+    m_misses               { 0 },
+    m_memoryInserts        { 0 },
+    m_explicitEvictions    { 0 },
     m_pArchiveLayer        { nullptr },
     m_openFiles            { &m_palAllocator },
     m_archiveLayers        { &m_palAllocator },
-    m_pCacheAdapter        { nullptr }
+    m_pCacheAdapter        { nullptr },
+    m_pInitData            { nullptr },
+    m_initDataSize         { 0 },
+    m_initDataIndex        { expectedEntries, &m_palAllocator },
+    m_initDataPendingBytes { 0 },
+    m_initDataPending      { false },
+    m_pMappedArchive       { nullptr },
+    m_mappedArchiveSize    { 0 },
+    m_pMappedEntries       { nullptr },
+    m_mappedArchiveIndex   { 32, &m_palAllocator },
+    m_pMappedDigests       { nullptr },
+    m_mappedChunkSize      { 0 },
+    m_mappedChunkCount     { 0 },
+    m_mappedCoveredSize    { 0 },
+    m_pMappedChunkState    { nullptr },
+#if defined(__unix__)
+    m_mappedArchiveFd      { -1 },
+    m_mappedArchiveMtime   { 0 },
+#endif
+    m_mappedArchiveChanged { false },
+    m_writeBehind          { false },
+    m_writeBehindDelayMs   { 0 },
+    m_memoryStorePolicy    { 0 },
+    m_writeQueueStorage    { &m_palAllocator },
+    m_writeBatchStorage    { &m_palAllocator },
+    m_pWriteQueue          { &m_writeQueueStorage },
+    m_pWriteBatch          { &m_writeBatchStorage },
+    m_pendingWriteCount    { 0 },
+    m_pendingWriteBytes    { 0 },
+    m_archiveWrites        { 0 },
+    m_flushRequests        { 0 },
+    m_writerStop           { false }
 {
     // Without copy constructor, a class type variable can't be initialized in initialization list with gcc 4.8.5.
     // Initialize m_gfxIp here instead to make gcc 4.8.5 work.
@@ -209,12 +443,18 @@ PipelineBinaryCache::PipelineBinaryCache(
 // =====================================================================================================================
 PipelineBinaryCache::~PipelineBinaryCache()
 {
+    // Write out the queued entries while all layers are still alive.
+    StopArchiveWriter();
+
     if (m_pCacheAdapter != nullptr)
     {
         m_pCacheAdapter->Destroy();
         m_pCacheAdapter = nullptr;
     }
 
+    ReleaseInitData();
+    ReleaseMappedArchive();
+
     for (FileVector::Iter i = m_openFiles.Begin(); i.IsValid(); i.Next())
     {
         i.Get()->Destroy();
@@ -272,7 +512,8 @@ void PipelineBinaryCache::FreeMem(
 
 // =====================================================================================================================
 // Query if a pipeline binary exists in cache
-// Must call ReleaseCacheRef() when the flags contains AcquireEntryRef
+// Must call ReleaseCacheRef() when the flags contains AcquireEntryRef. Without AcquireEntryRef, an entry which is only
+// in the mapped read-only pipeline cache file is reported with a null pLayer, so it can't be loaded through the result.
 Util::Result PipelineBinaryCache::QueryPipelineBinary(
     const CacheId*     pCacheId,
     uint32_t           flags,
@@ -280,6 +521,14 @@ Util::Result PipelineBinaryCache::QueryPipelineBinary(
 {
     VK_ASSERT(m_pTopLayer != nullptr);
 
+    PromoteInitDataEntry(pCacheId);
+
+    // Entries which are pinned are read through their cache layer, so they have to be copied into the memory layer.
+    if (Util::TestAnyFlagSet(flags, Util::ICacheLayer::QueryFlags::AcquireEntryRef))
+    {
+        LoadMappedArchiveEntry(pCacheId);
+    }
+
     uint32_t policy = Util::ICacheLayer::LinkPolicy::LoadOnQuery;
     // We have to make sure the Query is atomic, otherwise we could get unexpected result while running multi-thread
     // test case.
@@ -287,6 +536,26 @@ Util::Result PipelineBinaryCache::QueryPipelineBinary(
     Util::Result result = m_pTopLayer->Query(pCacheId, policy, flags, pQuery);
     m_entriesMutex.Unlock();
 
+    size_t      mappedSize = 0;
+    const void* pMapped    = nullptr;
+
+    if ((result == Util::Result::NotFound) &&
+        (FindMappedArchiveEntry(pCacheId, &mappedSize, &pMapped) == Util::Result::Success))
+    {
+        // Without a cache layer to load from, the result only tells that the entry exists and how large it is.
+        *pQuery          = {};
+        pQuery->hashId   = *pCacheId;
+        pQuery->dataSize = mappedSize;
+
+        Util::AtomicIncrement64(&m_backingHits);
+
+        result = Util::Result::Success;
+    }
+    else
+    {
+        TrackLookup(result, pQuery, true);
+    }
+
     return result;
 }
 
@@ -301,18 +570,43 @@ Util::Result PipelineBinaryCache::WaitPipelineBinary(
     return m_pTopLayer->WaitForEntry(pCacheId);
 }
 // =====================================================================================================================
-// Attempt to load a graphics pipeline binary from cache
+// Attempt to load a graphics pipeline binary from cache. A binary within the mapped read-only pipeline cache file is
+// returned in place; *pIsMapped is set in that case, and the binary must not be freed.
 Util::Result PipelineBinaryCache::LoadPipelineBinary(
     const CacheId* pCacheId,
     size_t*        pPipelineBinarySize,
-    const void**   ppPipelineBinary) const
+    const void**   ppPipelineBinary,
+    bool*          pIsMapped) const
 {
     VK_ASSERT(m_pTopLayer != nullptr);
 
-    Util::QueryResult query  = {};
-    Util::Result      result = m_pTopLayer->Query(pCacheId, 0, 0, &query);
+    Util::QueryResult query    = {};
+    Util::Result      result   = Util::Result::NotFound;
+    bool              isMapped = false;
 
-    if (result == Util::Result::Success)
+    // Entries of the mapped read-only pipeline cache file are returned in place.
+    result   = FindMappedArchiveEntry(pCacheId, pPipelineBinarySize, ppPipelineBinary);
+    isMapped = (result == Util::Result::Success);
+
+    if (pIsMapped != nullptr)
+    {
+        *pIsMapped = isMapped;
+    }
+
+    if (isMapped)
+    {
+        Util::AtomicIncrement64(&m_backingHits);
+    }
+    else
+    {
+        PromoteInitDataEntry(pCacheId);
+
+        result = m_pTopLayer->Query(pCacheId, 0, 0, &query);
+
+        TrackLookup(result, &query, false);
+    }
+
+    if ((result == Util::Result::Success) && (isMapped == false))
     {
         void* pOutputMem = AllocMem(query.dataSize);
         if (pOutputMem != nullptr)
@@ -343,11 +637,662 @@ Util::Result PipelineBinaryCache::StorePipelineBinary(
 {
     VK_ASSERT(m_pTopLayer != nullptr);
 
+    // The stored binary supersedes any copy of it in the initial data.
+    DropInitDataEntry(pCacheId);
+
     Util::StoreFlags storeFlags  = {};
     storeFlags.enableFileCache   = true;
     storeFlags.enableCompression = true;
 
-    return m_pTopLayer->Store(storeFlags, pCacheId, pPipelineBinary, pipelineBinarySize);
+    Util::Result result = m_pTopLayer->Store(storeFlags, pCacheId, pPipelineBinary, pipelineBinarySize);
+
+    if (result == Util::Result::Success)
+    {
+        Util::AtomicIncrement64(&m_memoryInserts);
+
+        // With write-behind enabled the store above stops at the memory layer.
+        if (m_writeBehind && (QueueArchiveWrite(pCacheId) != Util::Result::Success))
+        {
+            result = m_pArchiveLayer->Store(storeFlags, pCacheId, pPipelineBinary, pipelineBinarySize);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Updates the memory layer statistics after a lookup through the cache chain. If the lookup promotes entries, an entry
+// served by an archive layer has been added to the memory layer as well.
+void PipelineBinaryCache::TrackLookup(
+    Util::Result             result,
+    const Util::QueryResult* pQuery,
+    bool                     promoted) const
+{
+    if (result == Util::Result::Success)
+    {
+        if (pQuery->pLayer == m_pMemoryLayer)
+        {
+            Util::AtomicIncrement64(&m_memoryHits);
+        }
+        else
+        {
+            Util::AtomicIncrement64(&m_backingHits);
+
+            if (promoted && (m_pMemoryLayer != nullptr))
+            {
+                Util::AtomicIncrement64(&m_memoryInserts);
+            }
+        }
+    }
+    else if ((result == Util::Result::NotFound) || (result == Util::Result::Reserved))
+    {
+        Util::AtomicIncrement64(&m_misses);
+    }
+}
+
+// =====================================================================================================================
+// Returns the memory layer statistics. Evictions are derived from the number of entries added to and explicitly removed
+// from the memory layer, since the layer evicts entries on its own.
+void PipelineBinaryCache::GetMemoryLayerStats(
+    MemoryLayerStats* pStats) const
+{
+    VK_ASSERT(pStats != nullptr);
+
+    *pStats        = {};
+    pStats->budget = m_memoryBudget;
+
+    if (m_pMemoryLayer != nullptr)
+    {
+        Util::GetMemoryCacheLayerCurSize(m_pMemoryLayer, &pStats->curCount, &pStats->curDataSize);
+    }
+
+    pStats->hits          = m_memoryHits;
+    pStats->backingHits   = m_backingHits;
+    pStats->misses        = m_misses;
+    pStats->pendingWrites = m_pendingWriteBytes;
+    pStats->archiveWrites = m_archiveWrites;
+
+    const uint64_t removed = static_cast<uint64_t>(pStats->curCount) + m_explicitEvictions;
+    pStats->evictions      = (m_memoryInserts > removed) ? (m_memoryInserts - removed) : 0;
+}
+
+// =====================================================================================================================
+// Builds a cache ID to entry index over the entries of a serialized blob, excluding its private header. The total size
+// of the indexed pipeline binaries is added to pIndexedBytes. The first entry wins if a cache ID appears twice.
+VkResult PipelineBinaryCache::BuildBlobIndex(
+    const void* pBlob,
+    size_t      blobSize,
+    BlobIndex*  pIndex,
+    size_t*     pIndexedBytes)
+{
+    constexpr size_t EntrySize = sizeof(BinaryCacheEntry);
+
+    VkResult result = PalToVkResult(pIndex->Init());
+
+    size_t offset = 0;
+    while ((result == VK_SUCCESS) && ((blobSize - offset) > EntrySize))
+    {
+        // Entry headers are not guaranteed to be 8 byte aligned in the blob, see PipelineBinaryCache::Create.
+        BinaryCacheEntry entry;
+        memcpy(&entry, Util::VoidPtrInc(pBlob, offset), EntrySize);
+
+        if (IsBinaryCacheDigestEntry(entry))
+        {
+            // The digest entry is only used to validate the blob.
+            offset += EntrySize + Util::Min(entry.dataSize, blobSize - offset - EntrySize);
+        }
+        else if (entry.dataSize <= (blobSize - offset - EntrySize))
+        {
+            bool       existed = false;
+            BlobEntry* pValue  = nullptr;
+
+            result = PalToVkResult(pIndex->FindAllocate(entry.hashId, &existed, &pValue));
+            if ((result == VK_SUCCESS) && (existed == false))
+            {
+                pValue->offset   = offset + EntrySize;
+                pValue->dataSize = entry.dataSize;
+                *pIndexedBytes   += entry.dataSize;
+            }
+
+            offset += EntrySize + entry.dataSize;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Takes a private copy of the pipeline cache initial data and builds a cache ID to entry index over it. No entry is
+// added to the cache chain here; that happens on the first lookup of each entry (see PromoteInitDataEntry). The copy
+// shrinks as its entries are promoted (see CompactInitData).
+VkResult PipelineBinaryCache::InitLazyInitData(
+    size_t      initDataSize,
+    const void* pInitData)
+{
+    VK_ASSERT(initDataSize > sizeof(PipelineBinaryCachePrivateHeader));
+
+    VkResult     result   = VK_ERROR_OUT_OF_HOST_MEMORY;
+    const size_t blobSize = initDataSize - sizeof(PipelineBinaryCachePrivateHeader);
+
+    Util::MutexAuto lock(&m_initDataMutex);
+
+    m_pInitData = AllocMem(blobSize);
+
+    if (m_pInitData != nullptr)
+    {
+        m_initDataSize = blobSize;
+
+        memcpy(m_pInitData, Util::VoidPtrInc(pInitData, sizeof(PipelineBinaryCachePrivateHeader)), blobSize);
+
+        result = BuildBlobIndex(m_pInitData, blobSize, &m_initDataIndex, &m_initDataPendingBytes);
+    }
+
+    if ((result == VK_SUCCESS) && (m_initDataIndex.GetNumEntries() > 0))
+    {
+        m_initDataPending = true;
+    }
+    else
+    {
+        ReleaseInitData();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Adds the initial data entry of the given cache ID, if it hasn't been added yet, to the cache chain. Returns NotFound
+// if there is no such pending entry.
+Util::Result PipelineBinaryCache::PromoteInitDataEntry(
+    const CacheId* pCacheId) const
+{
+    Util::Result result = Util::Result::NotFound;
+
+    if (m_initDataPending)
+    {
+        Util::MutexAuto lock(&m_initDataMutex);
+
+        const BlobEntry* pEntry = m_initDataIndex.FindKey(*pCacheId);
+
+        if (pEntry != nullptr)
+        {
+            Util::StoreFlags storeFlags  = {};
+            storeFlags.enableFileCache   = true;
+            storeFlags.enableCompression = true;
+
+            result = m_pTopLayer->Store(storeFlags,
+                                        pCacheId,
+                                        Util::VoidPtrInc(m_pInitData, pEntry->offset),
+                                        pEntry->dataSize);
+
+            if (result == Util::Result::Success)
+            {
+                Util::AtomicIncrement64(&m_memoryInserts);
+            }
+
+            m_initDataPendingBytes -= pEntry->dataSize;
+            m_initDataIndex.Erase(*pCacheId);
+
+            if (m_initDataIndex.GetNumEntries() == 0)
+            {
+                ReleaseInitData();
+            }
+            else if ((m_initDataPendingBytes * 2) < m_initDataSize)
+            {
+                CompactInitData();
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Adds all pending initial data entries to the cache chain.
+Util::Result PipelineBinaryCache::PromoteAllInitData() const
+{
+    Util::Result result = Util::Result::Success;
+
+    if (m_initDataPending)
+    {
+        Util::MutexAuto lock(&m_initDataMutex);
+
+        Util::StoreFlags storeFlags  = {};
+        storeFlags.enableFileCache   = true;
+        storeFlags.enableCompression = true;
+
+        for (auto it = m_initDataIndex.Begin(); (it.Get() != nullptr) && (result == Util::Result::Success); it.Next())
+        {
+            result = m_pTopLayer->Store(storeFlags,
+                                        &it.Get()->key,
+                                        Util::VoidPtrInc(m_pInitData, it.Get()->value.offset),
+                                        it.Get()->value.dataSize);
+
+            if (result == Util::Result::Success)
+            {
+                Util::AtomicIncrement64(&m_memoryInserts);
+            }
+            else if (result == Util::Result::AlreadyExists)
+            {
+                result = Util::Result::Success;
+            }
+        }
+
+        if (result == Util::Result::Success)
+        {
+            ReleaseInitData();
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Forgets the initial data entry of the given cache ID, if there is one.
+void PipelineBinaryCache::DropInitDataEntry(
+    const CacheId* pCacheId)
+{
+    if (m_initDataPending)
+    {
+        Util::MutexAuto lock(&m_initDataMutex);
+
+        const BlobEntry* pEntry = m_initDataIndex.FindKey(*pCacheId);
+
+        if (pEntry != nullptr)
+        {
+            m_initDataPendingBytes -= pEntry->dataSize;
+            m_initDataIndex.Erase(*pCacheId);
+
+            if (m_initDataIndex.GetNumEntries() == 0)
+            {
+                ReleaseInitData();
+            }
+            else if ((m_initDataPendingBytes * 2) < m_initDataSize)
+            {
+                CompactInitData();
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+// Moves the pending initial data entries into a new private copy which only holds them, so that entries which have
+// been promoted to the cache chain or dropped don't stay resident twice. Called once the pending entries take up less
+// than half of the current copy, which bounds the memory held for promoted entries by the size of the pending ones.
+// Keeps the current copy if the new one can't be allocated. Must be called with m_initDataMutex held.
+void PipelineBinaryCache::CompactInitData() const
+{
+    void* pCompactData = AllocMem(m_initDataPendingBytes);
+
+    if (pCompactData != nullptr)
+    {
+        size_t offset = 0;
+
+        for (auto it = m_initDataIndex.Begin(); it.Get() != nullptr; it.Next())
+        {
+            BlobEntry* pEntry = &it.Get()->value;
+
+            memcpy(Util::VoidPtrInc(pCompactData, offset),
+                   Util::VoidPtrInc(m_pInitData, pEntry->offset),
+                   pEntry->dataSize);
+
+            pEntry->offset  = offset;
+            offset         += pEntry->dataSize;
+        }
+
+        VK_ASSERT(offset == m_initDataPendingBytes);
+
+        FreeMem(m_pInitData);
+
+        m_pInitData    = pCompactData;
+        m_initDataSize = m_initDataPendingBytes;
+    }
+}
+
+// =====================================================================================================================
+// Frees the private copy of the initial data along with its index. Must be called with m_initDataMutex held, or from
+// the destructor.
+void PipelineBinaryCache::ReleaseInitData() const
+{
+    m_initDataPending = false;
+
+    if (m_initDataIndex.GetNumEntries() > 0)
+    {
+        m_initDataIndex.Reset();
+    }
+
+    m_initDataPendingBytes = 0;
+
+    FreeMem(m_pInitData);
+    m_pInitData    = nullptr;
+    m_initDataSize = 0;
+}
+
+// =====================================================================================================================
+// Maps a read-only pipeline cache file, as written by vkGetPipelineCacheData or the cache creator tool, into memory and
+// builds a cache ID to entry index over it. The mapped pages are shared with every other process using the same file
+// and LoadPipelineBinary returns entries from them without a copy. If the blob has chunk digests, only the digest entry
+// is validated here; the chunks are validated as entries within them are looked up (see ValidateMappedArchiveRange).
+// Returns false if the file doesn't exist or isn't a valid pipeline cache blob for this device, e.g. because it is a
+// .parc archive.
+bool PipelineBinaryCache::OpenMappedArchive(
+    const char* pFilePath,
+    const char* pFileName)
+{
+    VK_ASSERT(pFileName != nullptr);
+
+    bool mapped = false;
+
+#if defined(__unix__)
+    char pathBuffer[Util::PathBufferLen] = {};
+
+    if ((pFilePath != nullptr) &&
+        (Util::Snprintf(pathBuffer, sizeof(pathBuffer), "%s/%s", pFilePath, pFileName) > 0))
+    {
+        const int fd = open(pathBuffer, O_RDONLY | O_CLOEXEC);
+
+        if (fd >= 0)
+        {
+            struct stat fileStat = {};
+
+            if ((fstat(fd, &fileStat) == 0) &&
+                (static_cast<size_t>(fileStat.st_size) > (sizeof(PipelineCacheHeaderData) +
+                                                          sizeof(PipelineBinaryCachePrivateHeader))))
+            {
+                // Unmodified pages of a private mapping are still shared with the page cache, and thus with other
+                // processes mapping the same file.
+                const size_t fileSize = static_cast<size_t>(fileStat.st_size);
+                void*        pMapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (pMapping != MAP_FAILED)
+                {
+                    m_pMappedArchive     = pMapping;
+                    m_mappedArchiveSize  = fileSize;
+                    m_mappedArchiveFd    = fd;
+                    m_mappedArchiveMtime = (fileStat.st_mtim.tv_sec * 1000000000ll) + fileStat.st_mtim.tv_nsec;
+                }
+            }
+
+            // The descriptor is kept open to check the file for changes, see IsMappedArchiveIntact.
+            if (m_pMappedArchive == nullptr)
+            {
+                close(fd);
+            }
+        }
+    }
+
+    if (m_pMappedArchive != nullptr)
+    {
+        const auto*  pHeader        = static_cast<const PipelineCacheHeaderData*>(m_pMappedArchive);
+        const void*  pData          = Util::VoidPtrInc(m_pMappedArchive, sizeof(PipelineCacheHeaderData));
+        const size_t dataSize       = m_mappedArchiveSize - sizeof(PipelineCacheHeaderData);
+        const auto*  pPrivateHeader = static_cast<const PipelineBinaryCachePrivateHeader*>(pData);
+        const void*  pBlob          = Util::VoidPtrInc(pData, sizeof(PipelineBinaryCachePrivateHeader));
+        const size_t blobSize       = dataSize - sizeof(PipelineBinaryCachePrivateHeader);
+
+        bool isValid = false;
+
+        if ((pHeader->headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE) &&
+            (pHeader->headerLength  == sizeof(PipelineCacheHeaderData)))
+        {
+            BinaryCacheDigestInfo digestInfo = {};
+
+            if (ReadBinaryCacheDigestInfo(pBlob, blobSize, &digestInfo))
+            {
+                // The private header hash only covers the digest entry. The platform key is part of the hash, so a
+                // file written for another device fails here.
+                uint8_t hashId[SHA_DIGEST_LENGTH];
+
+                isValid = (CalculatePipelineBinaryCacheHashId(m_pAllocationCallbacks,
+                                                              m_pPlatformKey,
+                                                              Util::VoidPtrInc(pBlob, digestInfo.coveredSize),
+                                                              blobSize - digestInfo.coveredSize,
+                                                              hashId) == Util::Result::Success) &&
+                          (memcmp(hashId, pPrivateHeader->hashId, SHA_DIGEST_LENGTH) == 0);
+
+                if (isValid)
+                {
+                    const size_t stateSize = digestInfo.chunkCount * sizeof(uint32_t);
+
+                    m_pMappedChunkState = static_cast<volatile uint32_t*>(
+                        m_pAllocationCallbacks->pfnAllocation(m_pAllocationCallbacks->pUserData,
+                                                              stateSize,
+                                                              VK_DEFAULT_MEM_ALIGN,
+                                                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+
+                    isValid = (m_pMappedChunkState != nullptr);
+                }
+
+                if (isValid)
+                {
+                    memset(const_cast<uint32_t*>(m_pMappedChunkState), 0, digestInfo.chunkCount * sizeof(uint32_t));
+
+                    m_pMappedDigests    = digestInfo.pDigests;
+                    m_mappedChunkSize   = digestInfo.chunkSize;
+                    m_mappedChunkCount  = digestInfo.chunkCount;
+                    m_mappedCoveredSize = digestInfo.coveredSize;
+                }
+            }
+            else
+            {
+                // Blobs without chunk digests can only be validated as a whole.
+                isValid = IsValidBlob(m_pAllocationCallbacks, m_pPlatformKey, dataSize, pData, nullptr);
+            }
+        }
+
+        if (isValid)
+        {
+            size_t indexedBytes = 0;
+
+            m_pMappedEntries = pBlob;
+
+            mapped = (BuildBlobIndex(pBlob, blobSize, &m_mappedArchiveIndex, &indexedBytes) == VK_SUCCESS) &&
+                     (m_mappedArchiveIndex.GetNumEntries() > 0);
+        }
+
+        if (mapped == false)
+        {
+            ReleaseMappedArchive();
+        }
+    }
+#endif
+
+    return mapped;
+}
+
+// Validation state of a digest chunk of the mapped read-only pipeline cache file
+enum MappedChunkState : uint32_t
+{
+    MappedChunkUnchecked = 0,
+    MappedChunkValid,
+    MappedChunkCorrupt
+};
+
+// =====================================================================================================================
+// Checks the digest chunks covering the given range of the mapped blob, unless they have been checked already. Two
+// threads may check the same chunk at the same time; both reach the same result.
+bool PipelineBinaryCache::ValidateMappedArchiveRange(
+    size_t offset,
+    size_t size) const
+{
+    bool isValid = true;
+
+    // Anything past the covered data belongs to the digest entry, which was validated in OpenMappedArchive.
+    if ((m_pMappedDigests != nullptr) && (offset < m_mappedCoveredSize))
+    {
+        size = Util::Min(size, m_mappedCoveredSize - offset);
+
+        const size_t firstChunk = offset / m_mappedChunkSize;
+        const size_t lastChunk  = (offset + size - 1) / m_mappedChunkSize;
+
+        for (size_t chunk = firstChunk; isValid && (chunk <= lastChunk); ++chunk)
+        {
+            if (m_pMappedChunkState[chunk] == MappedChunkUnchecked)
+            {
+                const size_t chunkOffset = chunk * m_mappedChunkSize;
+                uint8_t      hashId[SHA_DIGEST_LENGTH];
+
+                const bool chunkValid =
+                    (CalculatePipelineBinaryCacheHashId(m_pAllocationCallbacks,
+                                                        m_pPlatformKey,
+                                                        Util::VoidPtrInc(m_pMappedEntries, chunkOffset),
+                                                        Util::Min(m_mappedChunkSize, m_mappedCoveredSize - chunkOffset),
+                                                        hashId) == Util::Result::Success) &&
+                    (memcmp(hashId, &m_pMappedDigests[chunk * SHA_DIGEST_LENGTH], SHA_DIGEST_LENGTH) == 0);
+
+                m_pMappedChunkState[chunk] = chunkValid ? MappedChunkValid : MappedChunkCorrupt;
+            }
+
+            isValid = (m_pMappedChunkState[chunk] == MappedChunkValid);
+        }
+    }
+
+    return isValid;
+}
+
+// =====================================================================================================================
+// Checks that the mapped read-only pipeline cache file hasn't been truncated or rewritten in place since it was mapped.
+// Pages beyond the end of a truncated file raise SIGBUS when they are touched, and rewritten pages no longer match the
+// validated data, so the mapping is no longer used once the file has changed. Files which are replaced through a rename
+// keep their mapping intact.
+bool PipelineBinaryCache::IsMappedArchiveIntact() const
+{
+    bool isIntact = (m_mappedArchiveChanged == false);
+
+#if defined(__unix__)
+    if (isIntact)
+    {
+        struct stat fileStat = {};
+
+        isIntact = (fstat(m_mappedArchiveFd, &fileStat) == 0)                     &&
+                   (static_cast<size_t>(fileStat.st_size) == m_mappedArchiveSize) &&
+                   (((fileStat.st_mtim.tv_sec * 1000000000ll) + fileStat.st_mtim.tv_nsec) == m_mappedArchiveMtime);
+
+        if (isIntact == false)
+        {
+            m_mappedArchiveChanged = true;
+        }
+    }
+#endif
+
+    return isIntact;
+}
+
+// =====================================================================================================================
+// Returns a pointer to the pipeline binary of the given cache ID within the mapped read-only pipeline cache file. The
+// pointer stays valid for the lifetime of the cache. Returns NotFound if the file has no such entry, or if the chunks
+// holding it are corrupted.
+Util::Result PipelineBinaryCache::FindMappedArchiveEntry(
+    const CacheId* pCacheId,
+    size_t*        pPipelineBinarySize,
+    const void**   ppPipelineBinary) const
+{
+    Util::Result result = Util::Result::NotFound;
+
+    if (m_pMappedArchive != nullptr)
+    {
+        const BlobEntry* pEntry = m_mappedArchiveIndex.FindKey(*pCacheId);
+
+        // The entry header is validated along with the pipeline binary.
+        if ((pEntry != nullptr)      &&
+            IsMappedArchiveIntact()  &&
+            ValidateMappedArchiveRange(pEntry->offset - sizeof(BinaryCacheEntry),
+                                       pEntry->dataSize + sizeof(BinaryCacheEntry)))
+        {
+            *pPipelineBinarySize = pEntry->dataSize;
+            *ppPipelineBinary    = Util::VoidPtrInc(m_pMappedEntries, pEntry->offset);
+
+            result = Util::Result::Success;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Copies the entry of the given cache ID from the mapped read-only pipeline cache file into the memory layer, unless
+// the memory layer already holds it. This is only needed for QueryPipelineBinary lookups which pin the entry, i.e.
+// those of the compiler cache interface, whose results must refer to a cache layer. Returns NotFound if the file has
+// no such entry.
+Util::Result PipelineBinaryCache::LoadMappedArchiveEntry(
+    const CacheId* pCacheId) const
+{
+    Util::Result result = Util::Result::NotFound;
+
+    if ((m_pMappedArchive != nullptr) && (m_pMemoryLayer != nullptr) &&
+        (m_mappedArchiveIndex.FindKey(*pCacheId) != nullptr))
+    {
+        Util::QueryResult query = {};
+
+        result = m_pMemoryLayer->Query(pCacheId, 0, 0, &query);
+
+        if (result == Util::Result::NotFound)
+        {
+            size_t      binarySize = 0;
+            const void* pBinary    = nullptr;
+
+            result = FindMappedArchiveEntry(pCacheId, &binarySize, &pBinary);
+
+            if (result == Util::Result::Success)
+            {
+                // The entry is already backed by a file, so don't write it to the archive layers again.
+                Util::StoreFlags storeFlags = {};
+
+                result = m_pMemoryLayer->Store(storeFlags, pCacheId, pBinary, binarySize);
+            }
+
+            if (result == Util::Result::Success)
+            {
+                Util::AtomicIncrement64(&m_memoryInserts);
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Unmaps the read-only pipeline cache file.
+void PipelineBinaryCache::ReleaseMappedArchive()
+{
+    if (m_mappedArchiveIndex.GetNumEntries() > 0)
+    {
+        m_mappedArchiveIndex.Reset();
+    }
+
+    if (m_pMappedChunkState != nullptr)
+    {
+        m_pAllocationCallbacks->pfnFree(m_pAllocationCallbacks->pUserData, const_cast<uint32_t*>(m_pMappedChunkState));
+    }
+
+#if defined(__unix__)
+    if (m_pMappedArchive != nullptr)
+    {
+        munmap(m_pMappedArchive, m_mappedArchiveSize);
+    }
+
+    if (m_mappedArchiveFd >= 0)
+    {
+        close(m_mappedArchiveFd);
+    }
+
+    m_mappedArchiveFd    = -1;
+    m_mappedArchiveMtime = 0;
+#endif
+
+    m_pMappedArchive    = nullptr;
+    m_mappedArchiveSize = 0;
+    m_pMappedEntries    = nullptr;
+    m_pMappedDigests    = nullptr;
+    m_mappedChunkSize   = 0;
+    m_mappedChunkCount  = 0;
+    m_mappedCoveredSize = 0;
+    m_pMappedChunkState = nullptr;
+
+    m_mappedArchiveChanged = false;
 }
 
 // =====================================================================================================================
@@ -373,7 +1318,14 @@ Util::Result PipelineBinaryCache::EvictEntry(
 {
     VK_ASSERT(m_pTopLayer != nullptr);
 
-    return m_pTopLayer->Evict(&pQuery->hashId);
+    Util::Result result = m_pTopLayer->Evict(&pQuery->hashId);
+
+    if (result == Util::Result::Success)
+    {
+        Util::AtomicIncrement64(&m_explicitEvictions);
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -382,7 +1334,14 @@ Util::Result PipelineBinaryCache::MarkEntryBad(
 {
     VK_ASSERT(m_pTopLayer != nullptr);
 
-    return m_pTopLayer->MarkEntryBad(&pQuery->hashId);
+    Util::Result result = m_pTopLayer->MarkEntryBad(&pQuery->hashId);
+
+    if (result == Util::Result::Success)
+    {
+        Util::AtomicIncrement64(&m_explicitEvictions);
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -542,6 +1501,9 @@ VkResult PipelineBinaryCache::Initialize(
 {
     VkResult result = VK_SUCCESS;
 
+    m_logTagIdMask    = settings.logTagIdMask;
+    m_digestChunkSize = settings.pipelineBinaryCacheDigestChunkSize;
+
     if (pKey != nullptr)
     {
         m_pPlatformKey = pKey;
@@ -561,6 +1523,11 @@ VkResult PipelineBinaryCache::Initialize(
         result = OrderLayers(settings);
     }
 
+    if ((result == VK_SUCCESS) && createArchiveLayers)
+    {
+        StartArchiveWriter(settings);
+    }
+
 #if ICD_GPUOPEN_DEVMODE_BUILD
     if ((result == VK_SUCCESS) &&
         (m_pReinjectionLayer != nullptr))
@@ -791,7 +1758,8 @@ Util::Result PipelineBinaryCache::InjectBinariesFromDirectory(
 // =====================================================================================================================
 // Initialize memory layer
 VkResult PipelineBinaryCache::InitMemoryCacheLayer(
-    const RuntimeSettings& settings)
+    const RuntimeSettings& settings,
+    bool                   hasBackingLayers)
 {
     VK_ASSERT(m_pMemoryLayer == nullptr);
 
@@ -804,13 +1772,19 @@ VkResult PipelineBinaryCache::InitMemoryCacheLayer(
     createInfo.baseInfo.pCallbacks = &allocCallbacks;
     createInfo.maxObjectCount      = SIZE_MAX;
 
+    // The memory layer of a cache which is backed by archive layers may be limited to a byte budget. Least recently
+    // used entries are evicted once it is exceeded and reloaded from the archives on demand.
+    if (hasBackingLayers && (settings.pipelineBinaryCacheMemoryBudget > 0))
+    {
+        m_memoryBudget = static_cast<size_t>(Util::Min<uint64_t>(settings.pipelineBinaryCacheMemoryBudget, SIZE_MAX));
+    }
+
     // Reason: CTS generates a large number of cache applications and cause insufficient memory in 32-bit system.
     // Purpose: To limit the maximun value of MemorySize in 32-bit system.
 #ifdef ICD_X86_BUILD
-    createInfo.maxMemorySize       = 192 * 1024 * 1024;
-#else
-    createInfo.maxMemorySize       = SIZE_MAX;
+    m_memoryBudget                 = Util::Min<size_t>(m_memoryBudget, 192 * 1024 * 1024);
 #endif
+    createInfo.maxMemorySize       = m_memoryBudget;
 
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 711
     createInfo.expectedEntries     = m_expectedEntries;
@@ -1055,7 +2029,8 @@ VkResult PipelineBinaryCache::InitArchiveLayers(
         const char* const  pThirdPartyFileName = getenv(EnvVarReadOnlyFileName);
         Util::ICacheLayer* pThirdPartyLayer    = nullptr;
 
-        if (pThirdPartyFileName != nullptr)
+        // A pipeline cache blob is mapped directly, anything else is opened as an archive.
+        if ((pThirdPartyFileName != nullptr) && (OpenMappedArchive(pCachePath, pThirdPartyFileName) == false))
         {
             Util::IArchiveFile* pFile = OpenReadOnlyArchive(pCachePath, pThirdPartyFileName, PrimaryLayerBufferSize);
 
@@ -1215,7 +2190,7 @@ VkResult PipelineBinaryCache::InitLayers(
     bool injectionLayerOnline = false;
 #endif
 
-    bool memoryLayerOnline = (InitMemoryCacheLayer(settings) >= VK_SUCCESS);
+    bool memoryLayerOnline = (InitMemoryCacheLayer(settings, createArchiveLayers) >= VK_SUCCESS);
 
     bool archiveLayerOnline = createArchiveLayers && (InitArchiveLayers(pDefaultCacheFilePath, settings) >= VK_SUCCESS);
 
@@ -1282,6 +2257,261 @@ VkResult PipelineBinaryCache::OrderLayers(
     return result;
 }
 
+// =====================================================================================================================
+// Starts the thread which writes stored entries to the archive layers in the background. From then on the memory layer
+// no longer passes stores on to the archive layers; StorePipelineBinary queues them for the writer thread instead.
+void PipelineBinaryCache::StartArchiveWriter(
+    const RuntimeSettings& settings)
+{
+    VK_ASSERT(m_writeBehind == false);
+
+    if (settings.pipelineBinaryCacheWriteBehind &&
+        (m_pArchiveLayer != nullptr)            &&
+        (m_pMemoryLayer  != nullptr)            &&
+        (m_pTopLayer     == m_pMemoryLayer))
+    {
+        m_writeBehindDelayMs = settings.pipelineBinaryCacheWriteBehindDelay;
+
+        if (m_archiveWriter.Begin(ArchiveWriterFunc, this) == Util::Result::Success)
+        {
+            m_memoryStorePolicy = m_pMemoryLayer->GetStorePolicy();
+            m_pMemoryLayer->SetStorePolicy(0);
+            m_writeBehind = true;
+        }
+    }
+}
+
+// =====================================================================================================================
+// Lets the writer thread write all queued entries, waits for it to exit and restores the store policy of the memory
+// layer.
+void PipelineBinaryCache::StopArchiveWriter()
+{
+    if (m_writeBehind)
+    {
+        {
+            Util::MutexAuto lock(&m_writeQueueLock);
+            m_writerStop = true;
+            m_writeCondition.WakeOne();
+        }
+
+        m_archiveWriter.Join();
+        m_writeBehind = false;
+
+        // Stores from here on go straight through to the archive layers again.
+        m_pMemoryLayer->SetStorePolicy(m_memoryStorePolicy);
+
+        VK_ASSERT(m_pendingWriteCount == 0);
+    }
+}
+
+// =====================================================================================================================
+// Returns once all entries stored so far have been written to the archive layers.
+void PipelineBinaryCache::FlushArchiveWrites()
+{
+    if (m_writeBehind)
+    {
+        Util::MutexAuto lock(&m_writeQueueLock);
+
+        // Cuts the batching delay of the writer thread short.
+        m_flushRequests++;
+        m_writeCondition.WakeOne();
+
+        while (m_pendingWriteCount != 0)
+        {
+            m_flushCondition.Wait(&m_writeQueueLock, WriteBehindWaitTimeoutMs);
+        }
+
+        m_flushRequests--;
+    }
+}
+
+// =====================================================================================================================
+// Pins the memory layer entry of the given cache ID and queues it for the writer thread. Fails if the entry has
+// already left the memory layer, in which case the caller has to write it to the archive layers itself.
+Util::Result PipelineBinaryCache::QueueArchiveWrite(
+    const CacheId* pCacheId)
+{
+    Util::QueryResult query  = {};
+    Util::Result      result = m_pMemoryLayer->Query(pCacheId,
+                                                     0,
+                                                     Util::ICacheLayer::QueryFlags::AcquireEntryRef,
+                                                     &query);
+
+    if (result == Util::Result::Success)
+    {
+        if (query.pLayer == m_pMemoryLayer)
+        {
+            Util::MutexAuto lock(&m_writeQueueLock);
+
+            result = m_pWriteQueue->PushBack(query);
+
+            if (result == Util::Result::Success)
+            {
+                m_pendingWriteCount++;
+                m_pendingWriteBytes += query.dataSize;
+
+                // The writer only sleeps on an empty queue.
+                if (m_pWriteQueue->NumElements() == 1)
+                {
+                    m_writeCondition.WakeOne();
+                }
+            }
+        }
+        else
+        {
+            result = Util::Result::NotFound;
+        }
+
+        if (result != Util::Result::Success)
+        {
+            query.pLayer->ReleaseCacheRef(&query);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+void PipelineBinaryCache::ArchiveWriterFunc(
+    void* pParam)
+{
+    static_cast<PipelineBinaryCache*>(pParam)->RunArchiveWriter();
+}
+
+// =====================================================================================================================
+// Main loop of the writer thread. Entries which are queued within the batching delay of the first one are written as a
+// single batch, without holding the queue lock, so storing threads never wait for file I/O.
+void PipelineBinaryCache::RunArchiveWriter()
+{
+    bool done = false;
+
+    while (done == false)
+    {
+        {
+            Util::MutexAuto lock(&m_writeQueueLock);
+
+            while (m_pWriteQueue->IsEmpty() && (m_writerStop == false))
+            {
+                m_writeCondition.Wait(&m_writeQueueLock, WriteBehindWaitTimeoutMs);
+            }
+
+            if ((m_pWriteQueue->IsEmpty() == false) &&
+                (m_writerStop == false)             &&
+                (m_flushRequests == 0)              &&
+                (m_writeBehindDelayMs > 0))
+            {
+                m_writeCondition.Wait(&m_writeQueueLock, m_writeBehindDelayMs);
+            }
+
+            done = m_pWriteQueue->IsEmpty();
+
+            WriteQueue* pBatch = m_pWriteQueue;
+            m_pWriteQueue      = m_pWriteBatch;
+            m_pWriteBatch      = pBatch;
+        }
+
+        if (done == false)
+        {
+            WriteArchiveBatch(*m_pWriteBatch);
+
+            Util::MutexAuto lock(&m_writeQueueLock);
+
+            uint64_t batchBytes = 0;
+
+            for (uint32_t i = 0; i < m_pWriteBatch->NumElements(); ++i)
+            {
+                batchBytes += m_pWriteBatch->At(i).dataSize;
+            }
+
+            m_pendingWriteCount -= m_pWriteBatch->NumElements();
+            m_pendingWriteBytes -= batchBytes;
+            m_pWriteBatch->Clear();
+
+            if (m_pendingWriteCount == 0)
+            {
+                m_flushCondition.WakeAll();
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+// Writes a batch of pinned memory layer entries to the archive layers and releases the pins.
+void PipelineBinaryCache::WriteArchiveBatch(
+    const WriteQueue& batch)
+{
+    const int64_t startTime  = Util::GetPerfCpuTime();
+    uint64_t      batchBytes = 0;
+
+    Util::StoreFlags storeFlags  = {};
+    storeFlags.enableFileCache   = true;
+    storeFlags.enableCompression = true;
+
+    for (uint32_t i = 0; i < batch.NumElements(); ++i)
+    {
+        Util::QueryResult query = batch.At(i);
+        const void*       pData = nullptr;
+
+        if ((m_pMemoryLayer->GetCacheData(&query, &pData) == Util::Result::Success) &&
+            (m_pArchiveLayer->Store(storeFlags, &query.hashId, pData, query.dataSize) == Util::Result::Success))
+        {
+            batchBytes += query.dataSize;
+            Util::AtomicIncrement64(&m_archiveWrites);
+        }
+
+        m_pMemoryLayer->ReleaseCacheRef(&query);
+    }
+
+    AmdvlkLog(m_logTagIdMask,
+              PipelineCacheTime,
+              "ArchiveWrite-%u-%llu-%llu",
+              batch.NumElements(),
+              static_cast<unsigned long long>(batchBytes),
+              static_cast<unsigned long long>(utils::TicksToNano(Util::GetPerfCpuTime() - startTime)));
+}
+
+// =====================================================================================================================
+// Streams a single memory layer entry into the serializer without an intermediate copy. The entry is pinned with a
+// cache reference while its data is being copied, so a concurrent eviction can't free it underneath us.
+Util::Result PipelineBinaryCache::SerializeEntry(
+    PipelineBinaryCacheSerializer* pSerializer,
+    const CacheId*                  pCacheId)
+{
+    Util::QueryResult query  = {};
+    Util::Result      result = m_pMemoryLayer->Query(pCacheId,
+                                                     0,
+                                                     Util::ICacheLayer::QueryFlags::AcquireEntryRef,
+                                                     &query);
+
+    if (result == Util::Result::Success)
+    {
+        const void* pData = nullptr;
+
+        result = m_pMemoryLayer->GetCacheData(&query, &pData);
+        if (result == Util::Result::Success)
+        {
+            BinaryCacheEntry entry = { *pCacheId, query.dataSize };
+
+            result = pSerializer->AddPipelineBinary(&entry, pData);
+        }
+
+        m_pMemoryLayer->ReleaseCacheRef(&query);
+    }
+    else if (result == Util::Result::NotReady)
+    {
+        // The entry is still being populated by another thread. It has no data to serialize yet, so skip it.
+        m_pMemoryLayer->ReleaseCacheRef(&query);
+        result = Util::Result::Success;
+    }
+    else if (result == Util::Result::NotFound)
+    {
+        // The entry was evicted after the hash IDs were gathered.
+        result = Util::Result::Success;
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Copies the pipeline cache data to the memory blob provided by the calling function.
 //
@@ -1299,40 +2529,82 @@ VkResult PipelineBinaryCache::Serialize(
         {
             size_t curCount, curDataSize;
 
+            Util::MutexAuto initDataLock(&m_initDataMutex);
+
             result = PalToVkResult(Util::GetMemoryCacheLayerCurSize(m_pMemoryLayer, &curCount, &curDataSize));
             if (result == VK_SUCCESS)
             {
-                *pSize = PipelineBinaryCacheSerializer::CalculateAnticipatedCacheBlobSize(curCount, curDataSize);
+                // Entries of the initial data which haven't been looked up yet are serialized as well.
+                curCount    += m_initDataIndex.GetNumEntries();
+                curDataSize += m_initDataPendingBytes;
+
+                *pSize = PipelineBinaryCacheSerializer::CalculateAnticipatedCacheBlobSize(curCount,
+                                                                                          curDataSize,
+                                                                                          m_digestChunkSize);
             }
         }
         else
         {
             size_t curCount, curDataSize;
 
+            // Hold off promotion of initial data entries so that each entry is written exactly once below.
+            Util::MutexAuto initDataLock(&m_initDataMutex);
+
             result = PalToVkResult(Util::GetMemoryCacheLayerCurSize(m_pMemoryLayer, &curCount, &curDataSize));
             if (result == VK_SUCCESS)
             {
+                const uint64_t startTimeTicks = Util::GetPerfCpuTime();
+
                 PipelineBinaryCacheSerializer serializer;
-                if (serializer.Initialize(*pSize, pBlob) == Util::Result::Success)
+                if (serializer.Initialize(*pSize, pBlob, m_digestChunkSize) == Util::Result::Success)
                 {
                     Util::AutoBuffer<Util::Hash128, 8, PalAllocator> cacheIds(curCount, &m_palAllocator);
                     result = PalToVkResult(Util::GetMemoryCacheLayerHashIds(m_pMemoryLayer, curCount, &cacheIds[0]));
                     for (uint32_t i = 0; result == VK_SUCCESS && i < curCount; i++)
                     {
-                        const void*      pBinaryCacheData = nullptr;
-                        BinaryCacheEntry entry            = {cacheIds[i], 0};
+                        result = PalToVkResult(SerializeEntry(&serializer, &cacheIds[i]));
+                    }
 
-                        result = PalToVkResult(LoadPipelineBinary(&entry.hashId, &entry.dataSize, &pBinaryCacheData));
-                        if (result == VK_SUCCESS)
+                    if (m_pInitData != nullptr)
+                    {
+                        for (auto it = m_initDataIndex.Begin();
+                             (it.Get() != nullptr) && (result == VK_SUCCESS);
+                             it.Next())
                         {
-                            result = PalToVkResult(serializer.AddPipelineBinary(&entry, pBinaryCacheData));
-                            FreeMem(const_cast<void*>(pBinaryCacheData));
+                            BinaryCacheEntry entry = { it.Get()->key, it.Get()->value.dataSize };
+
+                            result = PalToVkResult(serializer.AddPipelineBinary(
+                                &entry,
+                                Util::VoidPtrInc(m_pInitData, it.Get()->value.offset)));
                         }
                     }
-                    result = PalToVkResult(serializer.Finalize(m_pAllocationCallbacks,
-                                                               m_pPlatformKey,
-                                                               nullptr,
-                                                               nullptr));
+
+                    // Always finalize so that the entries written so far form a valid blob, even if the cache grew
+                    // since the size was queried and some entries didn't fit.
+                    size_t   entriesWritten = 0;
+                    size_t   bytesWritten   = 0;
+                    VkResult finalizeResult = PalToVkResult(serializer.Finalize(m_pAllocationCallbacks,
+                                                                                m_pPlatformKey,
+                                                                                &entriesWritten,
+                                                                                &bytesWritten));
+                    if ((result == VK_SUCCESS) || (finalizeResult != VK_SUCCESS))
+                    {
+                        result = finalizeResult;
+                    }
+
+                    const uint64_t durationNs  = utils::TicksToNano(Util::GetPerfCpuTime() - startTimeTicks);
+                    const uint64_t bytesPerSec = (durationNs > 0) ?
+                        ((static_cast<uint64_t>(bytesWritten) * NANOSECONDS_IN_A_SECOND) / durationNs) : 0;
+
+                    // Serialize-<entries>-<bytes>-<ns>-<bytes/s>-<peak temporary allocation in bytes>
+                    AmdvlkLog(m_logTagIdMask,
+                              PipelineCacheTime,
+                              "Serialize-%zu-%zu-%llu-%llu-%zu",
+                              entriesWritten,
+                              bytesWritten,
+                              static_cast<unsigned long long>(durationNs),
+                              static_cast<unsigned long long>(bytesPerSec),
+                              curCount * sizeof(Util::Hash128));
                 }
                 else
                 {
@@ -1344,51 +2616,243 @@ VkResult PipelineBinaryCache::Serialize(
     return result;
 }
 
+// =====================================================================================================================
+// Shared state of the threads merging source caches into a destination cache
+struct MergeState
+{
+    PipelineBinaryCache*        pDstCache;
+    const PipelineBinaryCache** ppSrcCaches;
+    uint32_t                    srcCacheCount;
+    volatile uint32_t           nextSrcCache;
+    volatile uint32_t           failed;
+    Util::Result                result;           // Result of the first failed source, valid if failed is set
+    volatile uint64_t           mergedEntries;    // Entries copied from a source cache
+    volatile uint64_t           skippedEntries;   // Entries which were already present
+    volatile uint64_t           mergedBytes;      // Total size of the copied entries
+};
+
+// =====================================================================================================================
+// Claims and merges source caches until every source has been claimed or one has failed. Runs on the calling thread as
+// well as on the pipeline batch helper threads.
+void PipelineBinaryCache::ExecuteMerge(
+    void* pPayload)
+{
+    MergeState* pState = static_cast<MergeState*>(pPayload);
+    MergeStats  stats  = {};
+
+    uint32_t index = Util::AtomicIncrement(&pState->nextSrcCache) - 1;
+
+    while ((index < pState->srcCacheCount) && (pState->failed == 0))
+    {
+        Util::Result result = pState->pDstCache->MergeCache(pState->ppSrcCaches[index], &stats);
+
+        if ((result != Util::Result::Success) && (Util::AtomicCompareAndSwap(&pState->failed, 0, 1) == 0))
+        {
+            pState->result = result;
+        }
+
+        index = Util::AtomicIncrement(&pState->nextSrcCache) - 1;
+    }
+
+    Util::AtomicAdd64(&pState->mergedEntries,  stats.mergedEntries);
+    Util::AtomicAdd64(&pState->skippedEntries, stats.skippedEntries);
+    Util::AtomicAdd64(&pState->mergedBytes,    stats.mergedBytes);
+}
+
+// =====================================================================================================================
+// Merges all entries of a source cache's memory layer which aren't present in this cache yet.
+Util::Result PipelineBinaryCache::MergeCache(
+    const PipelineBinaryCache* pSrcCache,
+    MergeStats*                pStats)
+{
+    Util::ICacheLayer* pSrcLayer = pSrcCache->GetMemoryLayer();
+    size_t curCount, curDataSize;
+
+    Util::Result result = Util::GetMemoryCacheLayerCurSize(pSrcLayer, &curCount, &curDataSize);
+
+    if ((result == Util::Result::Success) && (curCount > 0))
+    {
+        Util::AutoBuffer<Util::Hash128, 8, PalAllocator> cacheIds(curCount, &m_palAllocator);
+
+        result = Util::GetMemoryCacheLayerHashIds(pSrcLayer, curCount, &cacheIds[0]);
+
+        for (uint32_t i = 0; (result == Util::Result::Success) && (i < curCount); i++)
+        {
+            result = MergeEntry(pSrcLayer, &cacheIds[i], pStats);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Stores a single entry of a source memory layer into this cache. The ID is looked up in this cache first so that
+// existing entries are skipped without touching the source data, and the source data is stored straight from the
+// source layer while it is pinned with a cache reference.
+Util::Result PipelineBinaryCache::MergeEntry(
+    Util::ICacheLayer* pSrcLayer,
+    const CacheId*     pCacheId,
+    MergeStats*        pStats)
+{
+    Util::QueryResult query  = {};
+    Util::Result      result = m_pMemoryLayer->Query(pCacheId, 0, 0, &query);
+
+    if ((result == Util::Result::Success) || (result == Util::Result::NotReady))
+    {
+        pStats->skippedEntries++;
+        result = Util::Result::Success;
+    }
+    else if (result == Util::Result::NotFound)
+    {
+        result = pSrcLayer->Query(pCacheId, 0, Util::ICacheLayer::QueryFlags::AcquireEntryRef, &query);
+
+        if (result == Util::Result::Success)
+        {
+            const void* pData = nullptr;
+
+            result = pSrcLayer->GetCacheData(&query, &pData);
+            if (result == Util::Result::Success)
+            {
+                result = StorePipelineBinary(pCacheId, query.dataSize, pData);
+            }
+
+            if (result == Util::Result::Success)
+            {
+                pStats->mergedEntries++;
+                pStats->mergedBytes += query.dataSize;
+            }
+            else if (result == Util::Result::AlreadyExists)
+            {
+                // Another source stored the same entry concurrently.
+                pStats->skippedEntries++;
+                result = Util::Result::Success;
+            }
+
+            pSrcLayer->ReleaseCacheRef(&query);
+        }
+        else if (result == Util::Result::NotReady)
+        {
+            // The source entry is still being populated, so there is nothing to merge yet.
+            pSrcLayer->ReleaseCacheRef(&query);
+            result = Util::Result::Success;
+        }
+        else if (result == Util::Result::NotFound)
+        {
+            // The source entry was evicted after the hash IDs were gathered.
+            result = Util::Result::Success;
+        }
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Merge the pipeline cache data into one
 //
+// Source caches are merged concurrently on the pipeline batch helper threads if pCompiler provides them. That is only
+// done with the driver's default allocation callbacks, since storing entries allocates memory and the application's
+// allocation callbacks may only be called from the calling thread.
 VkResult PipelineBinaryCache::Merge(
     uint32_t                    srcCacheCount,
-    const PipelineBinaryCache** ppSrcCaches)
+    const PipelineBinaryCache** ppSrcCaches,
+    PipelineCompiler*           pCompiler)
 {
     Pal::Result result = Pal::Result::ErrorInitializationFailed;
 
     if (m_pMemoryLayer != nullptr)
     {
-        for (uint32_t i = 0; i < srcCacheCount; i++)
+        const uint64_t startTimeTicks = Util::GetPerfCpuTime();
+
+        result = Pal::Result::Success;
+
+        // Move the sources' lazily loaded initial data into their memory layers so that it is merged as well.
+        for (uint32_t i = 0; (result == Pal::Result::Success) && (i < srcCacheCount); i++)
         {
-            Util::ICacheLayer* pMemoryLayer = ppSrcCaches[i]->GetMemoryLayer();
-            size_t curCount, curDataSize;
+            result = ppSrcCaches[i]->PromoteAllInitData();
+        }
+
+        if (result == Pal::Result::Success)
+        {
+            MergeState state    = {};
+            state.pDstCache     = this;
+            state.ppSrcCaches   = ppSrcCaches;
+            state.srcCacheCount = srcCacheCount;
+            state.result        = Util::Result::Success;
 
-            result = Util::GetMemoryCacheLayerCurSize(pMemoryLayer, &curCount, &curDataSize);
+            uint32_t helperCount = 0;
 
-            if ((result == Pal::Result::Success) && (curCount > 0))
+            if ((pCompiler != nullptr) &&
+                (srcCacheCount > 1) &&
+                (m_pAllocationCallbacks->pfnAllocation == allocator::g_DefaultAllocCallback.pfnAllocation))
             {
-                Util::AutoBuffer<Util::Hash128, 8, PalAllocator> cacheIds(curCount, &m_palAllocator);
+                helperCount = Util::Min(pCompiler->GetPipelineBatchThreadCount(), srcCacheCount - 1);
+            }
 
-                result = Util::GetMemoryCacheLayerHashIds(pMemoryLayer, curCount, &cacheIds[0]);
-                if (result == Pal::Result::Success)
-                {
-                    for (uint32_t j = 0; j < curCount; j++)
-                    {
-                        size_t           dataSize;
-                        const void*      pBinaryCacheData;
+            const size_t workloadSize = Util::Pow2Align(sizeof(DeferredCompileWorkload) * helperCount,
+                                                        VK_DEFAULT_MEM_ALIGN);
+            const size_t eventSize    = sizeof(Util::Event) * helperCount;
+            void*        pMemory      = (helperCount > 0) ? AllocMem(workloadSize + eventSize) : nullptr;
 
-                        result = ppSrcCaches[i]->LoadPipelineBinary(&cacheIds[j], &dataSize, &pBinaryCacheData);
-                        if (result == Pal::Result::Success)
-                        {
-                            result = StorePipelineBinary(&cacheIds[j], dataSize, pBinaryCacheData);
-                            FreeMem(const_cast<void*>(pBinaryCacheData));
+            if (pMemory == nullptr)
+            {
+                helperCount = 0;
+            }
 
-                            // Do not break for success cases or an already existing cache entry
-                            if ((result != Pal::Result::Success) && (result != Pal::Result::AlreadyExists))
-                            {
-                                break;
-                            }
-                        }
-                    }
+            DeferredCompileWorkload* pWorkloads = static_cast<DeferredCompileWorkload*>(pMemory);
+            Util::Event*             pEvents    = static_cast<Util::Event*>(Util::VoidPtrInc(pMemory, workloadSize));
+
+            Util::EventCreateFlags flags = {};
+            flags.manualReset = true;
+
+            for (uint32_t i = 0; i < helperCount; ++i)
+            {
+                VK_PLACEMENT_NEW(&pEvents[i]) Util::Event();
+                pEvents[i].Init(flags);
+
+                pWorkloads[i].pPayloads = &state;
+                pWorkloads[i].Execute   = ExecuteMerge;
+                pWorkloads[i].pEvent    = &pEvents[i];
+                pWorkloads[i].queueIdx  = DeferCompileThread::InvalidQueueIdx;
+
+                pCompiler->ExecutePipelineBatchWorkload(&pWorkloads[i]);
+            }
+
+            // The calling thread merges sources alongside the helpers.
+            ExecuteMerge(&state);
+
+            Util::Result waitResult = Util::Result::Success;
+
+            for (uint32_t i = 0; i < helperCount; ++i)
+            {
+                const Util::Result helperResult = pCompiler->FinishPipelineBatchWorkload(&pWorkloads[i]);
+
+                if (helperResult != Util::Result::Success)
+                {
+                    waitResult = helperResult;
                 }
+
+                Util::Destructor(&pEvents[i]);
             }
+
+            FreeMem(pMemory);
+
+            result = (waitResult == Util::Result::Success) ? state.result : waitResult;
+
+            const uint64_t durationNs  = utils::TicksToNano(Util::GetPerfCpuTime() - startTimeTicks);
+            const uint64_t bytesPerSec = (durationNs > 0) ?
+                ((state.mergedBytes * NANOSECONDS_IN_A_SECOND) / durationNs) : 0;
+
+            // Merge-<sources>-<threads>-<merged entries>-<skipped entries>-<merged bytes>-<ns>-<bytes/s>
+            AmdvlkLog(m_logTagIdMask,
+                      PipelineCacheTime,
+                      "Merge-%u-%u-%llu-%llu-%llu-%llu-%llu",
+                      srcCacheCount,
+                      helperCount + 1,
+                      static_cast<unsigned long long>(state.mergedEntries),
+                      static_cast<unsigned long long>(state.skippedEntries),
+                      static_cast<unsigned long long>(state.mergedBytes),
+                      static_cast<unsigned long long>(durationNs),
+                      static_cast<unsigned long long>(bytesPerSec));
         }
     }
 
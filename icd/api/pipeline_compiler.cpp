@@ -130,6 +130,7 @@ PipelineCompiler::PipelineCompiler(
     PhysicalDevice* pPhysicalDevice)
     :
     m_pPhysicalDevice(pPhysicalDevice)
+    , m_pipelineBatchThreadCount(0)
     , m_compilerSolutionLlpc(pPhysicalDevice)
     , m_pBinaryCache(nullptr)
     , m_cacheAttempts(0)
@@ -137,7 +138,7 @@ PipelineCompiler::PipelineCompiler(
     , m_totalBinaries(0)
     , m_totalTimeSpent(0)
     , m_uberFetchShaderInfoFormatMap(8, pPhysicalDevice->Manager()->VkInstance()->Allocator())
-    , m_shaderModuleHandleMap(8, pPhysicalDevice->Manager()->VkInstance()->Allocator())
+    , m_shaderModuleCache(this, pPhysicalDevice->Manager()->VkInstance()->Allocator())
 {
 
 }
@@ -160,13 +161,92 @@ void PipelineCompiler::GetElfCacheMetricString(
         (static_cast<double>(m_cacheHits) / static_cast<double>(m_cacheAttempts)) :
         0.0;
 
+    PipelineBinaryCache::MemoryLayerStats memoryStats = {};
+
+    if (m_pBinaryCache != nullptr)
+    {
+        m_pBinaryCache->GetMemoryLayerStats(&memoryStats);
+    }
+
     static constexpr char metricFmtString[] =
         "Cache hit rate - %0.1f%%\n"
         "Total request count - %d\n"
         "Total time spent - %0.1f ms\n"
-        "Average time spent per request - %0.3f ms\n";
+        "Average time spent per request - %0.3f ms\n"
+        "Memory layer hits - %llu\n"
+        "Archive layer hits - %llu\n"
+        "Cache misses - %llu\n"
+        "Memory layer evictions - %llu\n"
+        "Memory layer usage - %zu entries, %zu bytes (budget %zu bytes, 0 if unlimited)\n"
+        "Archive writes - %llu entries written, %llu bytes pending\n";
+
+    Util::Snprintf(pOutStr,
+                   outStrSize,
+                   metricFmtString,
+                   hitRate * 100,
+                   m_totalBinaries,
+                   totalMs,
+                   avgMs,
+                   static_cast<unsigned long long>(memoryStats.hits),
+                   static_cast<unsigned long long>(memoryStats.backingHits),
+                   static_cast<unsigned long long>(memoryStats.misses),
+                   static_cast<unsigned long long>(memoryStats.evictions),
+                   memoryStats.curCount,
+                   memoryStats.curDataSize,
+                   (memoryStats.budget == SIZE_MAX) ? 0 : memoryStats.budget,
+                   static_cast<unsigned long long>(memoryStats.archiveWrites),
+                   static_cast<unsigned long long>(memoryStats.pendingWrites));
+}
+
+// =====================================================================================================================
+void PipelineCompiler::GetDeferCompileMetricString(
+    char*   pOutStr,
+    size_t  outStrSize)
+{
+    DeferCompileManager::Stats stats = {};
+    m_deferCompileMgr.GetStats(&stats);
 
-    Util::Snprintf(pOutStr, outStrSize, metricFmtString, hitRate * 100, m_totalBinaries, totalMs, avgMs);
+    static constexpr char metricFmtString[] =
+        "Compile thread count - %u\n"
+        "Queue depth - %u (peak %u)\n"
+        "Executed task count - %llu\n"
+        "Stolen task count - %llu\n"
+        "Revoked task count - %llu\n";
+
+    Util::Snprintf(pOutStr,
+                   outStrSize,
+                   metricFmtString,
+                   stats.threadCount,
+                   stats.queueDepth,
+                   stats.peakQueueDepth,
+                   static_cast<unsigned long long>(stats.executedTasks),
+                   static_cast<unsigned long long>(stats.stolenTasks),
+                   static_cast<unsigned long long>(stats.revokedTasks));
+}
+
+// =====================================================================================================================
+void PipelineCompiler::GetShaderModuleCacheMetricString(
+    char*   pOutStr,
+    size_t  outStrSize)
+{
+    ShaderModuleCache::Stats stats = {};
+    m_shaderModuleCache.GetStats(&stats);
+
+    static constexpr char metricFmtString[] =
+        "Shader module cache entries - %u (%u shards)\n"
+        "Shader module cache lookups - %llu (%llu hits)\n"
+        "Shader module cache evictions - %llu\n"
+        "Contended shard lock acquisitions - %llu\n";
+
+    Util::Snprintf(pOutStr,
+                   outStrSize,
+                   metricFmtString,
+                   stats.entryCount,
+                   stats.shardCount,
+                   static_cast<unsigned long long>(stats.lookups),
+                   static_cast<unsigned long long>(stats.hits),
+                   static_cast<unsigned long long>(stats.evictions),
+                   static_cast<unsigned long long>(stats.contendedLocks));
 }
 
 // =====================================================================================================================
@@ -179,6 +259,16 @@ void PipelineCompiler::DestroyPipelineBinaryCache()
     }
 }
 
+// =====================================================================================================================
+// Waits until the internal pipeline binary cache has written all stored binaries to its archive file.
+void PipelineCompiler::FlushPipelineBinaryCache()
+{
+    if (m_pBinaryCache != nullptr)
+    {
+        m_pBinaryCache->FlushArchiveWrites();
+    }
+}
+
 // =====================================================================================================================
 PipelineCompiler::~PipelineCompiler()
 {
@@ -271,7 +361,7 @@ VkResult PipelineCompiler::Initialize()
 
     if (result == VK_SUCCESS)
     {
-        result = PalToVkResult(m_shaderModuleHandleMap.Init());
+        result = m_shaderModuleCache.Init(settings.shaderModuleCacheMaxEntries);
     }
 
     if (result == VK_SUCCESS)
@@ -286,8 +376,13 @@ VkResult PipelineCompiler::Initialize()
 
     if (result == VK_SUCCESS)
     {
-        uint32_t threadCount = settings.deferCompileOptimizedPipeline ? settings.deferCompileThreadCount : 0;
-        m_deferCompileMgr.Init(threadCount, m_pPhysicalDevice->VkInstance()->Allocator());
+        // Deferred compiles and parallel pipeline batches share one scheduler which is sized for the larger of the two
+        // requested thread counts.
+        uint32_t deferThreadCount = settings.deferCompileOptimizedPipeline ? settings.deferCompileThreadCount : 0;
+        uint32_t batchThreadCount = DeferCompileManager::GetThreadCount(settings.pipelineBatchThreadCount);
+
+        m_deferCompileMgr.Init(Util::Max(DeferCompileManager::GetThreadCount(deferThreadCount), batchThreadCount));
+        m_pipelineBatchThreadCount = Util::Min(batchThreadCount, m_deferCompileMgr.GetActiveThreadCount());
     }
 
     return result;
@@ -297,31 +392,26 @@ VkResult PipelineCompiler::Initialize()
 // Destroys all compiler instance.
 void PipelineCompiler::Destroy()
 {
+    const uint64_t logTagIdMask = m_pPhysicalDevice->GetRuntimeSettings().logTagIdMask;
+
+    if ((logTagIdMask & (1ull << PipelineCompilerStats)) != 0)
+    {
+        char metricStr[512] = {};
+
+        GetDeferCompileMetricString(metricStr, sizeof(metricStr));
+        AmdvlkLog(logTagIdMask, PipelineCompilerStats, "%s", metricStr);
+
+        GetShaderModuleCacheMetricString(metricStr, sizeof(metricStr));
+        AmdvlkLog(logTagIdMask, PipelineCompilerStats, "%s", metricStr);
+    }
+
     m_compilerSolutionLlpc.Destroy();
 
     DestroyPipelineBinaryCache();
 
     if (m_pPhysicalDevice->GetRuntimeSettings().enableEarlyCompile)
     {
-        Util::MutexAuto mutexLock(&m_shaderModuleCacheLock);
-        for (auto it = m_shaderModuleHandleMap.Begin(); it.Get() != nullptr; it.Next())
-        {
-            VK_ASSERT(it.Get()->value.pRefCount != nullptr);
-
-            if (*(it.Get()->value.pRefCount) == 1)
-            {
-                // Force use un-lock version of FreeShaderModule.
-                auto pInstance = m_pPhysicalDevice->Manager()->VkInstance();
-                pInstance->FreeMem(it.Get()->value.pRefCount);
-                it.Get()->value.pRefCount = nullptr;
-                FreeShaderModule(&it.Get()->value);
-            }
-            else
-            {
-                (*(it.Get()->value.pRefCount))--;
-            }
-        }
-        m_shaderModuleHandleMap.Reset();
+        m_shaderModuleCache.Reset();
     }
 }
 
@@ -436,23 +526,14 @@ VkResult PipelineCompiler::LoadShaderModuleFromCache(
         Util::Result cacheResult         = Util::Result::NotFound;
         bool hitApplicationCache         = false;
 
-        // 1. Look up in internal cache m_shaderModuleHandleMap.
-        if (supportInternalModuleCache)
+        // 1. Look up in internal cache m_shaderModuleCache.
+        if (supportInternalModuleCache && m_shaderModuleCache.Find(shaderModuleCacheHash, pShaderModule))
         {
-            Util::MutexAuto mutexLock(&m_shaderModuleCacheLock);
-
-            ShaderModuleHandle* pHandle = m_shaderModuleHandleMap.FindKey(shaderModuleCacheHash);
-            if (pHandle != nullptr)
-            {
-                VK_ASSERT(pHandle->pRefCount != nullptr);
-                (*(pHandle->pRefCount))++;
-                *pShaderModule = *pHandle;
-                result         = VK_SUCCESS;
-                cacheResult    = Util::Result::Success;
-            }
+            result      = VK_SUCCESS;
+            cacheResult = Util::Result::Success;
         }
 
-        // 2. Look up in application cache pBinaryCache.  Only query availability when hits in m_shaderModuleHandleMap.
+        // 2. Look up in application cache pBinaryCache.  Only query availability when hits in m_shaderModuleCache.
         if (pBinaryCache != nullptr)
         {
 
@@ -464,7 +545,7 @@ VkResult PipelineCompiler::LoadShaderModuleFromCache(
         {
         }
 
-        // 4. Relocate shader and setup reference counter if cache hits and not come from m_shaderModuleHandleMap.
+        // 4. Relocate shader and setup reference counter if cache hits and not come from m_shaderModuleCache.
         if ((result != VK_SUCCESS) && (cacheResult == Util::Result::Success))
         {
 
@@ -475,12 +556,14 @@ VkResult PipelineCompiler::LoadShaderModuleFromCache(
                     pInstance->AllocMem(sizeof(uint32_t), VK_DEFAULT_MEM_ALIGN, VK_SYSTEM_ALLOCATION_SCOPE_CACHE));
                 if (pShaderModule->pRefCount != nullptr)
                 {
-                    Util::MutexAuto mutexLock(&m_shaderModuleCacheLock);
-
                     // Initialize the reference count to two: one for the runtime cache and one for this shader module.
                     *pShaderModule->pRefCount = 2;
-                    result = PalToVkResult(m_shaderModuleHandleMap.Insert(shaderModuleCacheHash, *pShaderModule));
-                    VK_ASSERT(result == VK_SUCCESS);
+
+                    if (m_shaderModuleCache.Insert(shaderModuleCacheHash, *pShaderModule) != Util::Result::Success)
+                    {
+                        // Another thread has cached the same module first, or the insertion failed.
+                        *pShaderModule->pRefCount = 1;
+                    }
                 }
             }
         }
@@ -525,7 +608,7 @@ void PipelineCompiler::StoreShaderModuleToCache(
         {
         }
 
-        // 2. Store in internal cache m_shaderModuleHandleMap and m_pBinaryCache
+        // 2. Store in internal cache m_shaderModuleCache and m_pBinaryCache
         if (supportInternalModuleCache)
         {
             Instance* pInstance = m_pPhysicalDevice->VkInstance();
@@ -533,10 +616,9 @@ void PipelineCompiler::StoreShaderModuleToCache(
                 pInstance->AllocMem(sizeof(uint32_t), VK_DEFAULT_MEM_ALIGN, VK_SYSTEM_ALLOCATION_SCOPE_CACHE));
             if (pShaderModule->pRefCount != nullptr)
             {
-                Util::MutexAuto mutexLock(&m_shaderModuleCacheLock);
                 // Initialize the reference count to two: one for the runtime cache and one for this shader module.
                 *pShaderModule->pRefCount = 2;
-                auto palResult = m_shaderModuleHandleMap.Insert(shaderModuleCacheHash, *pShaderModule);
+                auto palResult = m_shaderModuleCache.Insert(shaderModuleCacheHash, *pShaderModule);
                 if (palResult != Util::Result::Success)
                 {
                     // Reset refference count to one if fail to add it to runtime cache
@@ -662,12 +744,8 @@ void PipelineCompiler::FreeShaderModule(
 {
     if (pShaderModule->pRefCount != nullptr)
     {
-        Util::MutexAuto mutexLock(&m_shaderModuleCacheLock);
-        if (*pShaderModule->pRefCount > 1)
-        {
-            (*pShaderModule->pRefCount)--;
-        }
-        else
+        // Modules shared with m_shaderModuleCache are reference counted atomically, see ShaderModuleCache.
+        if (Util::AtomicDecrement(pShaderModule->pRefCount) == 0)
         {
             m_compilerSolutionLlpc.FreeShaderModule(pShaderModule);
             auto pInstance = m_pPhysicalDevice->Manager()->VkInstance();
@@ -907,10 +985,14 @@ Util::Result PipelineCompiler::GetCachedPipelineBinary(
     PipelineCreationFeedback*    pPipelineFeedback)
 {
     Util::Result cacheResult = Util::Result::NotFound;
+    bool         isMapped    = false;
 
     if (pPipelineBinaryCache != nullptr)
     {
-        cacheResult = pPipelineBinaryCache->LoadPipelineBinary(pCacheId, pPipelineBinarySize, ppPipelineBinary);
+        cacheResult = pPipelineBinaryCache->LoadPipelineBinary(pCacheId,
+                                                               pPipelineBinarySize,
+                                                               ppPipelineBinary,
+                                                               &isMapped);
         if (cacheResult == Util::Result::Success)
         {
             *pIsUserCacheHit = true;
@@ -930,7 +1012,10 @@ Util::Result PipelineCompiler::GetCachedPipelineBinary(
         }
         else
         {
-            cacheResult = m_pBinaryCache->LoadPipelineBinary(pCacheId, pPipelineBinarySize, ppPipelineBinary);
+            cacheResult = m_pBinaryCache->LoadPipelineBinary(pCacheId,
+                                                             pPipelineBinarySize,
+                                                             ppPipelineBinary,
+                                                             &isMapped);
         }
         if (cacheResult == Util::Result::Success)
         {
@@ -939,7 +1024,8 @@ Util::Result PipelineCompiler::GetCachedPipelineBinary(
     }
     if (*pIsUserCacheHit || *pIsInternalCacheHit)
     {
-        *pFreeCompilerBinary = FreeWithInstanceAllocator;
+        // Binaries within a mapped pipeline cache file are returned in place and live as long as their cache.
+        *pFreeCompilerBinary = isMapped ? DoNotFree : FreeWithInstanceAllocator;
         cacheResult = Util::Result::Success;
         m_cacheHits++;
     }
@@ -3064,10 +3150,9 @@ void PipelineCompiler::BuildPipelineInternalBufferData(
 void PipelineCompiler::ExecuteDeferCompile(
     DeferredCompileWorkload* pWorkload)
 {
-    auto pThread = m_deferCompileMgr.GetCompileThread();
-    if (pThread != nullptr)
+    if (m_deferCompileMgr.GetActiveThreadCount() > 0)
     {
-        pThread->AddTask(pWorkload);
+        m_deferCompileMgr.AddTask(pWorkload);
     }
     else
     {
@@ -3079,4 +3164,51 @@ void PipelineCompiler::ExecuteDeferCompile(
     }
 }
 
+// =====================================================================================================================
+// Hands a helper workload of a parallel pipeline batch to the scheduler.  The workload runs on the calling thread if
+// the scheduler has no threads.
+void PipelineCompiler::ExecutePipelineBatchWorkload(
+    DeferredCompileWorkload* pWorkload)
+{
+    if (m_deferCompileMgr.GetActiveThreadCount() > 0)
+    {
+        m_deferCompileMgr.AddTask(pWorkload);
+    }
+    else
+    {
+        pWorkload->Execute(pWorkload->pPayloads);
+        if (pWorkload->pEvent != nullptr)
+        {
+            pWorkload->pEvent->Set();
+        }
+    }
+}
+
+// =====================================================================================================================
+// Revokes a workload queued by ExecutePipelineBatchWorkload, or waits for it to finish if a compile thread has already
+// picked it up.  The workload no longer runs once this returns, so its payload may be freed.  Returns the error of the
+// event wait if it failed for any reason other than a timeout.
+Util::Result PipelineCompiler::FinishPipelineBatchWorkload(
+    DeferredCompileWorkload* pWorkload)
+{
+    Util::Result result = Util::Result::Success;
+
+    if (RevokeDeferredWorkload(pWorkload) == false)
+    {
+        do
+        {
+            result = pWorkload->pEvent->Wait(1.0f);
+        }
+        while (result == Util::Result::Timeout);
+
+        if (result != Util::Result::Success)
+        {
+            // The event can't tell when the workload is done, so wait for the scheduler to run out of work instead.
+            m_deferCompileMgr.SyncAll();
+        }
+    }
+
+    return result;
+}
+
 }
@@ -0,0 +1,260 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2022 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+***********************************************************************************************************************
+* @file  shader_module_cache.cpp
+* @brief Implementation of the runtime shader module cache of PipelineCompiler.
+***********************************************************************************************************************
+*/
+
+#include "include/shader_module_cache.h"
+#include "include/pipeline_compiler.h"
+
+#include "palHashMapImpl.h"
+#include "palSysUtil.h"
+
+namespace vk
+{
+
+// =====================================================================================================================
+ShaderModuleCache::ShaderModuleCache(
+    PipelineCompiler* pCompiler,
+    PalAllocator*     pAllocator)
+    :
+    m_pCompiler(pCompiler),
+    m_pAllocator(pAllocator),
+    m_maxEntriesPerShard(UINT32_MAX),
+    m_pShards{}
+{
+}
+
+// =====================================================================================================================
+ShaderModuleCache::~ShaderModuleCache()
+{
+    for (uint32_t i = 0; i < ShardCount; ++i)
+    {
+        if (m_pShards[i] != nullptr)
+        {
+            Util::Destructor(m_pShards[i]);
+            m_pShards[i] = nullptr;
+        }
+    }
+}
+
+// =====================================================================================================================
+// Creates the shards. A maxEntries of 0 leaves the cache unlimited.
+VkResult ShaderModuleCache::Init(
+    uint32_t maxEntries)
+{
+    VkResult result = VK_SUCCESS;
+
+    if (maxEntries > 0)
+    {
+        m_maxEntriesPerShard = Util::Max(1u, maxEntries / ShardCount);
+    }
+
+    for (uint32_t i = 0; (i < ShardCount) && (result == VK_SUCCESS); ++i)
+    {
+        m_pShards[i] = VK_PLACEMENT_NEW(m_shardBuffer[i]) Shard(m_pAllocator);
+
+        result = PalToVkResult(m_pShards[i]->map.Init());
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Takes the shared lock of a shard and counts the acquisition as contended if another thread holds the exclusive lock.
+void ShaderModuleCache::LockForRead(
+    Shard* pShard)
+{
+    if (pShard->lock.TryLockForRead() == false)
+    {
+        Util::AtomicIncrement64(&pShard->contendedLocks);
+        pShard->lock.LockForRead();
+    }
+}
+
+// =====================================================================================================================
+// Takes the exclusive lock of a shard and counts the acquisition as contended if another thread holds the lock.
+void ShaderModuleCache::LockForWrite(
+    Shard* pShard)
+{
+    if (pShard->lock.TryLockForWrite() == false)
+    {
+        Util::AtomicIncrement64(&pShard->contendedLocks);
+        pShard->lock.LockForWrite();
+    }
+}
+
+// =====================================================================================================================
+// Looks up a shader module and adds a reference to it on a hit.
+bool ShaderModuleCache::Find(
+    const Util::MetroHash::Hash& hash,
+    ShaderModuleHandle*          pShaderModule)
+{
+    Shard* pShard = GetShard(hash);
+    bool   found  = false;
+
+    Util::AtomicIncrement64(&pShard->lookups);
+
+    LockForRead(pShard);
+
+    Entry* pEntry = pShard->map.FindKey(hash);
+
+    if (pEntry != nullptr)
+    {
+        VK_ASSERT(pEntry->shaderModule.pRefCount != nullptr);
+
+        // The cache's own reference can only be dropped under the exclusive lock, so the module stays alive here.
+        Util::AtomicIncrement(pEntry->shaderModule.pRefCount);
+        pEntry->lastUse = Util::GetPerfCpuTime();
+
+        *pShaderModule = pEntry->shaderModule;
+        found          = true;
+    }
+
+    pShard->lock.UnlockForRead();
+
+    if (found)
+    {
+        Util::AtomicIncrement64(&pShard->hits);
+    }
+
+    return found;
+}
+
+// =====================================================================================================================
+// Adds a shader module whose reference count already includes the reference owned by the cache. Returns AlreadyExists
+// without taking that reference if another thread has cached a module under the same hash first.
+Util::Result ShaderModuleCache::Insert(
+    const Util::MetroHash::Hash& hash,
+    const ShaderModuleHandle&    shaderModule)
+{
+    VK_ASSERT(shaderModule.pRefCount != nullptr);
+
+    Shard* pShard = GetShard(hash);
+
+    LockForWrite(pShard);
+
+    if ((pShard->map.GetNumEntries() >= m_maxEntriesPerShard) && (pShard->map.FindKey(hash) == nullptr))
+    {
+        EvictLeastRecentlyUsed(pShard);
+    }
+
+    bool   existed = false;
+    Entry* pEntry  = nullptr;
+
+    Util::Result result = pShard->map.FindAllocate(hash, &existed, &pEntry);
+
+    if (result == Util::Result::Success)
+    {
+        if (existed)
+        {
+            result = Util::Result::AlreadyExists;
+        }
+        else
+        {
+            pEntry->shaderModule = shaderModule;
+            pEntry->lastUse      = Util::GetPerfCpuTime();
+        }
+    }
+
+    pShard->lock.UnlockForWrite();
+
+    return result;
+}
+
+// =====================================================================================================================
+// Drops the least recently used module of a full shard. The caller must hold the exclusive lock of the shard.
+void ShaderModuleCache::EvictLeastRecentlyUsed(
+    Shard* pShard)
+{
+    const Util::MetroHash::Hash* pVictim  = nullptr;
+    int64_t                      oldestUse = INT64_MAX;
+
+    for (auto it = pShard->map.Begin(); it.Get() != nullptr; it.Next())
+    {
+        if (it.Get()->value.lastUse < oldestUse)
+        {
+            oldestUse = it.Get()->value.lastUse;
+            pVictim   = &it.Get()->key;
+        }
+    }
+
+    if (pVictim != nullptr)
+    {
+        const Util::MetroHash::Hash victimHash   = *pVictim;
+        ShaderModuleHandle          shaderModule = pShard->map.FindKey(victimHash)->shaderModule;
+
+        pShard->map.Erase(victimHash);
+        m_pCompiler->FreeShaderModule(&shaderModule);
+
+        Util::AtomicIncrement64(&pShard->evictions);
+    }
+}
+
+// =====================================================================================================================
+// Drops the references owned by the cache and removes all modules from it.
+void ShaderModuleCache::Reset()
+{
+    for (uint32_t i = 0; (i < ShardCount) && (m_pShards[i] != nullptr); ++i)
+    {
+        Shard* pShard = m_pShards[i];
+
+        LockForWrite(pShard);
+
+        for (auto it = pShard->map.Begin(); it.Get() != nullptr; it.Next())
+        {
+            m_pCompiler->FreeShaderModule(&it.Get()->value.shaderModule);
+        }
+
+        pShard->map.Reset();
+
+        pShard->lock.UnlockForWrite();
+    }
+}
+
+// =====================================================================================================================
+void ShaderModuleCache::GetStats(
+    Stats* pStats) const
+{
+    *pStats            = {};
+    pStats->shardCount = ShardCount;
+
+    for (uint32_t i = 0; (i < ShardCount) && (m_pShards[i] != nullptr); ++i)
+    {
+        const Shard* pShard = m_pShards[i];
+
+        // Racy but sufficient for statistics.
+        pStats->entryCount     += pShard->map.GetNumEntries();
+        pStats->lookups        += pShard->lookups;
+        pStats->hits           += pShard->hits;
+        pStats->evictions      += pShard->evictions;
+        pStats->contendedLocks += pShard->contendedLocks;
+    }
+}
+
+} // namespace vk
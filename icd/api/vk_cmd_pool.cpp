@@ -36,7 +36,6 @@
 #include "include/vk_conv.h"
 
 #include "palFile.h"
-#include "palHashSetImpl.h"
 #include "palIntrusiveListImpl.h"
 #include "palVectorImpl.h"
 
@@ -59,8 +58,8 @@ CmdPool::CmdPool(
     m_pDevice(pDevice),
     m_pAllocator(pAllocator),
     m_queueFamilyIndex(queueFamilyIndex),
-    m_cmdBufferRegistry(32, pDevice->VkInstance()->Allocator()),
-    m_cmdBuffersAlreadyBegun(32, pDevice->VkInstance()->Allocator())
+    m_cmdBufferRegistry(pDevice->VkInstance()->Allocator()),
+    m_cmdBuffersAlreadyBegun(pDevice->VkInstance()->Allocator())
 {
     m_flags.u32All = 0;
 
@@ -82,14 +81,7 @@ CmdPool::CmdPool(
 // Initializes the command buffer pool object.
 VkResult CmdPool::Init()
 {
-    Pal::Result palResult = m_cmdBufferRegistry.Init();
-
-    if (palResult == Pal::Result::Success)
-    {
-        palResult = m_cmdBuffersAlreadyBegun.Init();
-    }
-
-    return PalToVkResult(palResult);
+    return VK_SUCCESS;
 }
 
 // =====================================================================================================================
@@ -224,9 +216,9 @@ VkResult CmdPool::Destroy(
 {
     // When a command pool is destroyed, all command buffers allocated from the pool are implicitly freed and
     // become invalid.
-    while (m_cmdBufferRegistry.GetNumEntries() > 0)
+    while (m_cmdBufferRegistry.IsEmpty() == false)
     {
-        CmdBuffer* pCmdBuf = m_cmdBufferRegistry.Begin().Get()->key;
+        CmdBuffer* pCmdBuf = m_cmdBufferRegistry.At(m_cmdBufferRegistry.NumElements() - 1);
 
         pCmdBuf->Destroy();
     }
@@ -277,26 +269,31 @@ VkResult CmdPool::Reset(
     // only reset the command buffers that were begun and not already reset (PAL doesn't do this automatically).
     if (IsResetCmdBuffer())
     {
-        for (auto it = m_cmdBufferRegistry.Begin(); (it.Get() != nullptr) && (result == VK_SUCCESS); it.Next())
+        for (uint32_t i = 0; (i < m_cmdBufferRegistry.NumElements()) && (result == VK_SUCCESS); ++i)
         {
             // Per-spec we always have to do a command buffer reset that also releases the used resources.
-            result = it.Get()->key->Reset(VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+            result = m_cmdBufferRegistry.At(i)->Reset(VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
         }
     }
     else
     {
-        for (auto it = m_cmdBuffersAlreadyBegun.Begin(); (it.Get() != nullptr) && (result == VK_SUCCESS); it.Next())
+        for (uint32_t i = 0; (i < m_cmdBuffersAlreadyBegun.NumElements()) && (result == VK_SUCCESS); ++i)
         {
             // Per-spec we always have to do a command buffer reset that also releases the used resources.
-            result = it.Get()->key->Reset(VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+            result = m_cmdBuffersAlreadyBegun.At(i)->Reset(VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
         }
 
-        // Clear the set of command buffers to reset. Only done if all the buffers were reset successfully so it is
-        // possible that after an error this set will contain already reset command buffers. This is fine because we
+        // Clear the list of command buffers to reset. Only done if all the buffers were reset successfully so it is
+        // possible that after an error this list will contain already reset command buffers. This is fine because we
         // can reset command buffers twice.
-        if ((result == VK_SUCCESS) && (m_cmdBuffersAlreadyBegun.GetNumEntries() > 0))
+        if ((result == VK_SUCCESS) && (m_cmdBuffersAlreadyBegun.IsEmpty() == false))
         {
-            m_cmdBuffersAlreadyBegun.Reset();
+            for (uint32_t i = 0; i < m_cmdBuffersAlreadyBegun.NumElements(); ++i)
+            {
+                m_cmdBuffersAlreadyBegun.At(i)->GetCmdPoolSlots()->begun = CmdPoolSlots::InvalidSlot;
+            }
+
+            m_cmdBuffersAlreadyBegun.Clear();
         }
     }
 
@@ -326,11 +323,53 @@ void CmdPool::Trim()
     }
 }
 
+// =====================================================================================================================
+// Removes the command buffer at the given slot of one of the command buffer lists by moving the last command buffer of
+// the list into its place.
+void CmdPool::RemoveFromList(
+    CmdBufferList* pList,
+    uint32_t       slot,
+    bool           isBegunList)
+{
+    VK_ASSERT(slot < pList->NumElements());
+
+    CmdBuffer* pLastCmdBuffer = nullptr;
+
+    pList->PopBack(&pLastCmdBuffer);
+
+    if (slot < pList->NumElements())
+    {
+        pList->At(slot) = pLastCmdBuffer;
+
+        CmdPoolSlots* pLastSlots = pLastCmdBuffer->GetCmdPoolSlots();
+
+        if (isBegunList)
+        {
+            pLastSlots->begun = slot;
+        }
+        else
+        {
+            pLastSlots->registry = slot;
+        }
+    }
+}
+
 // =====================================================================================================================
 // Register a command buffer with this pool. Used to reset the command buffers at pool reset time.
 Pal::Result CmdPool::RegisterCmdBuffer(CmdBuffer* pCmdBuffer)
 {
-    return m_cmdBufferRegistry.Insert(pCmdBuffer);
+    CmdPoolSlots* pSlots = pCmdBuffer->GetCmdPoolSlots();
+
+    VK_ASSERT(pSlots->registry == CmdPoolSlots::InvalidSlot);
+
+    const Pal::Result result = m_cmdBufferRegistry.PushBack(pCmdBuffer);
+
+    if (result == Pal::Result::Success)
+    {
+        pSlots->registry = m_cmdBufferRegistry.NumElements() - 1;
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -338,34 +377,55 @@ Pal::Result CmdPool::RegisterCmdBuffer(CmdBuffer* pCmdBuffer)
 void CmdPool::UnregisterCmdBuffer(CmdBuffer* pCmdBuffer)
 {
     UnmarkCmdBufBegun(pCmdBuffer);
-    m_cmdBufferRegistry.Erase(pCmdBuffer);
+
+    CmdPoolSlots* pSlots = pCmdBuffer->GetCmdPoolSlots();
+
+    if (pSlots->registry != CmdPoolSlots::InvalidSlot)
+    {
+        RemoveFromList(&m_cmdBufferRegistry, pSlots->registry, false);
+
+        pSlots->registry = CmdPoolSlots::InvalidSlot;
+    }
 }
 
 // =====================================================================================================================
-// Adds command buffer to the set of command buffers needing explicit reset when this cmd pool is reset.
+// Adds command buffer to the list of command buffers needing explicit reset when this cmd pool is reset.
 Pal::Result CmdPool::MarkCmdBufBegun(
     CmdBuffer* pCmdBuffer)
 {
     Pal::Result result = Pal::Result::Success;
 
-    if (IsResetCmdBuffer() == false)
+    CmdPoolSlots* pSlots = pCmdBuffer->GetCmdPoolSlots();
+
+    if ((IsResetCmdBuffer() == false) && (pSlots->begun == CmdPoolSlots::InvalidSlot))
     {
-        result = m_cmdBuffersAlreadyBegun.Insert(pCmdBuffer);
+        result = m_cmdBuffersAlreadyBegun.PushBack(pCmdBuffer);
+
+        if (result == Pal::Result::Success)
+        {
+            pSlots->begun = m_cmdBuffersAlreadyBegun.NumElements() - 1;
+        }
     }
 
     return result;
 }
 
 // =====================================================================================================================
-// Removes command buffer from the set of command buffers needint explicit reset when this cmd pool is reset.
+// Removes command buffer from the list of command buffers needing explicit reset when this cmd pool is reset.
 void CmdPool::UnmarkCmdBufBegun(
     CmdBuffer* pCmdBuffer)
 {
-    // Skip erasing individual command buffers during command pool reset as the command pool reset will instead reset
-    // the entire HashSet all at once after all individual command buffer resets are completed.
-    if ((IsResetCmdBuffer() == false) && (m_cmdPoolResetInProgress == false))
+    CmdPoolSlots* pSlots = pCmdBuffer->GetCmdPoolSlots();
+
+    // Skip erasing individual command buffers during command pool reset as the command pool reset will instead clear
+    // the entire list all at once after all individual command buffer resets are completed.
+    if ((IsResetCmdBuffer() == false)           &&
+        (m_cmdPoolResetInProgress == false)     &&
+        (pSlots->begun != CmdPoolSlots::InvalidSlot))
     {
-        m_cmdBuffersAlreadyBegun.Erase(pCmdBuffer);
+        RemoveFromList(&m_cmdBuffersAlreadyBegun, pSlots->begun, true);
+
+        pSlots->begun = CmdPoolSlots::InvalidSlot;
     }
 }
 
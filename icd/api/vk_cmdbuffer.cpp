@@ -58,8 +58,10 @@
 #include "palFormatInfo.h"
 #include "palVectorImpl.h"
 #include "palAutoBuffer.h"
+#include "palMetroHash.h"
 
 #include <float.h>
+#include <type_traits>
 
 namespace vk
 {
@@ -510,6 +512,45 @@ Pal::Result CreateClearRects(
     return palResult;
 }
 
+// =====================================================================================================================
+// Returns the instantiation of a per PAL device count entry point that matches the device.  The selector is called with
+// a std::integral_constant holding the device count and returns the entry point instantiated for that count.
+template <typename PfnType, typename Selector>
+PfnType SelectNumPalDevicesFunc(
+    const Device* pDevice,
+    Selector      selector)
+{
+    PfnType pFunc = nullptr;
+
+    switch (pDevice->NumPalDevices())
+    {
+        case 1:
+            pFunc = selector(std::integral_constant<uint32_t, 1>());
+            break;
+#if (VKI_BUILD_MAX_NUM_GPUS > 1)
+        case 2:
+            pFunc = selector(std::integral_constant<uint32_t, 2>());
+            break;
+#endif
+#if (VKI_BUILD_MAX_NUM_GPUS > 2)
+        case 3:
+            pFunc = selector(std::integral_constant<uint32_t, 3>());
+            break;
+#endif
+#if (VKI_BUILD_MAX_NUM_GPUS > 3)
+        case 4:
+            pFunc = selector(std::integral_constant<uint32_t, 4>());
+            break;
+#endif
+        default:
+            pFunc = nullptr;
+            VK_NEVER_CALLED();
+            break;
+    }
+
+    return pFunc;
+}
+
 } // anonymous ns
 
 // =====================================================================================================================
@@ -520,6 +561,7 @@ CmdBuffer::CmdBuffer(
     :
     m_pDevice(pDevice),
     m_pCmdPool(pCmdPool),
+    m_cmdPoolSlots{ CmdPoolSlots::InvalidSlot, CmdPoolSlots::InvalidSlot },
     m_queueFamilyIndex(queueFamilyIndex),
     m_palQueueType(pDevice->GetQueueFamilyPalQueueType(queueFamilyIndex)),
     m_palEngineType(pDevice->GetQueueFamilyPalEngineType(queueFamilyIndex)),
@@ -534,7 +576,14 @@ CmdBuffer::CmdBuffer(
     m_pSqttState(nullptr),
     m_renderPassInstance(pDevice->VkInstance()->Allocator()),
     m_pTransformFeedbackState(nullptr),
-    m_palDepthStencilState(pDevice->VkInstance()->Allocator())
+    m_palDepthStencilState(pDevice->VkInstance()->Allocator()),
+    m_depthStencilCache{},
+    m_depthStencilCacheCount(0),
+    m_depthStencilCacheStats{},
+    m_redundantStateStats{},
+    m_barrierAccumulator(pDevice->VkInstance()->Allocator()),
+    m_recordingStats{},
+    m_recordingStartTicks(0)
 {
     m_flags.wasBegun = false;
 
@@ -554,6 +603,10 @@ CmdBuffer::CmdBuffer(
     m_flags.disableResetReleaseResources        = settings.disableResetReleaseResources;
     m_flags.subpassLoadOpClearsBoundAttachments = settings.subpassLoadOpClearsBoundAttachments;
     m_flags.preBindDefaultState                 = settings.preBindDefaultState;
+    m_flags.filterRedundantDynamicState         = settings.filterRedundantDynamicState;
+    m_flags.accumulatePipelineBarriers          = settings.accumulatePipelineBarriers;
+    m_flags.filterRedundantDescriptorSets       = settings.filterRedundantDescriptorSetBinds;
+    m_flags.collectRecordingStats               = settings.enableCmdBufferRecordingStats;
 
     Pal::DeviceProperties info;
     m_pDevice->PalDevice(DefaultDeviceIndex)->GetProperties(&info);
@@ -1210,6 +1263,13 @@ VkResult CmdBuffer::Begin(
     // Beginning a command buffer implicitly resets its state
     ResetState();
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats      = {};
+        m_redundantStateStats = {};
+        m_recordingStartTicks = Util::GetPerfCpuTime();
+    }
+
     const PhysicalDevice*        pPhysicalDevice = m_pDevice->VkPhysicalDevice(DefaultDeviceIndex);
     const Pal::DeviceProperties& deviceProps     = pPhysicalDevice->PalProperties();
 
@@ -1539,6 +1599,8 @@ VkResult CmdBuffer::End(void)
 
     VK_ASSERT(m_flags.isRecording);
 
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCmdBufEnd);
 
     if (m_pSqttState != nullptr)
@@ -1552,6 +1614,48 @@ VkResult CmdBuffer::End(void)
 
     m_flags.isRecording = false;
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.recordingTimeNs = utils::TicksToNano(Util::GetPerfCpuTime() - m_recordingStartTicks);
+
+        // Logged as draws-dispatches-barriers-accumulatedBarriers-barrierFlushes-mergedBarriers-userDataWrites-
+        // stateEmissions-pipelineBinds-embeddedDataBytes-timeNs
+        AmdvlkLog(m_pDevice->GetRuntimeSettings().logTagIdMask,
+                  CmdBufferRecording,
+                  "%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu",
+                  static_cast<unsigned long long>(m_recordingStats.draws),
+                  static_cast<unsigned long long>(m_recordingStats.dispatches),
+                  static_cast<unsigned long long>(m_recordingStats.barriers),
+                  static_cast<unsigned long long>(m_recordingStats.accumulatedBarriers),
+                  static_cast<unsigned long long>(m_recordingStats.barrierFlushes),
+                  static_cast<unsigned long long>(m_recordingStats.mergedBarriers),
+                  static_cast<unsigned long long>(m_recordingStats.userDataWrites),
+                  static_cast<unsigned long long>(m_recordingStats.stateEmissions),
+                  static_cast<unsigned long long>(m_recordingStats.pipelineBinds),
+                  static_cast<unsigned long long>(m_recordingStats.embeddedDataBytes),
+                  static_cast<unsigned long long>(m_recordingStats.recordingTimeNs));
+
+        // Logged as the skipped calls of viewport-scissor-stencilRef-depthStencil-rasterState-inputAssembly-
+        // pointLineRasterState-depthBias-blendConst-depthBounds-lineStipple-descriptorSets, followed by the
+        // descriptor set user data bytes they didn't write
+        AmdvlkLog(m_pDevice->GetRuntimeSettings().logTagIdMask,
+                  CmdBufferRecording,
+                  "Redundant: %llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu-%llu",
+                  static_cast<unsigned long long>(m_redundantStateStats.viewport),
+                  static_cast<unsigned long long>(m_redundantStateStats.scissor),
+                  static_cast<unsigned long long>(m_redundantStateStats.stencilRef),
+                  static_cast<unsigned long long>(m_redundantStateStats.depthStencil),
+                  static_cast<unsigned long long>(m_redundantStateStats.rasterState),
+                  static_cast<unsigned long long>(m_redundantStateStats.inputAssembly),
+                  static_cast<unsigned long long>(m_redundantStateStats.pointLineRasterState),
+                  static_cast<unsigned long long>(m_redundantStateStats.depthBias),
+                  static_cast<unsigned long long>(m_redundantStateStats.blendConst),
+                  static_cast<unsigned long long>(m_redundantStateStats.depthBounds),
+                  static_cast<unsigned long long>(m_redundantStateStats.lineStipple),
+                  static_cast<unsigned long long>(m_redundantStateStats.descriptorSets),
+                  static_cast<unsigned long long>(m_redundantStateStats.descriptorSetUserDataBytes));
+    }
+
     return (m_recordingResult == VK_SUCCESS ? PalToVkResult(result) : m_recordingResult);
 }
 
@@ -1572,6 +1676,11 @@ void CmdBuffer::ResetPipelineState()
     static_assert(DynamicRenderStateToken == 0, "Unexpected value!");
     memset(&m_allGpuState.staticTokens, 0u, sizeof(m_allGpuState.staticTokens));
 
+    // The state programmed in the PAL command buffer is unknown as well, so don't filter any redundant state until it
+    // is written again.
+    m_allGpuState.validGraphics.u32All  = 0;
+    m_allGpuState.validImmediate.u32All = 0;
+
     memset(&m_allGpuState.depthStencilCreateInfo, 0u, sizeof(m_allGpuState.depthStencilCreateInfo));
 
     memset(&m_allGpuState.samplePattern, 0u, sizeof(m_allGpuState.samplePattern));
@@ -1585,6 +1694,7 @@ void CmdBuffer::ResetPipelineState()
             sizeof(m_allGpuState.pipelineState[bindIdx].userDataLayout));
 
         m_allGpuState.pipelineState[bindIdx].boundSetCount    = 0;
+        m_allGpuState.pipelineState[bindIdx].validSetMask     = 0;
         m_allGpuState.pipelineState[bindIdx].pushedConstCount = 0;
         m_allGpuState.pipelineState[bindIdx].dynamicBindInfo  = {};
 
@@ -1642,6 +1752,9 @@ void CmdBuffer::ResetState()
 
     m_flags.hasConditionalRendering = false;
 
+    // Barriers left pending by a command buffer that was never ended are dropped along with the rest of its commands.
+    m_barrierAccumulator.Clear();
+
 }
 
 // =====================================================================================================================
@@ -1832,6 +1945,11 @@ void CmdBuffer::BindPipeline(
 {
     DbgBarrierPreCmd(DbgBarrierBindPipeline);
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.pipelineBinds++;
+    }
+
     const Pipeline* pPipeline = Pipeline::BaseObjectFromHandle(pipeline);
 
     switch (pipelineBindPoint)
@@ -1917,6 +2035,68 @@ CmdBuffer::RebindUserDataFlags CmdBuffer::SwitchUserDataLayouts(
     return flags;
 }
 
+// =====================================================================================================================
+// Records that the binding data shadow range of a descriptor set was rewritten.  Valid sets overlapping the range no
+// longer match the programmed user data, and the set itself only does if its user data was programmed.
+static void UpdateValidSetUserData(
+    PipelineBindState* pBindState,
+    uint32_t           setIdx,
+    uint32_t           regOffset,
+    uint32_t           regCount,
+    bool               programmed)
+{
+    uint32_t overlapMask = pBindState->validSetMask & ~(1u << setIdx);
+    uint32_t validIdx    = 0;
+
+    while (Util::BitMaskScanForward(&validIdx, overlapMask))
+    {
+        const SetUserDataRange& validRange = pBindState->validSetRange[validIdx];
+
+        if ((validRange.regOffset < (regOffset + regCount)) &&
+            (regOffset < (validRange.regOffset + validRange.regCount)))
+        {
+            pBindState->validSetMask &= ~(1u << validIdx);
+        }
+
+        overlapMask &= ~(1u << validIdx);
+    }
+
+    if (programmed)
+    {
+        pBindState->validSetMask |= (1u << setIdx);
+
+        pBindState->validSetRange[setIdx].regOffset = regOffset;
+        pBindState->validSetRange[setIdx].regCount  = regCount;
+    }
+    else
+    {
+        pBindState->validSetMask &= ~(1u << setIdx);
+    }
+}
+
+// =====================================================================================================================
+// Drops the valid descriptor sets whose binding data shadow range was not reprogrammed by a user data rebind of the
+// first regCount registers.
+static void ClipValidSetUserData(
+    PipelineBindState* pBindState,
+    uint32_t           regCount)
+{
+    uint32_t validMask = pBindState->validSetMask;
+    uint32_t validIdx  = 0;
+
+    while (Util::BitMaskScanForward(&validIdx, validMask))
+    {
+        const SetUserDataRange& validRange = pBindState->validSetRange[validIdx];
+
+        if ((validRange.regOffset + validRange.regCount) > regCount)
+        {
+            pBindState->validSetMask &= ~(1u << validIdx);
+        }
+
+        validMask &= ~(1u << validIdx);
+    }
+}
+
 // =====================================================================================================================
 // Called during vkCmdBindPipeline when something requires rebinding API-provided top-level user data (descriptor
 // sets, push constants, etc.)
@@ -1947,9 +2127,17 @@ void CmdBuffer::RebindUserData(
                     userDataLayout.setBindingRegBase,
                     count,
                     PerGpuState(deviceIdx)->setBindingData[apiBindPoint]);
+
+                if (m_flags.collectRecordingStats)
+                {
+                    m_recordingStats.userDataWrites++;
+                }
             }
             while (deviceGroup.IterateNext());
         }
+
+        // Valid sets keep matching the user data only if they were reprogrammed at the new register base.
+        ClipValidSetUserData(&m_allGpuState.pipelineState[apiBindPoint], count);
     }
 
     if ((flags & RebindUserDataPushConstants) != 0)
@@ -1978,6 +2166,8 @@ void CmdBuffer::ExecuteCommands(
     uint32_t                                    cmdBufferCount,
     const VkCommandBuffer*                      pCmdBuffers)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierExecuteCommands);
 
     for (uint32_t i = 0; i < cmdBufferCount; i++)
@@ -2039,6 +2229,94 @@ VkResult CmdBuffer::Destroy(void)
     return VK_SUCCESS;
 }
 
+// =====================================================================================================================
+// Returns the slot of m_depthStencilCache where the lookup of the given create info starts.
+static uint32_t GetDepthStencilCacheSlot(
+    const Pal::DepthStencilStateCreateInfo& createInfo,
+    uint32_t                                cacheSize)
+{
+    uint64_t hash = 0;
+
+    Util::MetroHash64::Hash(
+        reinterpret_cast<const uint8_t*>(&createInfo), sizeof(createInfo), reinterpret_cast<uint8_t*>(&hash));
+
+    return static_cast<uint32_t>(hash) & (cacheSize - 1);
+}
+
+// =====================================================================================================================
+// Looks up the dynamic depth-stencil states this command buffer has already created for the given create info, which
+// avoids a round trip through the device wide RenderStateCache. Returns false on a miss.
+bool CmdBuffer::FindDynamicDepthStencil(
+    const Pal::DepthStencilStateCreateInfo& createInfo,
+    Pal::IDepthStencilState**               ppPalDepthStencil)
+{
+    bool found = false;
+
+    if (m_depthStencilCacheCount > 0)
+    {
+        uint32_t slot = GetDepthStencilCacheSlot(createInfo, DepthStencilCacheSize);
+
+        // The cache is never filled completely, so the probe ends at an empty slot.
+        while (m_depthStencilCache[slot].states.pPalDepthStencil[0] != nullptr)
+        {
+            const DynamicDepthStencilCacheEntry& entry = m_depthStencilCache[slot];
+
+            if (memcmp(&entry.createInfo, &createInfo, sizeof(createInfo)) == 0)
+            {
+                for (uint32_t i = 0; i < MaxPalDevices; ++i)
+                {
+                    ppPalDepthStencil[i] = entry.states.pPalDepthStencil[i];
+                }
+
+                found = true;
+                break;
+            }
+
+            slot = (slot + 1) & (DepthStencilCacheSize - 1);
+        }
+    }
+
+    if (found)
+    {
+        m_depthStencilCacheStats.hits++;
+    }
+    else
+    {
+        m_depthStencilCacheStats.misses++;
+    }
+
+    return found;
+}
+
+// =====================================================================================================================
+// Remembers the dynamic depth-stencil states created for the given create info. The states must be owned by
+// m_palDepthStencilState. Once the cache is three quarters full, further states are only tracked there.
+void CmdBuffer::CacheDynamicDepthStencil(
+    const Pal::DepthStencilStateCreateInfo& createInfo,
+    Pal::IDepthStencilState* const*         ppPalDepthStencil)
+{
+    if (m_depthStencilCacheCount < ((DepthStencilCacheSize * 3) / 4))
+    {
+        uint32_t slot = GetDepthStencilCacheSlot(createInfo, DepthStencilCacheSize);
+
+        while (m_depthStencilCache[slot].states.pPalDepthStencil[0] != nullptr)
+        {
+            slot = (slot + 1) & (DepthStencilCacheSize - 1);
+        }
+
+        DynamicDepthStencilCacheEntry* pEntry = &m_depthStencilCache[slot];
+
+        pEntry->createInfo = createInfo;
+
+        for (uint32_t i = 0; i < MaxPalDevices; ++i)
+        {
+            pEntry->states.pPalDepthStencil[i] = ppPalDepthStencil[i];
+        }
+
+        m_depthStencilCacheCount++;
+    }
+}
+
 // =====================================================================================================================
 void CmdBuffer::ReleaseResources()
 {
@@ -2054,6 +2332,12 @@ void CmdBuffer::ReleaseResources()
 
     m_palDepthStencilState.Clear();
 
+    if (m_depthStencilCacheCount > 0)
+    {
+        memset(m_depthStencilCache, 0, sizeof(m_depthStencilCache));
+        m_depthStencilCacheCount = 0;
+    }
+
     // Release per-attachment render pass instance memory
     if (m_renderPassInstance.pAttachments != nullptr)
     {
@@ -2108,6 +2392,15 @@ void CmdBuffer::BindDescriptorSets(
         // Update descriptor set binding data shadow.
         VK_ASSERT((firstSet + setCount) <= layoutInfo.setCount);
 
+        PipelineBindState* pBindState = &m_allGpuState.pipelineState[apiBindPoint];
+
+        // Sets rebound with the same set pointer and dynamic descriptors as those already programmed can be skipped,
+        // which is only tracked for the compact scheme.
+        const bool filterSets = (m_flags.filterRedundantDescriptorSets != 0) &&
+                                (pLayout->GetScheme() == PipelineLayoutScheme::Compact);
+
+        uint32_t changedSetMask = 0;
+
         for (uint32_t i = 0; i < setCount; ++i)
         {
             // Compute set binding point index
@@ -2116,62 +2409,99 @@ void CmdBuffer::BindDescriptorSets(
             // User data information for this set
             const PipelineLayout::SetUserDataLayout& setLayoutInfo = pLayout->GetSetUserData(setBindIdx);
 
-            // If this descriptor set has any dynamic descriptor data then write them into the shadow.
-            if (setLayoutInfo.dynDescCount > 0)
+            // The previous shadow contents are only worth comparing against if they are programmed at the same range.
+            const bool checkRedundant = filterSets &&
+                ((pBindState->validSetMask & (1u << setBindIdx)) != 0) &&
+                (pBindState->validSetRange[setBindIdx].regOffset == setLayoutInfo.firstRegOffset) &&
+                (pBindState->validSetRange[setBindIdx].regCount  == setLayoutInfo.totalRegCount);
+
+            bool setChanged = (checkRedundant == false);
+
+            uint32_t prevSetData[MaxDynDescRegCount + PipelineLayout::SetPtrRegCount];
+
+            VK_ASSERT((checkRedundant == false) || (setLayoutInfo.totalRegCount <= VK_ARRAY_SIZE(prevSetData)));
+
+            utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
+            do
             {
-                // NOTE: We supply patched SRDs directly in used data registers.
-                utils::IterateMask deviceGroup(m_curDeviceMask);
-                do
+                const uint32_t deviceIdx = deviceGroup.Index();
+
+                uint32_t* pSetData = &(PerGpuState(deviceIdx)->setBindingData[apiBindPoint][0]);
+
+                if (checkRedundant)
                 {
-                    const uint32_t deviceIdx = deviceGroup.Index();
+                    memcpy(prevSetData,
+                           &pSetData[setLayoutInfo.firstRegOffset],
+                           setLayoutInfo.totalRegCount * sizeof(uint32_t));
+                }
 
+                // If this descriptor set has any dynamic descriptor data then write them into the shadow.
+                // NOTE: We supply patched SRDs directly in used data registers.
+                if (setLayoutInfo.dynDescCount > 0)
+                {
                     DescriptorSet<numPalDevices>::PatchedDynamicDataFromHandle(
                         pDescriptorSets[i],
                         deviceIdx,
-                        &(PerGpuState(deviceIdx)->
-                            setBindingData[apiBindPoint][setLayoutInfo.dynDescDataRegOffset]),
+                        &pSetData[setLayoutInfo.dynDescDataRegOffset],
                         pDynamicOffsets,
                         setLayoutInfo.dynDescCount,
                         useCompactDescriptor);
-
                 }
-                while (deviceGroup.IterateNext());
-
-                // Skip over the already consumed dynamic offsets.
-                pDynamicOffsets += setLayoutInfo.dynDescCount;
-            }
-
-            // If this descriptor set needs a set pointer, then write it to the shadow.
-            if (setLayoutInfo.setPtrRegOffset != PipelineLayout::InvalidReg)
-            {
-                utils::IterateMask deviceGroup(m_curDeviceMask);
 
-                do
+                // If this descriptor set needs a set pointer, then write it to the shadow.
+                if (setLayoutInfo.setPtrRegOffset != PipelineLayout::InvalidReg)
                 {
-                    const uint32_t deviceIdx = deviceGroup.Index();
-
                     DescriptorSet<numPalDevices>::UserDataPtrValueFromHandle(
                         pDescriptorSets[i],
                         deviceIdx,
-                        &(PerGpuState(deviceIdx)->
-                            setBindingData[apiBindPoint][setLayoutInfo.setPtrRegOffset]));
+                        &pSetData[setLayoutInfo.setPtrRegOffset]);
                 }
-                while (deviceGroup.IterateNext());
+
+                if ((setChanged == false) &&
+                    (memcmp(prevSetData,
+                            &pSetData[setLayoutInfo.firstRegOffset],
+                            setLayoutInfo.totalRegCount * sizeof(uint32_t)) != 0))
+                {
+                    setChanged = true;
+                }
+            }
+            while (deviceGroup.IterateNext());
+
+            // Skip over the already consumed dynamic offsets.
+            pDynamicOffsets += setLayoutInfo.dynDescCount;
+
+            if (setChanged)
+            {
+                changedSetMask |= (1u << i);
+            }
+            else if (m_flags.collectRecordingStats)
+            {
+                m_redundantStateStats.descriptorSets++;
+                m_redundantStateStats.descriptorSetUserDataBytes +=
+                    setLayoutInfo.totalRegCount * sizeof(uint32_t) * Util::CountSetBits(m_curDeviceMask);
             }
         }
 
-        SetUserDataPipelineLayout(firstSet, setCount, pLayout, palBindPoint, apiBindPoint);
+        SetUserDataPipelineLayout<numPalDevices>(
+            firstSet,
+            setCount,
+            changedSetMask,
+            pLayout,
+            palBindPoint,
+            apiBindPoint);
     }
 
     DbgBarrierPostCmd(DbgBarrierBindSetsPushConstants);
 }
 
 // =====================================================================================================================
-
-// =====================================================================================================================
+// Programs the user data of the descriptor sets [firstSet, firstSet + setCount) from the binding data shadow.  Only the
+// sets whose bit (relative to firstSet) is included in setMask are programmed; the others are known to be unchanged.
+template <uint32_t numPalDevices>
 void CmdBuffer::SetUserDataPipelineLayout(
     uint32_t                      firstSet,
     uint32_t                      setCount,
+    uint32_t                      setMask,
     const PipelineLayout*         pLayout,
     const Pal::PipelineBindPoint  palBindPoint,
     const PipelineBindPoint       apiBindPoint)
@@ -2181,37 +2511,71 @@ void CmdBuffer::SetUserDataPipelineLayout(
     // Get user data register information from the given pipeline layout
     const PipelineLayout::Info& layoutInfo = pLayout->GetInfo();
 
+    // Get the current binding state in the command buffer
+    PipelineBindState* pBindState = &m_allGpuState.pipelineState[apiBindPoint];
+
     if (pLayout->GetScheme() == PipelineLayoutScheme::Compact)
     {
-        // Get the current binding state in the command buffer
-        PipelineBindState* pBindState = &m_allGpuState.pipelineState[apiBindPoint];
-
         // Figure out the total range of user data registers written by this sequence of descriptor set binds
-        const PipelineLayout::SetUserDataLayout& firstSetLayout = pLayout->GetSetUserData(firstSet);
         const PipelineLayout::SetUserDataLayout& lastSetLayout = pLayout->GetSetUserData(firstSet + setCount - 1);
 
-        const uint32_t rangeOffsetBegin = firstSetLayout.firstRegOffset;
         const uint32_t rangeOffsetEnd = lastSetLayout.firstRegOffset + lastSetLayout.totalRegCount;
 
         // Update the high watermark of number of user data entries written for currently bound descriptor sets and
         // their dynamic offsets in the current command buffer state.
         pBindState->boundSetCount = Util::Max(pBindState->boundSetCount, rangeOffsetEnd);
 
-        // Descriptor set with zero resource binding is allowed in spec, so we need to check this and only proceed
-        // when there are at least 1 user data to update.
-        const uint32_t rangeRegCount = rangeOffsetEnd - rangeOffsetBegin;
+        // Program the user data register only if the current user data layout base matches that of the given
+        // layout.  Otherwise, what's happening is that the application is binding descriptor sets for a future
+        // pipeline layout (e.g. at the top of the command buffer) and this register write will be redundant.
+        // A future vkCmdBindPipeline will reprogram the user data register.
+        const bool programUserData = PalPipelineBindingOwnedBy(palBindPoint, apiBindPoint) &&
+                                     (pBindState->userDataLayout.compact.setBindingRegBase ==
+                                        layoutInfo.userDataLayout.compact.setBindingRegBase);
+
+        uint32_t setIdx = firstSet;
 
-        if (rangeRegCount > 0)
+        while (setIdx < (firstSet + setCount))
         {
-            // Program the user data register only if the current user data layout base matches that of the given
-            // layout.  Otherwise, what's happening is that the application is binding descriptor sets for a future
-            // pipeline layout (e.g. at the top of the command buffer) and this register write will be redundant.
-            // A future vkCmdBindPipeline will reprogram the user data register.
-            if (PalPipelineBindingOwnedBy(palBindPoint, apiBindPoint) &&
-                (pBindState->userDataLayout.compact.setBindingRegBase ==
-                    layoutInfo.userDataLayout.compact.setBindingRegBase))
+            // Skip over the sets which don't need to be programmed and find the next run of consecutive ones which do.
+            if ((setMask & (1u << (setIdx - firstSet))) == 0)
+            {
+                setIdx++;
+
+                continue;
+            }
+
+            const uint32_t runFirstSet = setIdx;
+
+            while ((setIdx < (firstSet + setCount)) && ((setMask & (1u << (setIdx - firstSet))) != 0))
             {
-                utils::IterateMask deviceGroup(m_curDeviceMask);
+                const PipelineLayout::SetUserDataLayout& setLayoutInfo = pLayout->GetSetUserData(setIdx);
+
+                if (m_flags.filterRedundantDescriptorSets)
+                {
+                    UpdateValidSetUserData(
+                        pBindState,
+                        setIdx,
+                        setLayoutInfo.firstRegOffset,
+                        setLayoutInfo.totalRegCount,
+                        programUserData);
+                }
+
+                setIdx++;
+            }
+
+            const PipelineLayout::SetUserDataLayout& runFirstLayout = pLayout->GetSetUserData(runFirstSet);
+            const PipelineLayout::SetUserDataLayout& runLastLayout  = pLayout->GetSetUserData(setIdx - 1);
+
+            const uint32_t rangeOffsetBegin = runFirstLayout.firstRegOffset;
+            const uint32_t rangeRegCount    = runLastLayout.firstRegOffset + runLastLayout.totalRegCount -
+                                              rangeOffsetBegin;
+
+            // Descriptor set with zero resource binding is allowed in spec, so we need to check this and only proceed
+            // when there are at least 1 user data to update.
+            if (programUserData && (rangeRegCount > 0))
+            {
+                utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
                 do
                 {
                     const uint32_t deviceIdx = deviceGroup.Index();
@@ -2221,6 +2585,11 @@ void CmdBuffer::SetUserDataPipelineLayout(
                         pBindState->userDataLayout.compact.setBindingRegBase + rangeOffsetBegin,
                         rangeRegCount,
                         &(PerGpuState(deviceIdx)->setBindingData[apiBindPoint][rangeOffsetBegin]));
+
+                    if (m_flags.collectRecordingStats)
+                    {
+                        m_recordingStats.userDataWrites++;
+                    }
                 }
                 while (deviceGroup.IterateNext());
             }
@@ -2230,11 +2599,14 @@ void CmdBuffer::SetUserDataPipelineLayout(
     {
         const auto& userDataLayout = layoutInfo.userDataLayout.indirect;
 
+        // The indirect scheme programs user data registers which may overlap those of compact descriptor sets.
+        pBindState->validSetMask = 0;
+
         for (uint32_t setIdx = firstSet; setIdx < firstSet + setCount; ++setIdx)
         {
             const PipelineLayout::SetUserDataLayout& setLayoutInfo = pLayout->GetSetUserData(setIdx);
 
-            utils::IterateMask deviceGroup(m_curDeviceMask);
+            utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
             do
             {
                 const uint32_t deviceIdx = deviceGroup.Index();
@@ -2251,6 +2623,11 @@ void CmdBuffer::SetUserDataPipelineLayout(
                         m_pDevice->GetProperties().descriptorSizes.alignmentInDwords,
                         &gpuAddr);
 
+                    if (m_flags.collectRecordingStats)
+                    {
+                        m_recordingStats.embeddedDataBytes += dynBufferSizeDw * sizeof(uint32_t);
+                    }
+
                     const uint32_t gpuAddrLow = static_cast<uint32_t>(gpuAddr);
 
                     memcpy(pCpuAddr,
@@ -2262,6 +2639,11 @@ void CmdBuffer::SetUserDataPipelineLayout(
                         userDataLayout.setBindingPtrRegBase + 2 * setIdx * PipelineLayout::SetPtrRegCount,
                         PipelineLayout::SetPtrRegCount,
                         &gpuAddrLow);
+
+                    if (m_flags.collectRecordingStats)
+                    {
+                        m_recordingStats.userDataWrites++;
+                    }
                 }
 
                 if (setLayoutInfo.setPtrRegOffset != PipelineLayout::InvalidReg)
@@ -2271,6 +2653,11 @@ void CmdBuffer::SetUserDataPipelineLayout(
                         userDataLayout.setBindingPtrRegBase + (2 * setIdx + 1) * PipelineLayout::SetPtrRegCount,
                         PipelineLayout::SetPtrRegCount,
                         &(PerGpuState(deviceIdx)->setBindingData[apiBindPoint][setLayoutInfo.setPtrRegOffset]));
+
+                    if (m_flags.collectRecordingStats)
+                    {
+                        m_recordingStats.userDataWrites++;
+                    }
                 }
             }
             while (deviceGroup.IterateNext());
@@ -2359,64 +2746,208 @@ PFN_vkCmdBindDescriptorSets CmdBuffer::GetCmdBindDescriptorSetsFunc(
 }
 
 // =====================================================================================================================
-template <size_t imageDescSize,
-          size_t samplerDescSize,
-          size_t bufferDescSize,
-          uint32_t numPalDevices>
-VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdPushDescriptorSetKHR(
-    VkCommandBuffer                             commandBuffer,
-    VkPipelineBindPoint                         pipelineBindPoint,
-    VkPipelineLayout                            layout,
-    uint32_t                                    set,
-    uint32_t                                    descriptorWriteCount,
-    const VkWriteDescriptorSet*                 pDescriptorWrites)
+template <uint32_t numPalDevices>
+VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdBindVertexBuffers(
+    VkCommandBuffer                             cmdBuffer,
+    uint32_t                                    firstBinding,
+    uint32_t                                    bindingCount,
+    const VkBuffer*                             pBuffers,
+    const VkDeviceSize*                         pOffsets)
 {
-    CmdBuffer* pCmdBuffer = ApiCmdBuffer::ObjectFromHandle(commandBuffer);
-
-    pCmdBuffer->PushDescriptorSetKHR<imageDescSize, samplerDescSize, bufferDescSize, numPalDevices>(
-        pipelineBindPoint,
-        layout,
-        set,
-        descriptorWriteCount,
-        pDescriptorWrites);
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->BindVertexBuffers<numPalDevices>(
+        firstBinding,
+        bindingCount,
+        pBuffers,
+        pOffsets,
+        nullptr,
+        nullptr);
 }
 
 // =====================================================================================================================
 template <uint32_t numPalDevices>
-PFN_vkCmdPushDescriptorSetKHR CmdBuffer::GetCmdPushDescriptorSetKHRFunc(
-    const Device* pDevice)
+VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdBindVertexBuffers2(
+    VkCommandBuffer                             cmdBuffer,
+    uint32_t                                    firstBinding,
+    uint32_t                                    bindingCount,
+    const VkBuffer*                             pBuffers,
+    const VkDeviceSize*                         pOffsets,
+    const VkDeviceSize*                         pSizes,
+    const VkDeviceSize*                         pStrides)
 {
-    const size_t imageDescSize   = pDevice->GetProperties().descriptorSizes.imageView;
-    const size_t samplerDescSize = pDevice->GetProperties().descriptorSizes.sampler;
-    const size_t bufferDescSize  = pDevice->GetProperties().descriptorSizes.bufferView;
-
-    PFN_vkCmdPushDescriptorSetKHR pFunc = nullptr;
-
-    if ((imageDescSize   == 32) &&
-        (samplerDescSize == 16) &&
-        (bufferDescSize  == 16))
-    {
-        pFunc = &CmdPushDescriptorSetKHR<
-            32,
-            16,
-            16,
-            numPalDevices>;
-    }
-    else
-    {
-        VK_NEVER_CALLED();
-    }
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->BindVertexBuffers<numPalDevices>(
+        firstBinding,
+        bindingCount,
+        pBuffers,
+        pOffsets,
+        pSizes,
+        pStrides);
+}
 
-    return pFunc;
+// =====================================================================================================================
+template <uint32_t numPalDevices>
+VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdSetViewport(
+    VkCommandBuffer                             cmdBuffer,
+    uint32_t                                    firstViewport,
+    uint32_t                                    viewportCount,
+    const VkViewport*                           pViewports)
+{
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->SetViewport<numPalDevices>(
+        firstViewport,
+        viewportCount,
+        pViewports);
 }
 
 // =====================================================================================================================
-PFN_vkCmdPushDescriptorSetKHR CmdBuffer::GetCmdPushDescriptorSetKHRFunc(
-    const Device* pDevice)
+template <uint32_t numPalDevices>
+VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdSetViewportWithCount(
+    VkCommandBuffer                             cmdBuffer,
+    uint32_t                                    viewportCount,
+    const VkViewport*                           pViewports)
 {
-    PFN_vkCmdPushDescriptorSetKHR pFunc = nullptr;
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->SetViewportWithCount<numPalDevices>(
+        viewportCount,
+        pViewports);
+}
 
-    switch (pDevice->NumPalDevices())
+// =====================================================================================================================
+template <uint32_t numPalDevices>
+VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdSetScissor(
+    VkCommandBuffer                             cmdBuffer,
+    uint32_t                                    firstScissor,
+    uint32_t                                    scissorCount,
+    const VkRect2D*                             pScissors)
+{
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->SetScissor<numPalDevices>(
+        firstScissor,
+        scissorCount,
+        pScissors);
+}
+
+// =====================================================================================================================
+template <uint32_t numPalDevices>
+VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdSetScissorWithCount(
+    VkCommandBuffer                             cmdBuffer,
+    uint32_t                                    scissorCount,
+    const VkRect2D*                             pScissors)
+{
+    ApiCmdBuffer::ObjectFromHandle(cmdBuffer)->SetScissorWithCount<numPalDevices>(
+        scissorCount,
+        pScissors);
+}
+
+// =====================================================================================================================
+PFN_vkCmdBindVertexBuffers CmdBuffer::GetCmdBindVertexBuffersFunc(
+    const Device* pDevice)
+{
+    return SelectNumPalDevicesFunc<PFN_vkCmdBindVertexBuffers>(
+        pDevice,
+        [](auto numPalDevices) { return &CmdBuffer::CmdBindVertexBuffers<decltype(numPalDevices)::value>; });
+}
+
+// =====================================================================================================================
+PFN_vkCmdBindVertexBuffers2 CmdBuffer::GetCmdBindVertexBuffers2Func(
+    const Device* pDevice)
+{
+    return SelectNumPalDevicesFunc<PFN_vkCmdBindVertexBuffers2>(
+        pDevice,
+        [](auto numPalDevices) { return &CmdBuffer::CmdBindVertexBuffers2<decltype(numPalDevices)::value>; });
+}
+
+// =====================================================================================================================
+PFN_vkCmdSetViewport CmdBuffer::GetCmdSetViewportFunc(
+    const Device* pDevice)
+{
+    return SelectNumPalDevicesFunc<PFN_vkCmdSetViewport>(
+        pDevice,
+        [](auto numPalDevices) { return &CmdBuffer::CmdSetViewport<decltype(numPalDevices)::value>; });
+}
+
+// =====================================================================================================================
+PFN_vkCmdSetViewportWithCount CmdBuffer::GetCmdSetViewportWithCountFunc(
+    const Device* pDevice)
+{
+    return SelectNumPalDevicesFunc<PFN_vkCmdSetViewportWithCount>(
+        pDevice,
+        [](auto numPalDevices) { return &CmdBuffer::CmdSetViewportWithCount<decltype(numPalDevices)::value>; });
+}
+
+// =====================================================================================================================
+PFN_vkCmdSetScissor CmdBuffer::GetCmdSetScissorFunc(
+    const Device* pDevice)
+{
+    return SelectNumPalDevicesFunc<PFN_vkCmdSetScissor>(
+        pDevice,
+        [](auto numPalDevices) { return &CmdBuffer::CmdSetScissor<decltype(numPalDevices)::value>; });
+}
+
+// =====================================================================================================================
+PFN_vkCmdSetScissorWithCount CmdBuffer::GetCmdSetScissorWithCountFunc(
+    const Device* pDevice)
+{
+    return SelectNumPalDevicesFunc<PFN_vkCmdSetScissorWithCount>(
+        pDevice,
+        [](auto numPalDevices) { return &CmdBuffer::CmdSetScissorWithCount<decltype(numPalDevices)::value>; });
+}
+
+// =====================================================================================================================
+template <size_t imageDescSize,
+          size_t samplerDescSize,
+          size_t bufferDescSize,
+          uint32_t numPalDevices>
+VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdPushDescriptorSetKHR(
+    VkCommandBuffer                             commandBuffer,
+    VkPipelineBindPoint                         pipelineBindPoint,
+    VkPipelineLayout                            layout,
+    uint32_t                                    set,
+    uint32_t                                    descriptorWriteCount,
+    const VkWriteDescriptorSet*                 pDescriptorWrites)
+{
+    CmdBuffer* pCmdBuffer = ApiCmdBuffer::ObjectFromHandle(commandBuffer);
+
+    pCmdBuffer->PushDescriptorSetKHR<imageDescSize, samplerDescSize, bufferDescSize, numPalDevices>(
+        pipelineBindPoint,
+        layout,
+        set,
+        descriptorWriteCount,
+        pDescriptorWrites);
+}
+
+// =====================================================================================================================
+template <uint32_t numPalDevices>
+PFN_vkCmdPushDescriptorSetKHR CmdBuffer::GetCmdPushDescriptorSetKHRFunc(
+    const Device* pDevice)
+{
+    const size_t imageDescSize   = pDevice->GetProperties().descriptorSizes.imageView;
+    const size_t samplerDescSize = pDevice->GetProperties().descriptorSizes.sampler;
+    const size_t bufferDescSize  = pDevice->GetProperties().descriptorSizes.bufferView;
+
+    PFN_vkCmdPushDescriptorSetKHR pFunc = nullptr;
+
+    if ((imageDescSize   == 32) &&
+        (samplerDescSize == 16) &&
+        (bufferDescSize  == 16))
+    {
+        pFunc = &CmdPushDescriptorSetKHR<
+            32,
+            16,
+            16,
+            numPalDevices>;
+    }
+    else
+    {
+        VK_NEVER_CALLED();
+    }
+
+    return pFunc;
+}
+
+// =====================================================================================================================
+PFN_vkCmdPushDescriptorSetKHR CmdBuffer::GetCmdPushDescriptorSetKHRFunc(
+    const Device* pDevice)
+{
+    PFN_vkCmdPushDescriptorSetKHR pFunc = nullptr;
+
+    switch (pDevice->NumPalDevices())
     {
         case 1:
             pFunc = GetCmdPushDescriptorSetKHRFunc<1>(pDevice);
@@ -2562,6 +3093,7 @@ void CmdBuffer::ResetVertexBuffer()
 
 // =====================================================================================================================
 // Implementation of vkCmdBindVertexBuffers
+template <uint32_t numPalDevices>
 void CmdBuffer::BindVertexBuffers(
     uint32_t            firstBinding,
     uint32_t            bindingCount,
@@ -2574,7 +3106,7 @@ void CmdBuffer::BindVertexBuffers(
 
     const bool padVertexBuffers = m_flags.padVertexBuffers;
 
-    utils::IterateMask deviceGroup(GetDeviceMask());
+    utils::IterateDeviceMask<numPalDevices> deviceGroup(GetDeviceMask());
     do
     {
         const uint32_t deviceIdx = deviceGroup.Index();
@@ -2689,10 +3221,17 @@ void CmdBuffer::Draw(
     uint32_t firstInstance,
     uint32_t instanceCount)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierDrawNonIndexed);
 
     ValidateStates();
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.draws++;
+    }
+
     {
         PalCmdDraw(firstVertex,
             vertexCount,
@@ -2712,10 +3251,17 @@ void CmdBuffer::DrawIndexed(
     uint32_t firstInstance,
     uint32_t instanceCount)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierDrawIndexed);
 
     ValidateStates();
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.draws++;
+    }
+
     {
         PalCmdDrawIndexed(firstIndex,
                           indexCount,
@@ -2728,6 +3274,102 @@ void CmdBuffer::DrawIndexed(
     DbgBarrierPostCmd(DbgBarrierDrawIndexed);
 }
 
+// =====================================================================================================================
+// Records the draws of vkCmdDrawMultiEXT. The render state is validated once for the whole batch since it can't change
+// between the draws, which only differ in their vertex range and draw index.
+void CmdBuffer::DrawMulti(
+    uint32_t                  drawCount,
+    const VkMultiDrawInfoEXT* pVertexInfo,
+    uint32_t                  instanceCount,
+    uint32_t                  firstInstance,
+    uint32_t                  stride)
+{
+    FlushPendingBarriers();
+
+    DbgBarrierPreCmd(DbgBarrierDrawNonIndexed);
+
+    ValidateStates();
+
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.draws += drawCount;
+    }
+
+    // Currently only Vulkan graphics pipelines use PAL graphics pipeline bindings so there's no need to
+    // add a delayed validation check for graphics.
+    VK_ASSERT(PalPipelineBindingOwnedBy(Pal::PipelineBindPoint::Graphics, PipelineBindGraphics));
+
+    utils::IterateMask deviceGroup(m_curDeviceMask);
+    do
+    {
+        Pal::ICmdBuffer* pPalCmdBuffer = PalCmdBuffer(deviceGroup.Index());
+
+        for (uint32_t drawIdx = 0; drawIdx < drawCount; ++drawIdx)
+        {
+            const auto* pDraw = static_cast<const VkMultiDrawInfoEXT*>(
+                Util::VoidPtrInc(pVertexInfo, static_cast<size_t>(drawIdx) * stride));
+
+            pPalCmdBuffer->CmdDraw(pDraw->firstVertex,
+                pDraw->vertexCount,
+                firstInstance,
+                instanceCount,
+                drawIdx);
+        }
+    }
+    while (deviceGroup.IterateNext());
+
+    DbgBarrierPostCmd(DbgBarrierDrawNonIndexed);
+}
+
+// =====================================================================================================================
+// Records the draws of vkCmdDrawMultiIndexedEXT, see DrawMulti. If pVertexOffset is given, it replaces the vertex
+// offsets of all draws.
+void CmdBuffer::DrawMultiIndexed(
+    uint32_t                         drawCount,
+    const VkMultiDrawIndexedInfoEXT* pIndexInfo,
+    uint32_t                         instanceCount,
+    uint32_t                         firstInstance,
+    uint32_t                         stride,
+    const int32_t*                   pVertexOffset)
+{
+    FlushPendingBarriers();
+
+    DbgBarrierPreCmd(DbgBarrierDrawIndexed);
+
+    ValidateStates();
+
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.draws += drawCount;
+    }
+
+    // Currently only Vulkan graphics pipelines use PAL graphics pipeline bindings so there's no need to
+    // add a delayed validation check for graphics.
+    VK_ASSERT(PalPipelineBindingOwnedBy(Pal::PipelineBindPoint::Graphics, PipelineBindGraphics));
+
+    utils::IterateMask deviceGroup(m_curDeviceMask);
+    do
+    {
+        Pal::ICmdBuffer* pPalCmdBuffer = PalCmdBuffer(deviceGroup.Index());
+
+        for (uint32_t drawIdx = 0; drawIdx < drawCount; ++drawIdx)
+        {
+            const auto* pDraw = static_cast<const VkMultiDrawIndexedInfoEXT*>(
+                Util::VoidPtrInc(pIndexInfo, static_cast<size_t>(drawIdx) * stride));
+
+            pPalCmdBuffer->CmdDrawIndexed(pDraw->firstIndex,
+                pDraw->indexCount,
+                (pVertexOffset != nullptr) ? *pVertexOffset : pDraw->vertexOffset,
+                firstInstance,
+                instanceCount,
+                drawIdx);
+        }
+    }
+    while (deviceGroup.IterateNext());
+
+    DbgBarrierPostCmd(DbgBarrierDrawIndexed);
+}
+
 // =====================================================================================================================
 template< bool indexed, bool useBufferCount>
 void CmdBuffer::DrawIndirect(
@@ -2738,10 +3380,17 @@ void CmdBuffer::DrawIndirect(
     VkBuffer     countBuffer,
     VkDeviceSize countOffset)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd((indexed ? DbgBarrierDrawIndexed : DbgBarrierDrawNonIndexed) | DbgBarrierDrawIndirect);
 
     ValidateStates();
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.draws++;
+    }
+
     Buffer* pBuffer = Buffer::ObjectFromHandle(buffer);
 
     if ((stride + offset) <= pBuffer->PalMemory(DefaultDeviceIndex)->Desc().size)
@@ -2792,8 +3441,15 @@ void CmdBuffer::Dispatch(
     uint32_t y,
     uint32_t z)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierDispatch);
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.dispatches++;
+    }
+
     if (PalPipelineBindingOwnedBy(Pal::PipelineBindPoint::Compute, PipelineBindCompute) == false)
     {
         RebindPipeline<PipelineBindCompute, false>();
@@ -2813,8 +3469,15 @@ void CmdBuffer::DispatchOffset(
     uint32_t                    dim_y,
     uint32_t                    dim_z)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierDispatch);
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.dispatches++;
+    }
+
     if (PalPipelineBindingOwnedBy(Pal::PipelineBindPoint::Compute, PipelineBindCompute) == false)
     {
         RebindPipeline<PipelineBindCompute, false>();
@@ -2830,8 +3493,15 @@ void CmdBuffer::DispatchIndirect(
     VkBuffer     buffer,
     VkDeviceSize offset)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierDispatchIndirect);
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.dispatches++;
+    }
+
     if (PalPipelineBindingOwnedBy(Pal::PipelineBindPoint::Compute, PipelineBindCompute) == false)
     {
         RebindPipeline<PipelineBindCompute, false>();
@@ -2852,6 +3522,8 @@ void CmdBuffer::CopyBuffer(
     uint32_t                                    regionCount,
     const BufferCopyType*                       pRegions)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCopyBuffer);
 
     PalCmdSuspendPredication(true);
@@ -2905,6 +3577,8 @@ void CmdBuffer::CopyImage(
     uint32_t             regionCount,
     const ImageCopyType* pRegions)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCopyImage);
 
     PalCmdSuspendPredication(true);
@@ -2969,6 +3643,8 @@ void CmdBuffer::BlitImage(
     const ImageBlitType* pRegions,
     VkFilter             filter)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCopyImage);
 
     PalCmdSuspendPredication(true);
@@ -3078,6 +3754,8 @@ void CmdBuffer::CopyBufferToImage(
     uint32_t                   regionCount,
     const BufferImageCopyType* pRegions)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCopyBuffer | DbgBarrierCopyImage);
 
     PalCmdSuspendPredication(true);
@@ -3143,6 +3821,8 @@ void CmdBuffer::CopyImageToBuffer(
     uint32_t                   regionCount,
     const BufferImageCopyType* pRegions)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCopyBuffer | DbgBarrierCopyImage);
 
     PalCmdSuspendPredication(true);
@@ -3202,6 +3882,8 @@ void CmdBuffer::UpdateBuffer(
     VkDeviceSize    dataSize,
     const uint32_t* pData)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCopyBuffer);
 
     PalCmdSuspendPredication(true);
@@ -3222,6 +3904,8 @@ void CmdBuffer::FillBuffer(
     VkDeviceSize                                fillSize,
     uint32_t                                    data)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCopyBuffer);
 
     PalCmdSuspendPredication(true);
@@ -3249,6 +3933,8 @@ void CmdBuffer::ClearColorImage(
     uint32_t                       rangeCount,
     const VkImageSubresourceRange* pRanges)
 {
+    FlushPendingBarriers();
+
     PalCmdSuspendPredication(true);
 
     const Image* pImage = Image::ObjectFromHandle(image);
@@ -3360,6 +4046,8 @@ void CmdBuffer::ClearDepthStencilImage(
     uint32_t                       rangeCount,
     const VkImageSubresourceRange* pRanges)
 {
+    FlushPendingBarriers();
+
     PalCmdSuspendPredication(true);
 
     VirtualStackFrame virtStackFrame(m_pStackAllocator);
@@ -3430,6 +4118,8 @@ void CmdBuffer::ClearAttachments(
     uint32_t                 rectCount,
     const VkClearRect*       pRects)
 {
+    FlushPendingBarriers();
+
     // if pRenderPass is null, than dynamic rendering is being used
     if (m_allGpuState.pRenderPass == nullptr)
     {
@@ -4188,6 +4878,8 @@ void CmdBuffer::ResolveImage(
     uint32_t                rectCount,
     const ImageResolveType* pRects)
 {
+    FlushPendingBarriers();
+
     PalCmdSuspendPredication(true);
 
     VirtualStackFrame virtStackFrame(m_pStackAllocator);
@@ -4268,6 +4960,8 @@ void CmdBuffer::SetEvent(
     VkEvent                       event,
     PipelineStageFlags            stageMask)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierSetResetEvent);
 
     PalCmdSetEvent(Event::ObjectFromHandle(event), VkToPalSrcPipePoint(stageMask));
@@ -4281,6 +4975,8 @@ void CmdBuffer::SetEvent2(
     VkEvent                    event,
     const VkDependencyInfoKHR* pDependencyInfo)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierSetResetEvent);
 
     if (m_flags.useSplitReleaseAcquire)
@@ -4556,6 +5252,8 @@ void CmdBuffer::StoreAttachmentInfo(
 void CmdBuffer::BeginRendering(
     const VkRenderingInfoKHR* pRenderingInfo)
 {
+    FlushPendingBarriers();
+
     VK_ASSERT(pRenderingInfo != nullptr);
 
     DbgBarrierPreCmd(DbgBarrierBeginRendering);
@@ -4802,6 +5500,8 @@ void CmdBuffer::PostDrawPreResolveSync()
 // vkCmdEndRendering for VK_KHR_dynamic_rendering
 void CmdBuffer::EndRendering()
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierEndRenderPass);
 
     // Only do resolves if renderpass isn't suspended and
@@ -4851,6 +5551,8 @@ void CmdBuffer::ResetEvent(
     VkEvent                  event,
     PipelineStageFlags       stageMask)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierSetResetEvent);
 
     Event* pEvent = Event::ObjectFromHandle(event);
@@ -5167,8 +5869,15 @@ void CmdBuffer::WaitEvents(
     uint32_t                     imageMemoryBarrierCount,
     const VkImageMemoryBarrier*  pImageMemoryBarriers)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.barriers++;
+    }
+
     VirtualStackFrame virtStackFrame(m_pStackAllocator);
 
     // Allocate space to store signaled event pointers (automatically rewound on unscope)
@@ -5224,8 +5933,15 @@ void CmdBuffer::WaitEvents2(
     const VkEvent*             pEvents,
     const VkDependencyInfoKHR* pDependencyInfos)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.barriers++;
+    }
+
     // If the ASIC provides split CmdRelease()/CmdReleaseEvent() and CmdAcquire()/CmdAcquireEvent() to express barrier,
     // we will find range of gpu-only events and gpu events with cpu-access, we are assuming the case won't be to have
     // a mixture, it means we can find ranges in the event list that are sync token or not sync token, and then call
@@ -6039,58 +6755,191 @@ void CmdBuffer::PipelineBarrier(
 {
     DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
 
-    if (m_flags.useReleaseAcquire)
+    if (m_flags.collectRecordingStats)
     {
-        ExecuteReleaseThenAcquire(srcStageMask,
-                                  destStageMask,
-                                  memBarrierCount,
-                                  pMemoryBarriers,
-                                  bufferMemoryBarrierCount,
-                                  pBufferMemoryBarriers,
-                                  imageMemoryBarrierCount,
-                                  pImageMemoryBarriers);
+        m_recordingStats.barriers++;
     }
-    else
-    {
-        VirtualStackFrame virtStackFrame(m_pStackAllocator);
-
-        Pal::BarrierInfo barrier = {};
-
-        // Tell PAL to wait at a specific point until the given set of pipeline events has been signaled (this version
-        // does not use GpuEvent objects).
-        barrier.reason       = RgpBarrierExternalCmdPipelineBarrier;
-        barrier.flags.u32All = 0;
-        barrier.waitPoint    = VkToPalWaitPipePoint(destStageMask);
-
-        // Collect signal pipe points.
-        Pal::HwPipePoint pipePoints[MaxHwPipePoints];
-
-        barrier.pipePointWaitCount      = VkToPalSrcPipePoints(srcStageMask, pipePoints);
-        barrier.pPipePoints             = pipePoints;
-        barrier.pSplitBarrierGpuEvent   = nullptr;
 
-        ExecuteBarriers(&virtStackFrame,
-                        memBarrierCount,
-                        pMemoryBarriers,
-                        bufferMemoryBarrierCount,
-                        pBufferMemoryBarriers,
-                        imageMemoryBarrierCount,
-                        pImageMemoryBarriers,
-                        &barrier);
+    RecordPipelineBarrier(srcStageMask,
+                          destStageMask,
+                          memBarrierCount,
+                          pMemoryBarriers,
+                          bufferMemoryBarrierCount,
+                          pBufferMemoryBarriers,
+                          imageMemoryBarrierCount,
+                          pImageMemoryBarriers);
 
-        DbgBarrierPostCmd(DbgBarrierPipelineBarrierWaitEvents);
-    }
+    DbgBarrierPostCmd(DbgBarrierPipelineBarrierWaitEvents);
 }
 
 // =====================================================================================================================
-// Implements of vkCmdPipelineBarrier2()
-void CmdBuffer::PipelineBarrier2(
-    const VkDependencyInfoKHR*   pDependencyInfo)
+// Adds a pipeline barrier to the barrier accumulator if possible, so that it can be combined with the barriers recorded
+// right before or after it.  Otherwise the barrier is executed right away.
+void CmdBuffer::RecordPipelineBarrier(
+    PipelineStageFlags           srcStageMask,
+    PipelineStageFlags           destStageMask,
+    uint32_t                     memBarrierCount,
+    const VkMemoryBarrier*       pMemoryBarriers,
+    uint32_t                     bufferMemoryBarrierCount,
+    const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+    uint32_t                     imageMemoryBarrierCount,
+    const VkImageMemoryBarrier*  pImageMemoryBarriers)
 {
-    DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
+    BarrierAccumulator::AddResult result = BarrierAccumulator::AddResult::NotDeferrable;
+
+    // Number of buffer and image barriers pending before this one was added
+    uint32_t prevPendingCount = 0;
+
+    if (m_flags.accumulatePipelineBarriers)
+    {
+        prevPendingCount = m_barrierAccumulator.GetBufferMemoryBarrierCount() +
+                           m_barrierAccumulator.GetImageMemoryBarrierCount();
+
+        result = m_barrierAccumulator.Add(srcStageMask,
+                                          destStageMask,
+                                          memBarrierCount,
+                                          pMemoryBarriers,
+                                          bufferMemoryBarrierCount,
+                                          pBufferMemoryBarriers,
+                                          imageMemoryBarrierCount,
+                                          pImageMemoryBarriers);
+
+        if (result == BarrierAccumulator::AddResult::FlushRequired)
+        {
+            IssuePendingBarriers();
+
+            prevPendingCount = 0;
+
+            result = m_barrierAccumulator.Add(srcStageMask,
+                                              destStageMask,
+                                              memBarrierCount,
+                                              pMemoryBarriers,
+                                              bufferMemoryBarrierCount,
+                                              pBufferMemoryBarriers,
+                                              imageMemoryBarrierCount,
+                                              pImageMemoryBarriers);
+        }
+    }
+
+    if (result == BarrierAccumulator::AddResult::Added)
+    {
+        if (m_flags.collectRecordingStats)
+        {
+            // Barriers which didn't add to the pending ones were merged into them.
+            const uint32_t pendingCount = m_barrierAccumulator.GetBufferMemoryBarrierCount() +
+                                          m_barrierAccumulator.GetImageMemoryBarrierCount();
+
+            m_recordingStats.accumulatedBarriers++;
+            m_recordingStats.mergedBarriers += (bufferMemoryBarrierCount + imageMemoryBarrierCount) -
+                                               (pendingCount - prevPendingCount);
+        }
+    }
+    else
+    {
+        FlushPendingBarriers();
+
+        ExecutePipelineBarrier(srcStageMask,
+                               destStageMask,
+                               memBarrierCount,
+                               pMemoryBarriers,
+                               bufferMemoryBarrierCount,
+                               pBufferMemoryBarriers,
+                               imageMemoryBarrierCount,
+                               pImageMemoryBarriers);
+    }
+}
+
+// =====================================================================================================================
+// Issues the pipeline barriers collected by the barrier accumulator as one barrier.
+void CmdBuffer::IssuePendingBarriers()
+{
+    ExecutePipelineBarrier(m_barrierAccumulator.GetSrcStageMask(),
+                           m_barrierAccumulator.GetDstStageMask(),
+                           m_barrierAccumulator.GetMemoryBarrierCount(),
+                           m_barrierAccumulator.GetMemoryBarriers(),
+                           m_barrierAccumulator.GetBufferMemoryBarrierCount(),
+                           m_barrierAccumulator.GetBufferMemoryBarriers(),
+                           m_barrierAccumulator.GetImageMemoryBarrierCount(),
+                           m_barrierAccumulator.GetImageMemoryBarriers());
+
+    m_barrierAccumulator.OnFlush();
+
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.barrierFlushes++;
+    }
+}
+
+// =====================================================================================================================
+// Executes a vkCmdPipelineBarrier() right away
+void CmdBuffer::ExecutePipelineBarrier(
+    PipelineStageFlags           srcStageMask,
+    PipelineStageFlags           destStageMask,
+    uint32_t                     memBarrierCount,
+    const VkMemoryBarrier*       pMemoryBarriers,
+    uint32_t                     bufferMemoryBarrierCount,
+    const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+    uint32_t                     imageMemoryBarrierCount,
+    const VkImageMemoryBarrier*  pImageMemoryBarriers)
+{
+    if (m_flags.useReleaseAcquire)
+    {
+        ExecuteReleaseThenAcquire(srcStageMask,
+                                  destStageMask,
+                                  memBarrierCount,
+                                  pMemoryBarriers,
+                                  bufferMemoryBarrierCount,
+                                  pBufferMemoryBarriers,
+                                  imageMemoryBarrierCount,
+                                  pImageMemoryBarriers);
+    }
+    else
+    {
+        VirtualStackFrame virtStackFrame(m_pStackAllocator);
+
+        Pal::BarrierInfo barrier = {};
+
+        // Tell PAL to wait at a specific point until the given set of pipeline events has been signaled (this version
+        // does not use GpuEvent objects).
+        barrier.reason       = RgpBarrierExternalCmdPipelineBarrier;
+        barrier.flags.u32All = 0;
+        barrier.waitPoint    = VkToPalWaitPipePoint(destStageMask);
+
+        // Collect signal pipe points.
+        Pal::HwPipePoint pipePoints[MaxHwPipePoints];
+
+        barrier.pipePointWaitCount      = VkToPalSrcPipePoints(srcStageMask, pipePoints);
+        barrier.pPipePoints             = pipePoints;
+        barrier.pSplitBarrierGpuEvent   = nullptr;
+
+        ExecuteBarriers(&virtStackFrame,
+                        memBarrierCount,
+                        pMemoryBarriers,
+                        bufferMemoryBarrierCount,
+                        pBufferMemoryBarriers,
+                        imageMemoryBarrierCount,
+                        pImageMemoryBarriers,
+                        &barrier);
+    }
+}
+
+// =====================================================================================================================
+// Implements of vkCmdPipelineBarrier2()
+void CmdBuffer::PipelineBarrier2(
+    const VkDependencyInfoKHR*   pDependencyInfo)
+{
+    DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
+
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.barriers++;
+    }
 
     if (m_flags.useReleaseAcquire)
     {
+        // Barriers with per-barrier stage masks are not accumulated.
+        FlushPendingBarriers();
+
         utils::IterateMask deviceGroup(m_curDeviceMask);
         do
         {
@@ -6188,29 +7037,14 @@ void CmdBuffer::PipelineBarrierSync2ToSync1(
         };
     }
 
-    Pal::BarrierInfo barrier = {};
-
-    // Tell PAL to wait at a specific point until the given set of pipeline events has been signaled (this version
-    // does not use GpuEvent objects).
-    barrier.reason       = RgpBarrierExternalCmdPipelineBarrier;
-    barrier.flags.u32All = 0;
-    barrier.waitPoint    = VkToPalWaitPipePoint(dstStageMask);
-
-    // Collect signal pipe points.
-    Pal::HwPipePoint pipePoints[MaxHwPipePoints];
-
-    barrier.pipePointWaitCount      = VkToPalSrcPipePoints(srcStageMask, pipePoints);
-    barrier.pPipePoints             = pipePoints;
-    barrier.pSplitBarrierGpuEvent   = nullptr;
-
-    ExecuteBarriers(&virtStackFrame,
-                    pDependencyInfo->memoryBarrierCount,
-                    pMemoryBarriers,
-                    pDependencyInfo->bufferMemoryBarrierCount,
-                    pBufferMemoryBarriers,
-                    pDependencyInfo->imageMemoryBarrierCount,
-                    pImageMemoryBarriers,
-                    &barrier);
+    RecordPipelineBarrier(srcStageMask,
+                          dstStageMask,
+                          pDependencyInfo->memoryBarrierCount,
+                          pMemoryBarriers,
+                          pDependencyInfo->bufferMemoryBarrierCount,
+                          pBufferMemoryBarriers,
+                          pDependencyInfo->imageMemoryBarrierCount,
+                          pImageMemoryBarriers);
 
     if (pMemoryBarriers != nullptr)
     {
@@ -6235,6 +7069,8 @@ void CmdBuffer::BeginQueryIndexed(
     VkQueryControlFlags flags,
     uint32_t            index)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierQueryBeginEnd);
 
     const QueryPool* pBasePool = QueryPool::ObjectFromHandle(queryPool);
@@ -6310,6 +7146,8 @@ void CmdBuffer::EndQueryIndexed(
     uint32_t    query,
     uint32_t    index)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierQueryBeginEnd);
 
     // NOTE: This function is illegal to call for TimestampQueryPools and  AccelerationStructureQueryPools
@@ -6442,6 +7280,8 @@ void CmdBuffer::ResetQueryPool(
     uint32_t    firstQuery,
     uint32_t    queryCount)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierQueryReset);
 
     PalCmdSuspendPredication(true);
@@ -6753,6 +7593,8 @@ void CmdBuffer::CopyQueryPoolResults(
     VkDeviceSize       destStride,
     VkQueryResultFlags flags)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierCopyBuffer | DbgBarrierCopyQueryPool);
 
     PalCmdSuspendPredication(true);
@@ -6948,6 +7790,8 @@ void CmdBuffer::WriteTimestamp(
     const TimestampQueryPool* pQueryPool,
     uint32_t                  query)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierWriteTimestamp);
 
     PalCmdSuspendPredication(true);
@@ -7027,6 +7871,8 @@ void CmdBuffer::BeginRenderPass(
     const VkRenderPassBeginInfo* pRenderPassBegin,
     VkSubpassContents            contents)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierBeginRenderPass);
 
     m_allGpuState.pRenderPass  = RenderPass::ObjectFromHandle(pRenderPassBegin->renderPass);
@@ -7309,6 +8155,8 @@ void CmdBuffer::BeginRenderPass(
 void CmdBuffer::NextSubPass(
     VkSubpassContents      contents)
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierNextSubpass);
 
     if (m_renderPassInstance.subpass != VK_SUBPASS_EXTERNAL)
@@ -8445,6 +9293,8 @@ void CmdBuffer::SetViewInstanceMask(
 // Ends a render pass instance (vkCmdEndRenderPass)
 void CmdBuffer::EndRenderPass()
 {
+    FlushPendingBarriers();
+
     DbgBarrierPreCmd(DbgBarrierEndRenderPass);
 
     if (m_renderPassInstance.subpass != VK_SUBPASS_EXTERNAL)
@@ -8515,12 +9365,20 @@ void CmdBuffer::WritePushConstants(
                     pBindState->userDataLayout.compact.pushConstRegBase + startInDwords,
                     lengthInDwords,
                     pUserDataPtr);
+
+                if (m_flags.collectRecordingStats)
+                {
+                    m_recordingStats.userDataWrites++;
+                }
             }
             while (deviceGroup.IterateNext());
         }
     }
     else if (userDataLayout.scheme == PipelineLayoutScheme::Indirect)
     {
+        // The indirect scheme programs user data registers which may overlap those of compact descriptor sets.
+        pBindState->validSetMask = 0;
+
         utils::IterateMask deviceGroup(m_curDeviceMask);
 
         do
@@ -8534,6 +9392,11 @@ void CmdBuffer::WritePushConstants(
                 m_pDevice->GetProperties().descriptorSizes.alignmentInDwords,
                 &gpuAddr);
 
+            if (m_flags.collectRecordingStats)
+            {
+                m_recordingStats.embeddedDataBytes += userDataLayout.indirect.pushConstSizeInDword * sizeof(uint32_t);
+            }
+
             memcpy(pCpuAddr, pUserData, userDataLayout.indirect.pushConstSizeInDword * sizeof(uint32_t));
 
             const uint32_t gpuAddrLow = static_cast<uint32_t>(gpuAddr);
@@ -8543,6 +9406,11 @@ void CmdBuffer::WritePushConstants(
                 userDataLayout.indirect.pushConstPtrRegBase,
                 PipelineLayout::SetPtrRegCount,
                 &gpuAddrLow);
+
+            if (m_flags.collectRecordingStats)
+            {
+                m_recordingStats.userDataWrites++;
+            }
         }
         while (deviceGroup.IterateNext());
     }
@@ -8737,7 +9605,7 @@ void CmdBuffer::PushDescriptorSetKHR(
 
     DescriptorSet<numPalDevices>* pDestSet = DescriptorSet<numPalDevices>::ObjectFromHandle(pushDescriptorSet);
 
-    utils::IterateMask deviceGroup(m_curDeviceMask);
+    utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
 
     do
     {
@@ -8880,6 +9748,11 @@ void CmdBuffer::PushDescriptorSetKHR(
                                                                                      alignmentInDwords,
                                                                                      &gpuAddr);
 
+            if (m_flags.collectRecordingStats)
+            {
+                m_recordingStats.embeddedDataBytes += descriptorSetSizeInDwords * sizeof(uint32_t);
+            }
+
             memcpy(pCpuAddr, pDestSet->StaticCpuAddress(deviceIdx), (descriptorSetSizeInDwords * sizeof(uint32_t)));
 
             // CmdAllocateEmbeddedData is allocated out of VaRange::DescriptorTable, so the upper half is
@@ -8887,7 +9760,7 @@ void CmdBuffer::PushDescriptorSetKHR(
             PerGpuState(deviceIdx)->setBindingData[apiBindPoint][setPtrRegOffset] = static_cast<uint32_t>(gpuAddr);
         }
 
-        SetUserDataPipelineLayout(set, 1, pLayout, palBindPoint, apiBindPoint);
+        SetUserDataPipelineLayout<numPalDevices>(set, 1, 1, pLayout, palBindPoint, apiBindPoint);
     }
     while (deviceGroup.IterateNext());
 
@@ -8937,7 +9810,7 @@ void CmdBuffer::PushDescriptorSetWithTemplateKHR(
 
     const uint8 setPtrRegOffset = setLayoutInfo.setPtrRegOffset;
 
-    utils::IterateMask deviceGroup(m_curDeviceMask);
+    utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
 
     do
     {
@@ -8953,6 +9826,11 @@ void CmdBuffer::PushDescriptorSetWithTemplateKHR(
                                                                                      alignmentInDwords,
                                                                                      &gpuAddr);
 
+            if (m_flags.collectRecordingStats)
+            {
+                m_recordingStats.embeddedDataBytes += descriptorSetSizeInDwords * sizeof(uint32_t);
+            }
+
             const DescriptorSet<numPalDevices>* pShadowSet =
                 DescriptorSet<numPalDevices>::ObjectFromHandle(pushDescriptorSet);
 
@@ -8963,7 +9841,7 @@ void CmdBuffer::PushDescriptorSetWithTemplateKHR(
             PerGpuState(deviceIdx)->setBindingData[apiBindPoint][setPtrRegOffset] = static_cast<uint32_t>(gpuAddr);
         }
 
-        SetUserDataPipelineLayout(set, 1, pLayout, palBindPoint, apiBindPoint);
+        SetUserDataPipelineLayout<numPalDevices>(set, 1, 1, pLayout, palBindPoint, apiBindPoint);
     }
     while (deviceGroup.IterateNext());
 
@@ -8971,6 +9849,7 @@ void CmdBuffer::PushDescriptorSetWithTemplateKHR(
 }
 
 // =====================================================================================================================
+template <uint32_t numPalDevices>
 void CmdBuffer::SetViewport(
     uint32_t            firstViewport,
     uint32_t            viewportCount,
@@ -8983,39 +9862,62 @@ void CmdBuffer::SetViewport(
     const bool khrMaintenance1 = ((m_pDevice->VkPhysicalDevice(DefaultDeviceIndex)->GetEnabledAPIVersion() >= VK_MAKE_VERSION(1, 1, 0)) ||
                                   m_pDevice->IsExtensionEnabled(DeviceExtensions::KHR_MAINTENANCE1));
 
-    utils::IterateMask deviceGroup(m_curDeviceMask);
+    Pal::ViewportParams params;
+
+    for (uint32_t i = 0; i < viewportCount; ++i)
+    {
+        VkToPalViewport(pViewports[i], firstViewport + i, khrMaintenance1, &params);
+    }
+
+    const size_t viewportSize = viewportCount * sizeof(params.viewports[0]);
+    bool         changed      = false;
+
+    utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
 
     do
     {
-        const uint32_t deviceIndex = deviceGroup.Index();
+        auto* pDstViewports = &PerGpuState(deviceGroup.Index())->viewport.viewports[firstViewport];
 
-        for (uint32_t i = 0; i < viewportCount; ++i)
+        if (memcmp(pDstViewports, &params.viewports[firstViewport], viewportSize) != 0)
         {
-            VkToPalViewport(pViewports[i],
-                            firstViewport + i,
-                            khrMaintenance1,
-                            &PerGpuState(deviceIndex)->viewport);
+            memcpy(pDstViewports, &params.viewports[firstViewport], viewportSize);
+
+            changed = true;
         }
     }
     while (deviceGroup.IterateNext());
 
-    m_allGpuState.dirtyGraphics.viewport         = 1;
-    m_allGpuState.staticTokens.viewports = DynamicRenderStateToken;
+    if (changed || (CanFilterState(m_allGpuState.validGraphics.viewport) == false))
+    {
+        m_allGpuState.dirtyGraphics.viewport         = 1;
+        m_allGpuState.staticTokens.viewports = DynamicRenderStateToken;
+    }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.viewport++;
+    }
 }
 
 // =====================================================================================================================
+template <uint32_t numPalDevices>
 void CmdBuffer::SetViewportWithCount(
     uint32_t            viewportCount,
     const VkViewport*   pViewports)
 {
-    utils::IterateMask deviceGroup(m_curDeviceMask);
+    utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
     do
     {
-        PerGpuState(deviceGroup.Index())->viewport.count = viewportCount;
+        uint32* pViewportCount = &(PerGpuState(deviceGroup.Index())->viewport.count);
+
+        if (*pViewportCount != viewportCount)
+        {
+            *pViewportCount = viewportCount;
+            m_allGpuState.dirtyGraphics.viewport = 1;
+        }
     }
     while (deviceGroup.IterateNext());
 
-    SetViewport(0, viewportCount, pViewports);
+    SetViewport<numPalDevices>(0, viewportCount, pViewports);
 }
 
 // =====================================================================================================================
@@ -9043,40 +9945,67 @@ void CmdBuffer::SetAllViewports(
 }
 
 // =====================================================================================================================
+template <uint32_t numPalDevices>
 void CmdBuffer::SetScissor(
     uint32_t            firstScissor,
     uint32_t            scissorCount,
     const VkRect2D*     pScissors)
 {
-    utils::IterateMask deviceGroup(m_curDeviceMask);
+    Pal::ScissorRectParams params;
+
+    for (uint32_t i = 0; i < scissorCount; ++i)
+    {
+        VkToPalScissorRect(pScissors[i], firstScissor + i, &params);
+    }
+
+    const size_t scissorSize = scissorCount * sizeof(params.scissors[0]);
+    bool         changed     = false;
+
+    utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
     do
     {
-        const uint32_t deviceIdx = deviceGroup.Index();
+        auto* pDstScissors = &PerGpuState(deviceGroup.Index())->scissor.scissors[firstScissor];
 
-        for (uint32_t i = 0; i < scissorCount; ++i)
+        if (memcmp(pDstScissors, &params.scissors[firstScissor], scissorSize) != 0)
         {
-            VkToPalScissorRect(pScissors[i], firstScissor + i, &PerGpuState(deviceIdx)->scissor);
+            memcpy(pDstScissors, &params.scissors[firstScissor], scissorSize);
+
+            changed = true;
         }
     }
     while (deviceGroup.IterateNext());
 
-    m_allGpuState.dirtyGraphics.scissor            = 1;
-    m_allGpuState.staticTokens.scissorRect = DynamicRenderStateToken;
+    if (changed || (CanFilterState(m_allGpuState.validGraphics.scissor) == false))
+    {
+        m_allGpuState.dirtyGraphics.scissor            = 1;
+        m_allGpuState.staticTokens.scissorRect = DynamicRenderStateToken;
+    }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.scissor++;
+    }
 }
 
 // =====================================================================================================================
+template <uint32_t numPalDevices>
 void CmdBuffer::SetScissorWithCount(
     uint32_t            scissorCount,
     const VkRect2D*     pScissors)
 {
-    utils::IterateMask deviceGroup(m_curDeviceMask);
+    utils::IterateDeviceMask<numPalDevices> deviceGroup(m_curDeviceMask);
     do
     {
-        PerGpuState(deviceGroup.Index())->scissor.count = scissorCount;
+        uint32* pScissorCount = &(PerGpuState(deviceGroup.Index())->scissor.count);
+
+        if (*pScissorCount != scissorCount)
+        {
+            *pScissorCount = scissorCount;
+            m_allGpuState.dirtyGraphics.scissor = 1;
+        }
     }
     while (deviceGroup.IterateNext());
 
-    SetScissor(0, scissorCount, pScissors);
+    SetScissor<numPalDevices>(0, scissorCount, pScissors);
 }
 
 // =====================================================================================================================
@@ -9118,15 +10047,29 @@ void CmdBuffer::SetLineWidth(
                                                      limits.pointSizeRange[0],
                                                      limits.pointSizeRange[1] };
 
-    utils::IterateMask deviceGroup(m_curDeviceMask);
-
-    do
+    if (CanFilterState(m_allGpuState.validImmediate.pointLineRasterState) &&
+        (m_allGpuState.staticTokens.pointLineRasterState == DynamicRenderStateToken) &&
+        (memcmp(&m_allGpuState.pointLineRasterState, &params, sizeof(params)) == 0))
     {
-        PalCmdBuffer(deviceGroup.Index())->CmdSetPointLineRasterState(params);
+        if (m_flags.collectRecordingStats)
+        {
+            m_redundantStateStats.pointLineRasterState++;
+        }
     }
-    while (deviceGroup.IterateNext());
+    else
+    {
+        utils::IterateMask deviceGroup(m_curDeviceMask);
 
-    m_allGpuState.staticTokens.pointLineRasterState = DynamicRenderStateToken;
+        do
+        {
+            PalCmdBuffer(deviceGroup.Index())->CmdSetPointLineRasterState(params);
+        }
+        while (deviceGroup.IterateNext());
+
+        m_allGpuState.pointLineRasterState                = params;
+        m_allGpuState.validImmediate.pointLineRasterState = 1;
+        m_allGpuState.staticTokens.pointLineRasterState   = DynamicRenderStateToken;
+    }
 
     DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
 }
@@ -9141,15 +10084,29 @@ void CmdBuffer::SetDepthBias(
 
     const Pal::DepthBiasParams params = {depthBias, depthBiasClamp, slopeScaledDepthBias};
 
-    utils::IterateMask deviceGroup(m_curDeviceMask);
-
-    do
+    if (CanFilterState(m_allGpuState.validImmediate.depthBias) &&
+        (m_allGpuState.staticTokens.depthBiasState == DynamicRenderStateToken) &&
+        (memcmp(&m_allGpuState.depthBias, &params, sizeof(params)) == 0))
     {
-        PalCmdBuffer(deviceGroup.Index())->CmdSetDepthBiasState(params);
+        if (m_flags.collectRecordingStats)
+        {
+            m_redundantStateStats.depthBias++;
+        }
     }
-    while (deviceGroup.IterateNext());
+    else
+    {
+        utils::IterateMask deviceGroup(m_curDeviceMask);
 
-    m_allGpuState.staticTokens.depthBiasState = DynamicRenderStateToken;
+        do
+        {
+            PalCmdBuffer(deviceGroup.Index())->CmdSetDepthBiasState(params);
+        }
+        while (deviceGroup.IterateNext());
+
+        m_allGpuState.depthBias                   = params;
+        m_allGpuState.validImmediate.depthBias    = 1;
+        m_allGpuState.staticTokens.depthBiasState = DynamicRenderStateToken;
+    }
 
     DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
 }
@@ -9162,15 +10119,29 @@ void CmdBuffer::SetBlendConstants(
 
     const Pal::BlendConstParams params = { blendConst[0], blendConst[1], blendConst[2], blendConst[3] };
 
-    utils::IterateMask deviceGroup(m_curDeviceMask);
-
-    do
+    if (CanFilterState(m_allGpuState.validImmediate.blendConst) &&
+        (m_allGpuState.staticTokens.blendConst == DynamicRenderStateToken) &&
+        (memcmp(&m_allGpuState.blendConst, &params, sizeof(params)) == 0))
     {
-        PalCmdBuffer(deviceGroup.Index())->CmdSetBlendConst(params);
+        if (m_flags.collectRecordingStats)
+        {
+            m_redundantStateStats.blendConst++;
+        }
     }
-    while (deviceGroup.IterateNext());
+    else
+    {
+        utils::IterateMask deviceGroup(m_curDeviceMask);
+
+        do
+        {
+            PalCmdBuffer(deviceGroup.Index())->CmdSetBlendConst(params);
+        }
+        while (deviceGroup.IterateNext());
 
-    m_allGpuState.staticTokens.blendConst = DynamicRenderStateToken;
+        m_allGpuState.blendConst                = params;
+        m_allGpuState.validImmediate.blendConst = 1;
+        m_allGpuState.staticTokens.blendConst   = DynamicRenderStateToken;
+    }
 
     DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
 }
@@ -9184,24 +10155,56 @@ void CmdBuffer::SetDepthBounds(
 
     const Pal::DepthBoundsParams params = { minDepthBounds, maxDepthBounds };
 
-    utils::IterateMask deviceGroup(m_curDeviceMask);
-
-    do
+    if (CanFilterState(m_allGpuState.validImmediate.depthBounds) &&
+        (m_allGpuState.staticTokens.depthBounds == DynamicRenderStateToken) &&
+        (memcmp(&m_allGpuState.depthBounds, &params, sizeof(params)) == 0))
     {
-        PalCmdBuffer(deviceGroup.Index())->CmdSetDepthBounds(params);
+        if (m_flags.collectRecordingStats)
+        {
+            m_redundantStateStats.depthBounds++;
+        }
     }
-    while (deviceGroup.IterateNext());
+    else
+    {
+        utils::IterateMask deviceGroup(m_curDeviceMask);
 
-    m_allGpuState.staticTokens.depthBounds = DynamicRenderStateToken;
+        do
+        {
+            PalCmdBuffer(deviceGroup.Index())->CmdSetDepthBounds(params);
+        }
+        while (deviceGroup.IterateNext());
+
+        m_allGpuState.depthBounds                = params;
+        m_allGpuState.validImmediate.depthBounds = 1;
+        m_allGpuState.staticTokens.depthBounds   = DynamicRenderStateToken;
+    }
 
     DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
 }
 
+// =====================================================================================================================
+// Marks the stencil reference and masks dirty unless a vkCmdSetStencil* call left them unchanged.
+void CmdBuffer::UpdateStencilRefMaskDirty(
+    const Pal::StencilRefMaskParams& prevStencilRefMasks)
+{
+    if ((memcmp(&m_allGpuState.stencilRefMasks, &prevStencilRefMasks, sizeof(Pal::StencilRefMaskParams)) != 0) ||
+        (CanFilterState(m_allGpuState.validGraphics.stencilRef) == false))
+    {
+        m_allGpuState.dirtyGraphics.stencilRef = 1;
+    }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.stencilRef++;
+    }
+}
+
 // =====================================================================================================================
 void CmdBuffer::SetStencilCompareMask(
     VkStencilFaceFlags  faceMask,
     uint32_t            stencilCompareMask)
 {
+    const Pal::StencilRefMaskParams prevStencilRefMasks = m_allGpuState.stencilRefMasks;
+
     if (faceMask & VK_STENCIL_FACE_FRONT_BIT)
     {
         m_allGpuState.stencilRefMasks.frontReadMask = static_cast<uint8_t>(stencilCompareMask);
@@ -9211,7 +10214,7 @@ void CmdBuffer::SetStencilCompareMask(
         m_allGpuState.stencilRefMasks.backReadMask = static_cast<uint8_t>(stencilCompareMask);
     }
 
-    m_allGpuState.dirtyGraphics.stencilRef = 1;
+    UpdateStencilRefMaskDirty(prevStencilRefMasks);
 }
 
 // =====================================================================================================================
@@ -9219,6 +10222,8 @@ void CmdBuffer::SetStencilWriteMask(
     VkStencilFaceFlags  faceMask,
     uint32_t            stencilWriteMask)
 {
+    const Pal::StencilRefMaskParams prevStencilRefMasks = m_allGpuState.stencilRefMasks;
+
     if (faceMask & VK_STENCIL_FACE_FRONT_BIT)
     {
         m_allGpuState.stencilRefMasks.frontWriteMask = static_cast<uint8_t>(stencilWriteMask);
@@ -9228,7 +10233,7 @@ void CmdBuffer::SetStencilWriteMask(
         m_allGpuState.stencilRefMasks.backWriteMask = static_cast<uint8_t>(stencilWriteMask);
     }
 
-    m_allGpuState.dirtyGraphics.stencilRef = 1;
+    UpdateStencilRefMaskDirty(prevStencilRefMasks);
 }
 
 // =====================================================================================================================
@@ -9236,6 +10241,8 @@ void CmdBuffer::SetStencilReference(
     VkStencilFaceFlags  faceMask,
     uint32_t            stencilReference)
 {
+    const Pal::StencilRefMaskParams prevStencilRefMasks = m_allGpuState.stencilRefMasks;
+
     if (faceMask & VK_STENCIL_FACE_FRONT_BIT)
     {
         m_allGpuState.stencilRefMasks.frontRef = static_cast<uint8_t>(stencilReference);
@@ -9245,7 +10252,7 @@ void CmdBuffer::SetStencilReference(
         m_allGpuState.stencilRefMasks.backRef = static_cast<uint8_t>(stencilReference);
     }
 
-    m_allGpuState.dirtyGraphics.stencilRef = 1;
+    UpdateStencilRefMaskDirty(prevStencilRefMasks);
 }
 
 #if VK_ENABLE_DEBUG_BARRIERS
@@ -9309,6 +10316,8 @@ void CmdBuffer::WriteBufferMarker(
     VkDeviceSize            dstOffset,
     uint32_t                marker)
 {
+    FlushPendingBarriers();
+
     const Buffer* pDestBuffer        = Buffer::ObjectFromHandle(dstBuffer);
     const Pal::HwPipePoint pipePoint = VkToPalSrcPipePointForMarkers(pipelineStage, m_palEngineType);
 
@@ -9403,6 +10412,8 @@ void CmdBuffer::BeginTransformFeedback(
     const VkBuffer*     pCounterBuffers,
     const VkDeviceSize* pCounterBufferOffsets)
 {
+    FlushPendingBarriers();
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
     if (m_pTransformFeedbackState != nullptr)
     {
@@ -9445,6 +10456,8 @@ void CmdBuffer::EndTransformFeedback(
     const VkBuffer*     pCounterBuffers,
     const VkDeviceSize* pCounterBufferOffsets)
 {
+    FlushPendingBarriers();
+
     if ((m_pTransformFeedbackState != nullptr) && (m_pTransformFeedbackState->enabled))
     {
         utils::IterateMask deviceGroup(m_curDeviceMask);
@@ -9509,10 +10522,17 @@ void CmdBuffer::DrawIndirectByteCount(
     uint32_t        counterOffset,
     uint32_t        vertexStride)
 {
+    FlushPendingBarriers();
+
     Buffer* pCounterBuffer = Buffer::ObjectFromHandle(counterBuffer);
 
     ValidateStates();
 
+    if (m_flags.collectRecordingStats)
+    {
+        m_recordingStats.draws++;
+    }
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
     do
     {
@@ -9537,19 +10557,35 @@ void CmdBuffer::SetLineStippleEXT(
     uint16_t lineStipplePattern)
 {
     // The line stipple factor is adjusted by one (carried over from OpenGL)
-    m_allGpuState.lineStipple.lineStippleScale = (lineStippleFactor - 1);
+    const uint32_t lineStippleScale = (lineStippleFactor - 1);
 
-    // The bit field to describe the stipple pattern
-    m_allGpuState.lineStipple.lineStippleValue = lineStipplePattern;
-
-    utils::IterateMask deviceGroup(m_curDeviceMask);
-    do
+    if (CanFilterState(m_allGpuState.validImmediate.lineStipple) &&
+        (m_allGpuState.staticTokens.lineStippleState == DynamicRenderStateToken) &&
+        (m_allGpuState.lineStipple.lineStippleScale == lineStippleScale) &&
+        (m_allGpuState.lineStipple.lineStippleValue == lineStipplePattern))
     {
-        PalCmdBuffer(deviceGroup.Index())->CmdSetLineStippleState(m_allGpuState.lineStipple);
+        if (m_flags.collectRecordingStats)
+        {
+            m_redundantStateStats.lineStipple++;
+        }
     }
-    while (deviceGroup.IterateNext());
+    else
+    {
+        m_allGpuState.lineStipple.lineStippleScale = lineStippleScale;
+
+        // The bit field to describe the stipple pattern
+        m_allGpuState.lineStipple.lineStippleValue = lineStipplePattern;
+
+        utils::IterateMask deviceGroup(m_curDeviceMask);
+        do
+        {
+            PalCmdBuffer(deviceGroup.Index())->CmdSetLineStippleState(m_allGpuState.lineStipple);
+        }
+        while (deviceGroup.IterateNext());
 
-    m_allGpuState.staticTokens.lineStippleState = DynamicRenderStateToken;
+        m_allGpuState.validImmediate.lineStipple    = 1;
+        m_allGpuState.staticTokens.lineStippleState = DynamicRenderStateToken;
+    }
 }
 
 // =====================================================================================================================
@@ -9583,6 +10619,8 @@ void CmdBuffer::CmdSetPerDrawVrsRate(
 void CmdBuffer::CmdBeginConditionalRendering(
     const VkConditionalRenderingBeginInfoEXT* pConditionalRenderingBegin)
 {
+    FlushPendingBarriers();
+
     // Make sure we have a properly aligned buffer offset.
     VK_ASSERT(Util::IsPow2Aligned(pConditionalRenderingBegin->offset, 4));
 
@@ -9616,6 +10654,8 @@ void CmdBuffer::CmdBeginConditionalRendering(
 // =====================================================================================================================
 void CmdBuffer::CmdEndConditionalRendering()
 {
+    FlushPendingBarriers();
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
     do
     {
@@ -9635,185 +10675,292 @@ void CmdBuffer::CmdEndConditionalRendering()
 }
 
 // =====================================================================================================================
+// Per-state emit functions indexed by DirtyGraphicsStateBit.  Viewport and scissor are nearly always dirtied together
+// (pipeline binds and the dynamic viewport/scissor calls), so one entry writes both of them.
+const CmdBuffer::EmitDirtyStateEntry CmdBuffer::EmitDirtyStateTable[DirtyGraphicsStateCount] =
+{
+    { &CmdBuffer::EmitViewportAndScissor,      (1u << DirtyGraphicsViewport) | (1u << DirtyGraphicsScissor) },
+    { &CmdBuffer::EmitViewportAndScissor,      (1u << DirtyGraphicsViewport) | (1u << DirtyGraphicsScissor) },
+    { &CmdBuffer::EmitDepthStencilState,       (1u << DirtyGraphicsDepthStencil)                            },
+    { &CmdBuffer::EmitTriangleRasterState,     (1u << DirtyGraphicsRasterState)                             },
+    { &CmdBuffer::EmitInputAssemblyState,      (1u << DirtyGraphicsInputAssembly)                           },
+    { &CmdBuffer::EmitStencilRefMasks,         (1u << DirtyGraphicsStencilRef)                              },
+    { &CmdBuffer::EmitVrsRate,                 (1u << DirtyGraphicsVrs)                                     },
+    { &CmdBuffer::EmitColorWriteMask,          (1u << DirtyGraphicsColorWriteEnable)                        },
+    { &CmdBuffer::EmitRasterizerDiscardEnable, (1u << DirtyGraphicsRasterizerDiscardEnable)                 },
+    { &CmdBuffer::EmitSamplePattern,           (1u << DirtyGraphicsSamplePattern)                           },
+};
+
+// =====================================================================================================================
+// Writes the dirty graphics state to the PAL command buffers.  Only the set dirty bits are visited, so the cost scales
+// with the number of changed states rather than the number of states which could change.
 void CmdBuffer::ValidateStates()
 {
     if (m_allGpuState.dirtyGraphics.u32All != 0)
     {
-        Pal::IDepthStencilState* pPalDepthStencil[MaxPalDevices] = {};
+        DirtyGraphicsState dirtyGraphics = m_allGpuState.dirtyGraphics;
+        dirtyGraphics.reserved           = 0;
 
-        utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
-        do
+        if (m_flags.collectRecordingStats)
         {
-            const uint32_t deviceIdx = deviceGroup.Index();
+            m_recordingStats.stateEmissions += Util::CountSetBits(dirtyGraphics.u32All);
+        }
 
-            if (m_allGpuState.dirtyGraphics.viewport)
-            {
-                DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+        uint32_t remaining = dirtyGraphics.u32All;
+        uint32_t stateBit  = 0;
 
-                const GraphicsPipeline* pGraphicsPipeline = m_allGpuState.pGraphicsPipeline;
+        while (Util::BitMaskScanForward(&stateBit, remaining))
+        {
+            const EmitDirtyStateEntry& entry = EmitDirtyStateTable[stateBit];
 
-                const bool isPointSizeUsed = pGraphicsPipeline->IsPointSizeUsed();
-                Pal::ViewportParams    viewport = PerGpuState(deviceIdx)->viewport;
-                if (isPointSizeUsed)
-                {
-                    // The default vaule is 1.0f which means the guardband is disabled.
-                    // Values more than 1.0f enable guardband.
-                    viewport.horzDiscardRatio = 10.0f;
-                    viewport.vertDiscardRatio = 10.0f;
-                }
+            (this->*entry.pfnEmit)(dirtyGraphics.u32All);
 
-                PalCmdBuffer(deviceIdx)->CmdSetViewports(viewport);
+            remaining &= ~entry.stateMask;
+        }
 
-                DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
-            }
+        // The tracked values of all written state now match the PAL command buffer.
+        m_allGpuState.validGraphics.u32All |= m_allGpuState.dirtyGraphics.u32All;
 
-            if (m_allGpuState.dirtyGraphics.scissor)
-            {
-                DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+        // Clear the dirty bits
+        m_allGpuState.dirtyGraphics.u32All = 0;
+    }
+}
 
-                PalCmdBuffer(deviceIdx)->CmdSetScissorRects(PerGpuState(deviceIdx)->scissor);
+// =====================================================================================================================
+void CmdBuffer::EmitViewportAndScissor(
+    uint32_t dirtyMask)
+{
+    DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
 
-                DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
-            }
+    const bool viewportDirty = Util::TestAnyFlagSet(dirtyMask, 1u << DirtyGraphicsViewport);
+    const bool scissorDirty  = Util::TestAnyFlagSet(dirtyMask, 1u << DirtyGraphicsScissor);
 
-            if (m_allGpuState.dirtyGraphics.rasterState)
-            {
-                DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+    // The default vaule is 1.0f which means the guardband is disabled.  Values more than 1.0f enable guardband.
+    const bool isPointSizeUsed = viewportDirty && m_allGpuState.pGraphicsPipeline->IsPointSizeUsed();
+
+    utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+    do
+    {
+        const uint32_t deviceIdx = deviceGroup.Index();
 
-                PalCmdBuffer(deviceIdx)->CmdSetTriangleRasterState(m_allGpuState.triangleRasterState);
+        if (viewportDirty)
+        {
+            Pal::ViewportParams viewport = PerGpuState(deviceIdx)->viewport;
 
-                DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+            if (isPointSizeUsed)
+            {
+                viewport.horzDiscardRatio = 10.0f;
+                viewport.vertDiscardRatio = 10.0f;
             }
 
-            if (m_allGpuState.dirtyGraphics.stencilRef)
-            {
-                DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+            PalCmdBuffer(deviceIdx)->CmdSetViewports(viewport);
+        }
 
-                PalCmdBuffer(deviceIdx)->CmdSetStencilRefMasks(m_allGpuState.stencilRefMasks);
+        if (scissorDirty)
+        {
+            PalCmdBuffer(deviceIdx)->CmdSetScissorRects(PerGpuState(deviceIdx)->scissor);
+        }
+    }
+    while (deviceGroup.IterateNext());
 
-                DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
-            }
+    DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+}
 
-            if (m_allGpuState.dirtyGraphics.inputAssembly)
-            {
-                DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+// =====================================================================================================================
+void CmdBuffer::EmitDepthStencilState(
+    uint32_t dirtyMask)
+{
+    Pal::IDepthStencilState* pPalDepthStencil[MaxPalDevices] = {};
 
-                PalCmdBuffer(deviceIdx)->CmdSetInputAssemblyState(m_allGpuState.inputAssemblyState);
+    if (FindDynamicDepthStencil(m_allGpuState.depthStencilCreateInfo, pPalDepthStencil) == false)
+    {
+        RenderStateCache* pRSCache = m_pDevice->GetRenderStateCache();
 
-                DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
-            }
+        bool depthStencilExist = false;
 
-            if (m_allGpuState.dirtyGraphics.vrs)
-            {
-                DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+        pRSCache->CreateDepthStencilState(m_allGpuState.depthStencilCreateInfo,
+                                          m_pDevice->VkInstance()->GetAllocCallbacks(),
+                                          VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+                                          pPalDepthStencil);
 
-                const GraphicsPipeline* pGraphicsPipeline = m_allGpuState.pGraphicsPipeline;
+        // Check if pPalDepthStencil is already in the m_allGpuState.palDepthStencilState, destroy it
+        // and use the old one if yes. The destroy is not expensive since it's just a refCount--.
+        for (uint32_t i = 0; i < m_palDepthStencilState.NumElements(); ++i)
+        {
+            const DynamicDepthStencil palDepthStencilState = m_palDepthStencilState.At(i);
+
+            // Check device0 only should be sufficient
+            if (palDepthStencilState.pPalDepthStencil[0] == pPalDepthStencil[0])
+            {
+                depthStencilExist = true;
 
-                const bool force1x1 = (pGraphicsPipeline != nullptr) &&
-                                      (pGraphicsPipeline->Force1x1ShaderRateEnabled());
+                pRSCache->DestroyDepthStencilState(pPalDepthStencil,
+                                                   m_pDevice->VkInstance()->GetAllocCallbacks());
 
-                // CmdSetPerDrawVrsRate has been called for the dynamic state
-                // Look at the currently bound pipeline and see if we need to force the values to 1x1
-                Pal::VrsRateParams vrsRate = m_allGpuState.vrsRate;
-                if (force1x1)
+                for (uint32_t j = 0; j < MaxPalDevices; ++j)
                 {
-                    Force1x1ShaderRate(&vrsRate);
+                    pPalDepthStencil[j] = palDepthStencilState.pPalDepthStencil[j];
                 }
+                break;
+            }
+        }
 
-                PalCmdBuffer(deviceIdx)->CmdSetPerDrawVrsRate(vrsRate);
+        // Add it to the m_palDepthStencilState if it doesn't exist
+        if (!depthStencilExist)
+        {
+            DynamicDepthStencil palDepthStencilState = {};
 
-                DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+            for (uint32_t i = 0; i < MaxPalDevices; ++i)
+            {
+                palDepthStencilState.pPalDepthStencil[i] = pPalDepthStencil[i];
             }
 
-            if (m_allGpuState.dirtyGraphics.depthStencil)
-            {
-                RenderStateCache* pRSCache = m_pDevice->GetRenderStateCache();
+            m_palDepthStencilState.PushBack(palDepthStencilState);
+        }
 
-                // Check pPalDepthStencil[0] should be fine since pPalDepthStencil[i] would be nullptr when
-                // pPalDepthStencil[0] is nullptr.
-                if (pPalDepthStencil[0] == nullptr)
-                {
-                    bool depthStencilExist = false;
+        CacheDynamicDepthStencil(m_allGpuState.depthStencilCreateInfo, pPalDepthStencil);
+    }
 
-                    pRSCache->CreateDepthStencilState(m_allGpuState.depthStencilCreateInfo,
-                                                      m_pDevice->VkInstance()->GetAllocCallbacks(),
-                                                      VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
-                                                      pPalDepthStencil);
+    VK_ASSERT(pPalDepthStencil[0] != nullptr);
 
-                    // Check if pPalDepthStencil is already in the m_allGpuState.palDepthStencilState, destroy it
-                    // and use the old one if yes. The destroy is not expensive since it's just a refCount--.
-                    for (uint32_t i = 0; i < m_palDepthStencilState.NumElements(); ++i)
-                    {
-                        const DynamicDepthStencil palDepthStencilState = m_palDepthStencilState.At(i);
+    utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+    do
+    {
+        const uint32_t deviceIdx = deviceGroup.Index();
 
-                        // Check device0 only should be sufficient
-                        if (palDepthStencilState.pPalDepthStencil[0] == pPalDepthStencil[0])
-                        {
-                            depthStencilExist = true;
+        PalCmdBindDepthStencilState(
+                m_pPalCmdBuffers[deviceIdx],
+                deviceIdx,
+                pPalDepthStencil[deviceIdx]);
+    }
+    while (deviceGroup.IterateNext());
+}
 
-                            pRSCache->DestroyDepthStencilState(pPalDepthStencil,
-                                                               m_pDevice->VkInstance()->GetAllocCallbacks());
+// =====================================================================================================================
+void CmdBuffer::EmitTriangleRasterState(
+    uint32_t dirtyMask)
+{
+    DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
 
-                            for (uint32_t j = 0; j < MaxPalDevices; ++j)
-                            {
-                                pPalDepthStencil[j] = palDepthStencilState.pPalDepthStencil[j];
-                            }
-                            break;
-                        }
-                    }
+    utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+    do
+    {
+        PalCmdBuffer(deviceGroup.Index())->CmdSetTriangleRasterState(m_allGpuState.triangleRasterState);
+    }
+    while (deviceGroup.IterateNext());
 
-                    // Add it to the m_palDepthStencilState if it doesn't exist
-                    if (!depthStencilExist)
-                    {
-                        DynamicDepthStencil palDepthStencilState = {};
+    DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+}
 
-                        for (uint32_t i = 0; i < MaxPalDevices; ++i)
-                        {
-                            palDepthStencilState.pPalDepthStencil[i] = pPalDepthStencil[i];
-                        }
+// =====================================================================================================================
+void CmdBuffer::EmitInputAssemblyState(
+    uint32_t dirtyMask)
+{
+    DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
 
-                        m_palDepthStencilState.PushBack(palDepthStencilState);
-                    }
-                }
+    utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+    do
+    {
+        PalCmdBuffer(deviceGroup.Index())->CmdSetInputAssemblyState(m_allGpuState.inputAssemblyState);
+    }
+    while (deviceGroup.IterateNext());
+
+    DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+}
 
-                VK_ASSERT(pPalDepthStencil[0] != nullptr);
+// =====================================================================================================================
+void CmdBuffer::EmitStencilRefMasks(
+    uint32_t dirtyMask)
+{
+    DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
 
-                PalCmdBindDepthStencilState(
-                        m_pPalCmdBuffers[deviceIdx],
-                        deviceIdx,
-                        pPalDepthStencil[deviceIdx]);
-            }
+    utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+    do
+    {
+        PalCmdBuffer(deviceGroup.Index())->CmdSetStencilRefMasks(m_allGpuState.stencilRefMasks);
+    }
+    while (deviceGroup.IterateNext());
 
-            if (m_allGpuState.dirtyGraphics.colorWriteEnable)
-            {
-                DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+    DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+}
 
-                m_allGpuState.lastColorWriteEnableDynamic = true;
-                PalCmdBuffer(deviceGroup.Index())->CmdSetColorWriteMask(m_allGpuState.colorWriteMaskParams);
+// =====================================================================================================================
+void CmdBuffer::EmitVrsRate(
+    uint32_t dirtyMask)
+{
+    DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
 
-                DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
-            }
+    const GraphicsPipeline* pGraphicsPipeline = m_allGpuState.pGraphicsPipeline;
 
-            if (m_allGpuState.dirtyGraphics.rasterizerDiscardEnable)
-            {
-                DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+    const bool force1x1 = (pGraphicsPipeline != nullptr) &&
+                          (pGraphicsPipeline->Force1x1ShaderRateEnabled());
 
-                PalCmdBuffer(deviceGroup.Index())->CmdSetRasterizerDiscardEnable(m_allGpuState.rasterizerDiscardEnable);
+    // CmdSetPerDrawVrsRate has been called for the dynamic state
+    // Look at the currently bound pipeline and see if we need to force the values to 1x1
+    Pal::VrsRateParams vrsRate = m_allGpuState.vrsRate;
+    if (force1x1)
+    {
+        Force1x1ShaderRate(&vrsRate);
+    }
 
-                DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
-            }
+    utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+    do
+    {
+        PalCmdBuffer(deviceGroup.Index())->CmdSetPerDrawVrsRate(vrsRate);
+    }
+    while (deviceGroup.IterateNext());
 
-            if (m_allGpuState.dirtyGraphics.samplePattern && (m_allGpuState.samplePattern.sampleCount != 0))
-            {
-                PalCmdBuffer(deviceGroup.Index())->CmdSetMsaaQuadSamplePattern(
-                    m_allGpuState.samplePattern.sampleCount,
-                    m_allGpuState.samplePattern.locations);
-            }
+    DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+}
+
+// =====================================================================================================================
+void CmdBuffer::EmitColorWriteMask(
+    uint32_t dirtyMask)
+{
+    DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+
+    m_allGpuState.lastColorWriteEnableDynamic = true;
+
+    utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+    do
+    {
+        PalCmdBuffer(deviceGroup.Index())->CmdSetColorWriteMask(m_allGpuState.colorWriteMaskParams);
+    }
+    while (deviceGroup.IterateNext());
+
+    DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+}
+
+// =====================================================================================================================
+void CmdBuffer::EmitRasterizerDiscardEnable(
+    uint32_t dirtyMask)
+{
+    DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
+
+    utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+    do
+    {
+        PalCmdBuffer(deviceGroup.Index())->CmdSetRasterizerDiscardEnable(m_allGpuState.rasterizerDiscardEnable);
+    }
+    while (deviceGroup.IterateNext());
+
+    DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
+}
+
+// =====================================================================================================================
+void CmdBuffer::EmitSamplePattern(
+    uint32_t dirtyMask)
+{
+    if (m_allGpuState.samplePattern.sampleCount != 0)
+    {
+        utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+        do
+        {
+            PalCmdBuffer(deviceGroup.Index())->CmdSetMsaaQuadSamplePattern(
+                m_allGpuState.samplePattern.sampleCount,
+                m_allGpuState.samplePattern.locations);
         }
         while (deviceGroup.IterateNext());
-
-        // Clear the dirty bits
-        m_allGpuState.dirtyGraphics.u32All = 0;
     }
 }
 
@@ -9874,11 +11021,16 @@ void CmdBuffer::SetCullModeEXT(
 {
     Pal::CullMode palCullMode = VkToPalCullMode(cullMode);
 
-    if (m_allGpuState.triangleRasterState.cullMode != palCullMode)
+    if ((m_allGpuState.triangleRasterState.cullMode != palCullMode) ||
+        (CanFilterState(m_allGpuState.validGraphics.rasterState) == false))
     {
         m_allGpuState.triangleRasterState.cullMode = palCullMode;
         m_allGpuState.dirtyGraphics.rasterState            = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.rasterState++;
+    }
 
     m_allGpuState.staticTokens.triangleRasterState = DynamicRenderStateToken;
 }
@@ -9889,11 +11041,16 @@ void CmdBuffer::SetFrontFaceEXT(
 {
     Pal::FaceOrientation palFrontFace = VkToPalFaceOrientation(frontFace);
 
-    if (m_allGpuState.triangleRasterState.frontFace != palFrontFace)
+    if ((m_allGpuState.triangleRasterState.frontFace != palFrontFace) ||
+        (CanFilterState(m_allGpuState.validGraphics.rasterState) == false))
     {
         m_allGpuState.triangleRasterState.frontFace = palFrontFace;
         m_allGpuState.dirtyGraphics.rasterState             = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.rasterState++;
+    }
 
     m_allGpuState.staticTokens.triangleRasterState = DynamicRenderStateToken;
 }
@@ -9904,11 +11061,16 @@ void CmdBuffer::SetPrimitiveTopologyEXT(
 {
     Pal::PrimitiveTopology palTopology = VkToPalPrimitiveTopology(primitiveTopology);
 
-    if (m_allGpuState.inputAssemblyState.topology != palTopology)
+    if ((m_allGpuState.inputAssemblyState.topology != palTopology) ||
+        (CanFilterState(m_allGpuState.validGraphics.inputAssembly) == false))
     {
         m_allGpuState.inputAssemblyState.topology = palTopology;
         m_allGpuState.dirtyGraphics.inputAssembly         = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.inputAssembly++;
+    }
 
     m_allGpuState.staticTokens.inputAssemblyState = DynamicRenderStateToken;
 }
@@ -9917,22 +11079,32 @@ void CmdBuffer::SetPrimitiveTopologyEXT(
 void CmdBuffer::SetDepthTestEnableEXT(
     VkBool32 depthTestEnable)
 {
-    if (m_allGpuState.depthStencilCreateInfo.depthEnable != static_cast<bool>(depthTestEnable))
+    if ((m_allGpuState.depthStencilCreateInfo.depthEnable != static_cast<bool>(depthTestEnable)) ||
+        (CanFilterState(m_allGpuState.validGraphics.depthStencil) == false))
     {
         m_allGpuState.depthStencilCreateInfo.depthEnable = depthTestEnable;
         m_allGpuState.dirtyGraphics.depthStencil                 = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.depthStencil++;
+    }
 }
 
 // =====================================================================================================================
 void CmdBuffer::SetDepthWriteEnableEXT(
     VkBool32 depthWriteEnable)
 {
-    if (m_allGpuState.depthStencilCreateInfo.depthWriteEnable != static_cast<bool>(depthWriteEnable))
+    if ((m_allGpuState.depthStencilCreateInfo.depthWriteEnable != static_cast<bool>(depthWriteEnable)) ||
+        (CanFilterState(m_allGpuState.validGraphics.depthStencil) == false))
     {
         m_allGpuState.depthStencilCreateInfo.depthWriteEnable = depthWriteEnable;
         m_allGpuState.dirtyGraphics.depthStencil                      = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.depthStencil++;
+    }
 }
 
 // =====================================================================================================================
@@ -9941,33 +11113,48 @@ void CmdBuffer::SetDepthCompareOpEXT(
 {
     Pal::CompareFunc compareOp = VkToPalCompareFunc(depthCompareOp);
 
-    if (m_allGpuState.depthStencilCreateInfo.depthFunc != compareOp)
+    if ((m_allGpuState.depthStencilCreateInfo.depthFunc != compareOp) ||
+        (CanFilterState(m_allGpuState.validGraphics.depthStencil) == false))
     {
         m_allGpuState.depthStencilCreateInfo.depthFunc = compareOp;
         m_allGpuState.dirtyGraphics.depthStencil               = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.depthStencil++;
+    }
 }
 
 // =====================================================================================================================
 void CmdBuffer::SetDepthBoundsTestEnableEXT(
     VkBool32 depthBoundsTestEnable)
 {
-    if (m_allGpuState.depthStencilCreateInfo.depthBoundsEnable != static_cast<bool>(depthBoundsTestEnable))
+    if ((m_allGpuState.depthStencilCreateInfo.depthBoundsEnable != static_cast<bool>(depthBoundsTestEnable)) ||
+        (CanFilterState(m_allGpuState.validGraphics.depthStencil) == false))
     {
         m_allGpuState.depthStencilCreateInfo.depthBoundsEnable = depthBoundsTestEnable;
         m_allGpuState.dirtyGraphics.depthStencil                       = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.depthStencil++;
+    }
 }
 
 // =====================================================================================================================
 void CmdBuffer::SetStencilTestEnableEXT(
     VkBool32 stencilTestEnable)
 {
-    if (m_allGpuState.depthStencilCreateInfo.stencilEnable != static_cast<bool>(stencilTestEnable))
+    if ((m_allGpuState.depthStencilCreateInfo.stencilEnable != static_cast<bool>(stencilTestEnable)) ||
+        (CanFilterState(m_allGpuState.validGraphics.depthStencil) == false))
     {
         m_allGpuState.depthStencilCreateInfo.stencilEnable = stencilTestEnable;
         m_allGpuState.dirtyGraphics.depthStencil                   = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.depthStencil++;
+    }
 }
 
 // =====================================================================================================================
@@ -9985,6 +11172,8 @@ void CmdBuffer::SetStencilOpEXT(
 
     Pal::DepthStencilStateCreateInfo* pCreateInfo = &(m_allGpuState.depthStencilCreateInfo);
 
+    bool changed = false;
+
     if (faceMask & VK_STENCIL_FACE_FRONT_BIT)
     {
         if ((pCreateInfo->front.stencilFailOp != palFailOp) ||
@@ -9997,7 +11186,7 @@ void CmdBuffer::SetStencilOpEXT(
             pCreateInfo->front.stencilDepthFailOp = palDepthFailOp;
             pCreateInfo->front.stencilFunc        = palCompareOp;
 
-            m_allGpuState.dirtyGraphics.depthStencil = 1;
+            changed = true;
         }
     }
 
@@ -10013,9 +11202,18 @@ void CmdBuffer::SetStencilOpEXT(
             pCreateInfo->back.stencilDepthFailOp = palDepthFailOp;
             pCreateInfo->back.stencilFunc        = palCompareOp;
 
-            m_allGpuState.dirtyGraphics.depthStencil = 1;
+            changed = true;
         }
     }
+
+    if (changed || (CanFilterState(m_allGpuState.validGraphics.depthStencil) == false))
+    {
+        m_allGpuState.dirtyGraphics.depthStencil = 1;
+    }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.depthStencil++;
+    }
 }
 
 // =====================================================================================================================
@@ -10055,11 +11253,16 @@ void CmdBuffer::SetRasterizerDiscardEnableEXT(
 void CmdBuffer::SetPrimitiveRestartEnableEXT(
     VkBool32                                   primitiveRestartEnable)
 {
-    if (m_allGpuState.inputAssemblyState.primitiveRestartEnable != static_cast<bool>(primitiveRestartEnable))
+    if ((m_allGpuState.inputAssemblyState.primitiveRestartEnable != static_cast<bool>(primitiveRestartEnable)) ||
+        (CanFilterState(m_allGpuState.validGraphics.inputAssembly) == false))
     {
         m_allGpuState.inputAssemblyState.primitiveRestartEnable = primitiveRestartEnable;
         m_allGpuState.dirtyGraphics.inputAssembly                       = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.inputAssembly++;
+    }
 
     m_allGpuState.staticTokens.inputAssemblyState = DynamicRenderStateToken;
 }
@@ -10069,12 +11272,17 @@ void CmdBuffer::SetDepthBiasEnableEXT(
     VkBool32                                   depthBiasEnable)
 {
     if ((m_allGpuState.triangleRasterState.flags.frontDepthBiasEnable != depthBiasEnable) ||
-        (m_allGpuState.triangleRasterState.flags.backDepthBiasEnable  != depthBiasEnable))
+        (m_allGpuState.triangleRasterState.flags.backDepthBiasEnable  != depthBiasEnable) ||
+        (CanFilterState(m_allGpuState.validGraphics.rasterState) == false))
     {
         m_allGpuState.triangleRasterState.flags.frontDepthBiasEnable = depthBiasEnable;
         m_allGpuState.triangleRasterState.flags.backDepthBiasEnable  = depthBiasEnable;
         m_allGpuState.dirtyGraphics.rasterState                      = 1;
     }
+    else if (m_flags.collectRecordingStats)
+    {
+        m_redundantStateStats.rasterState++;
+    }
 
     m_allGpuState.staticTokens.triangleRasterState = DynamicRenderStateToken;
 }
@@ -38,6 +38,7 @@
 #include "include/vk_queue.h"
 #include "include/vk_descriptor_set_layout.h"
 #include "include/vk_descriptor_set.h"
+#include "include/log.h"
 
 #include "palInlineFuncs.h"
 #include "palDevice.h"
@@ -234,6 +235,8 @@ VkResult DescriptorPool::Init(
 template <uint32_t numPalDevices>
 VkResult DescriptorPool::Reset()
 {
+    m_gpuMemHeap.LogDynamicAllocStats(m_pDevice->GetRuntimeSettings().logTagIdMask);
+
     m_setHeap.Reset<numPalDevices>();
     m_gpuMemHeap.Reset();
 
@@ -254,6 +257,8 @@ VkResult DescriptorPool::Destroy(
         &data,
         sizeof(Pal::ResourceDestroyEventData));
 
+    m_gpuMemHeap.LogDynamicAllocStats(pDevice->GetRuntimeSettings().logTagIdMask);
+
     // Destroy children heaps
     m_setHeap.Destroy(pDevice, pAllocator);
     m_gpuMemHeap.Destroy(pDevice, pAllocator);
@@ -324,7 +329,12 @@ VkResult DescriptorPool::AllocDescriptorSets(
                 Pal::gpusize setGpuMemOffset;
                 void* pSetAllocHandle;
 
-                if (m_gpuMemHeap.AllocSetGpuMem(pLayout, variableDescriptorCounts, &setGpuMemOffset, &pSetAllocHandle))
+                result = m_gpuMemHeap.AllocSetGpuMem(pLayout,
+                                                     variableDescriptorCounts,
+                                                     &setGpuMemOffset,
+                                                     &pSetAllocHandle);
+
+                if (result == VK_SUCCESS)
                 {
                     // Allocation succeeded: Mark this
                     // Reallocate this descriptor set to use the allocated GPU range and layout
@@ -351,11 +361,8 @@ VkResult DescriptorPool::AllocDescriptorSets(
                         pSet->WriteImmutableSamplers(m_pDevice->GetProperties().descriptorSizes.imageView);
                     }
                 }
-                else
-                {
-                    // State set will be released in error case handling below, since non-null handle is present
-                    result = VK_ERROR_OUT_OF_POOL_MEMORY;
-                }
+                // Otherwise the state set will be released in error case handling below, since non-null handle is
+                // present
 
                 allocCount++;
             }
@@ -418,6 +425,10 @@ VkResult DescriptorPool::FreeDescriptorSets(
 DescriptorGpuMemHeap::DescriptorGpuMemHeap() :
 m_usage(0),
 m_oneShotAllocForward(0),
+m_ppDynamicAllocFreeLists(nullptr),
+m_dynamicAllocFlBitmap(0),
+m_dynamicAllocFreeSize(0),
+m_dynamicAllocFreeBlockCount(0),
 m_pDynamicAllocBlocks(nullptr),
 m_dynamicAllocBlockCount(0),
 m_pDynamicAllocBlockIndexStack(nullptr),
@@ -429,6 +440,7 @@ m_numPalDevices(0)
     m_gpuMemOffsetRangeStart = 0;
     m_gpuMemOffsetRangeEnd   = 0;
 
+    memset(m_dynamicAllocSlBitmap, 0, sizeof(m_dynamicAllocSlBitmap));
     memset(m_pCpuAddr, 0, sizeof(m_pCpuAddr));
     memset(m_pCpuShadowAddr, 0, sizeof(m_pCpuShadowAddr));
 }
@@ -470,16 +482,20 @@ VkResult DescriptorGpuMemHeap::Init(
 
     if (oneShot == false) //DYNAMIC USAGE
     {
+        // Dynamic allocations are rounded up to the set alignment so that every block starts aligned.
+        m_gpuMemSize = Util::Pow2Align(m_gpuMemSize, m_gpuMemAddrAlignment);
+
         // In case of dynamic descriptor pools we have to prepare our management structures.
         // There can be at most maxSets * 2 + 1 blocks in a pool.
         m_dynamicAllocBlockCount    = (maxSets * 2 + 1);
         size_t blockStorageSize     = m_dynamicAllocBlockCount * sizeof(DynamicAllocBlock);
+        size_t freeListStorageSize  = DynamicAllocFreeListCount * sizeof(DynamicAllocBlock*);
         size_t blockIndexStackSize  = m_dynamicAllocBlockCount * sizeof(uint32_t);
 
         // Allocate system memory for the management structures
         void* pMemory = pAllocator->pfnAllocation(
             pAllocator->pUserData,
-            blockStorageSize + blockIndexStackSize,
+            blockStorageSize + freeListStorageSize + blockIndexStackSize,
             VK_DEFAULT_MEM_ALIGN,
             VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
 
@@ -489,15 +505,15 @@ VkResult DescriptorGpuMemHeap::Init(
         }
 
         // Initialize the management structures
-        m_dynamicAllocBlockFreeListHeader.pPrevFree = nullptr;
-        m_dynamicAllocBlockFreeListHeader.pNextFree = nullptr;
-        m_dynamicAllocBlockFreeListHeader.pPrev     = nullptr;
-        m_dynamicAllocBlockFreeListHeader.pNext     = nullptr;
-
         m_pDynamicAllocBlocks               = reinterpret_cast<DynamicAllocBlock*>(pMemory);
-        m_pDynamicAllocBlockIndexStack      = reinterpret_cast<uint32_t*>(Util::VoidPtrInc(pMemory, blockStorageSize));
+        m_ppDynamicAllocFreeLists           = reinterpret_cast<DynamicAllocBlock**>(
+                                                  Util::VoidPtrInc(pMemory, blockStorageSize));
+        m_pDynamicAllocBlockIndexStack      = reinterpret_cast<uint32_t*>(
+                                                  Util::VoidPtrInc(pMemory, blockStorageSize + freeListStorageSize));
         m_dynamicAllocBlockIndexStackCount  = m_dynamicAllocBlockCount;
 
+        memset(m_ppDynamicAllocFreeLists, 0, freeListStorageSize);
+
         for (uint32_t i = 0; i < m_dynamicAllocBlockIndexStackCount; ++i)
         {
             m_pDynamicAllocBlockIndexStack[i] = i;
@@ -536,25 +552,46 @@ void DescriptorGpuMemHeap::SanityCheckDynamicAllocBlockList()
     DynamicAllocBlock*  pBlock      = nullptr;
     DynamicAllocBlock*  pPrevBlock  = nullptr;
 
-    // Sanity check the free block list.
-    pPrevBlock = &m_dynamicAllocBlockFreeListHeader;
-    pBlock = m_dynamicAllocBlockFreeListHeader.pNextFree;
+    // Sanity check the size class free lists.
+    Pal::gpusize freeSize = 0;
     blockCount = 0;
-    while (pBlock != nullptr)
+    for (uint32_t listIdx = 0; listIdx < DynamicAllocFreeListCount; ++listIdx)
     {
-        blockCount++;
+        const uint32_t fl = listIdx / DynamicAllocSlCount;
+        const uint32_t sl = listIdx % DynamicAllocSlCount;
 
-        // The number of blocks in the free list should not exceed half of the blocks, otherwise that's an indication
-        // of a loop in the list of free blocks.
-        VK_ASSERT(blockCount <= (m_dynamicAllocBlockCount / 2 + 1));
+        // The bitmaps should exactly describe the non-empty lists.
+        VK_ASSERT((m_ppDynamicAllocFreeLists[listIdx] != nullptr) ==
+                  (Util::TestAnyFlagSet(m_dynamicAllocSlBitmap[fl], 1u << sl)));
+        VK_ASSERT((m_dynamicAllocSlBitmap[fl] != 0) == Util::TestAnyFlagSet(m_dynamicAllocFlBitmap, 1u << fl));
 
-        // The pPrevFree field should point to the previous block in the free list.
-        VK_ASSERT(pBlock->pPrevFree == pPrevBlock);
+        pPrevBlock = nullptr;
+        pBlock     = m_ppDynamicAllocFreeLists[listIdx];
+        while (pBlock != nullptr)
+        {
+            blockCount++;
 
-        pPrevBlock = pBlock;
-        pBlock = pBlock->pNextFree;
+            // The number of free blocks should not exceed half of the blocks, otherwise that's an indication
+            // of a loop in the list of free blocks.
+            VK_ASSERT(blockCount <= (m_dynamicAllocBlockCount / 2 + 1));
+
+            // The pPrevFree field should point to the previous block in the free list, and the block should be in the
+            // list of its size class.
+            VK_ASSERT(pBlock->pPrevFree == pPrevBlock);
+            VK_ASSERT(pBlock->freeListIndex == listIdx);
+            VK_ASSERT(DynamicAllocFreeListIndex(static_cast<uint32_t>(
+                (pBlock->gpuMemOffsetRangeEnd - pBlock->gpuMemOffsetRangeStart) / m_gpuMemAddrAlignment)) == listIdx);
+
+            freeSize += (pBlock->gpuMemOffsetRangeEnd - pBlock->gpuMemOffsetRangeStart);
+
+            pPrevBlock = pBlock;
+            pBlock     = pBlock->pNextFree;
+        }
     }
 
+    VK_ASSERT(blockCount == m_dynamicAllocFreeBlockCount);
+    VK_ASSERT(freeSize == m_dynamicAllocFreeSize);
+
     // Find the first node in the complete block list.
     pBlock = nullptr;
     for (uint32_t i = 0; i < m_dynamicAllocBlockCount; ++i)
@@ -617,7 +654,7 @@ void DescriptorGpuMemHeap::SanityCheckDynamicAllocBlockList()
 // =====================================================================================================================
 // Allocates enough GPU memory to contain the given descriptor set layout.  Returns back a GPU VA offset and an opaque
 // handle that can be used to free that memory for non-one-shot allocations.
-bool DescriptorGpuMemHeap::AllocSetGpuMem(
+VkResult DescriptorGpuMemHeap::AllocSetGpuMem(
     const DescriptorSetLayout*  pLayout,
     uint32_t                    variableDescriptorCounts,
     Pal::gpusize*               pSetGpuMemOffset,
@@ -646,7 +683,7 @@ bool DescriptorGpuMemHeap::AllocSetGpuMem(
         *pSetAllocHandle  = nullptr;
         *pSetGpuMemOffset = 0;
 
-        return true;
+        return VK_SUCCESS;
     }
     bool oneShot = (m_usage & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT) == 0;
 
@@ -662,91 +699,85 @@ bool DescriptorGpuMemHeap::AllocSetGpuMem(
 
             m_oneShotAllocForward = gpuBaseOffset + byteSize;
 
-            return true;
+            return VK_SUCCESS;
         }
     }
-    // For dynamic allocations, do something more complicated
+    // For dynamic allocations, carve the set out of a free block of a large enough size class
     else
     {
-        DynamicAllocBlock* pBlock = m_dynamicAllocBlockFreeListHeader.pNextFree;
+        const Pal::gpusize allocSize = Util::Pow2Align(static_cast<Pal::gpusize>(byteSize), alignment);
 
-        while (pBlock != nullptr)
+        DynamicAllocBlock* pBlock = FindFreeDynamicAllocBlock(allocSize);
+
+        if (pBlock != nullptr)
         {
-            Pal::gpusize gpuBaseOffset  = Util::Pow2Align(pBlock->gpuMemOffsetRangeStart, alignment);
-            Pal::gpusize newBlockStart  = gpuBaseOffset + byteSize;
+            const Pal::gpusize newBlockStart = pBlock->gpuMemOffsetRangeStart + allocSize;
+
+            VK_ASSERT(Util::IsPow2Aligned(pBlock->gpuMemOffsetRangeStart, alignment));
+            VK_ASSERT(newBlockStart <= pBlock->gpuMemOffsetRangeEnd);
+
+            *pSetAllocHandle  = pBlock;
+            *pSetGpuMemOffset = pBlock->gpuMemOffsetRangeStart;
+
+            RemoveFreeDynamicAllocBlock(pBlock);
 
-            if (newBlockStart <= pBlock->gpuMemOffsetRangeEnd)
+            // If there's space left in this block then let's remember it.
+            if (newBlockStart < pBlock->gpuMemOffsetRangeEnd)
             {
-                *pSetAllocHandle  = pBlock;
-                *pSetGpuMemOffset = gpuBaseOffset;
+                // If the next block is a free one then attach the remaining range to it.  It may move to a larger
+                // size class, so take it off its free list while it grows.
+                if (IsDynamicAllocBlockFree(pBlock->pNext))
+                {
+                    VK_ASSERT(pBlock->gpuMemOffsetRangeEnd == pBlock->pNext->gpuMemOffsetRangeStart);
+
+                    RemoveFreeDynamicAllocBlock(pBlock->pNext);
+
+                    pBlock->pNext->gpuMemOffsetRangeStart = newBlockStart;
 
-                // If there's space left in this block then let's remember it.
-                if (newBlockStart < pBlock->gpuMemOffsetRangeEnd)
+                    InsertFreeDynamicAllocBlock(pBlock->pNext);
+                }
+                else
+                // Otherwise create a new free block for the remaining range.
                 {
-                    // If the next block is a free one then attach the remaining range to it.
-                    if (IsDynamicAllocBlockFree(pBlock->pNext))
-                    {
-                        VK_ASSERT(pBlock->gpuMemOffsetRangeEnd == pBlock->pNext->gpuMemOffsetRangeStart);
+                    VK_ASSERT(m_dynamicAllocBlockIndexStackCount > 0);
+                    uint32_t newBlockIndex = m_pDynamicAllocBlockIndexStack[--m_dynamicAllocBlockIndexStackCount];
 
-                        pBlock->pNext->gpuMemOffsetRangeStart = newBlockStart;
-                    }
-                    else
-                    // Otherwise create a new free block for the remaining range.
+                    DynamicAllocBlock* pNewBlock      = &m_pDynamicAllocBlocks[newBlockIndex];
+                    pNewBlock->pPrev                  = pBlock;
+                    pNewBlock->pNext                  = pBlock->pNext;
+                    pNewBlock->gpuMemOffsetRangeStart = newBlockStart;
+                    pNewBlock->gpuMemOffsetRangeEnd   = pBlock->gpuMemOffsetRangeEnd;
+
+                    if (pNewBlock->pNext != nullptr)
                     {
-                        VK_ASSERT(m_dynamicAllocBlockIndexStackCount > 0);
-                        uint32_t newBlockIndex = m_pDynamicAllocBlockIndexStack[--m_dynamicAllocBlockIndexStackCount];
-
-                        DynamicAllocBlock* pNewBlock      = &m_pDynamicAllocBlocks[newBlockIndex];
-                        pNewBlock->pPrevFree              = pBlock;
-                        pNewBlock->pNextFree              = pBlock->pNextFree;
-                        pNewBlock->pPrev                  = pBlock;
-                        pNewBlock->pNext                  = pBlock->pNext;
-                        pNewBlock->gpuMemOffsetRangeStart = newBlockStart;
-                        pNewBlock->gpuMemOffsetRangeEnd   = pBlock->gpuMemOffsetRangeEnd;
-
-                        if (pNewBlock->pNextFree != nullptr)
-                        {
-                            pNewBlock->pNextFree->pPrevFree = pNewBlock;
-                        }
-
-                        if (pNewBlock->pNext != nullptr)
-                        {
-                            pNewBlock->pNext->pPrev = pNewBlock;
-                        }
-
-                        pBlock->pNextFree               = pNewBlock;
-                        pBlock->pNext                   = pNewBlock;
+                        pNewBlock->pNext->pPrev = pNewBlock;
                     }
 
-                    // Truncate the block to the allocated size.
-                    pBlock->gpuMemOffsetRangeEnd = newBlockStart;
-                }
-
-                // Unlink this block from the list of free blocks.
+                    pBlock->pNext = pNewBlock;
 
-                pBlock->pPrevFree->pNextFree = pBlock->pNextFree;
-                if (pBlock->pNextFree != nullptr)
-                {
-                    pBlock->pNextFree->pPrevFree = pBlock->pPrevFree;
+                    InsertFreeDynamicAllocBlock(pNewBlock);
                 }
 
-                pBlock->pNextFree   = nullptr;
-                pBlock->pPrevFree   = nullptr;
+                // Truncate the block to the allocated size.
+                pBlock->gpuMemOffsetRangeEnd = newBlockStart;
+            }
 
 #if DEBUG
-                // Sanity check the lists after a successful allocation.
-                SanityCheckDynamicAllocBlockList();
+            // Sanity check the lists after a successful allocation.
+            SanityCheckDynamicAllocBlockList();
 #endif
 
-                return true;
-            }
+            return VK_SUCCESS;
+        }
 
-            // Advance to the next free block.
-            pBlock      = pBlock->pNextFree;
+        // Enough memory is free but no single free block can hold the set.
+        if (m_dynamicAllocFreeSize >= allocSize)
+        {
+            return VK_ERROR_FRAGMENTED_POOL;
         }
     }
 
-    return false;
+    return VK_ERROR_OUT_OF_POOL_MEMORY;
 }
 
 // =====================================================================================================================
@@ -818,93 +849,65 @@ void DescriptorGpuMemHeap::FreeSetGpuMem(
         DynamicAllocBlock* pBlock = reinterpret_cast<DynamicAllocBlock*>(pSetAllocHandle);
 
         // At this point this block should not be on the free list.
-        VK_ASSERT((pBlock->pPrevFree == nullptr) && (pBlock->pNextFree == nullptr));
+        VK_ASSERT(IsDynamicAllocBlockFree(pBlock) == false);
 
         // The deallocation process is as follows:
-        //   1. If the next block is free then:
-        //      a. Merge the range of the block into the next block
-        //      b. Unlink the block from the list and release it
-        //      c. Continue as if the next block was the original block
-        //   2. If the previous block is free then:
-        //      a. If this block is on the free list then unlink the block from the it
-        //      b. Merge the range of the block into the previous block
-        //      c. Unlink the block from the list and release it
-        //   3. If we didn't release the block earlier then it means neither the previous or the next block was
-        //      free, thus we should simply link this block to the list of free blocks (it doesn't matter where
-        //      we link the block in the free list as that doesn't have to be necessarily ordered)
-
-        bool blockReleased = false;
-
-        // If the next block is a free one then attach the range of this block to it.
+        //   1. If the next block is free then take it off its free list, merge its range into the block, unlink it
+        //      from the list and release it
+        //   2. If the previous block is free then take it off its free list, merge the range of the block into it,
+        //      unlink the block from the list, release it and continue with the previous block
+        //   3. Link the resulting block to the free list of its size class
+
+        // If the next block is a free one then attach its range to this block.
         if (IsDynamicAllocBlockFree(pBlock->pNext))
         {
-            VK_ASSERT(pBlock->gpuMemOffsetRangeEnd == pBlock->pNext->gpuMemOffsetRangeStart);
-
             DynamicAllocBlock* pNextBlock = pBlock->pNext;
 
-            // Merge the range of the block into the next block.
-            pBlock->pNext->gpuMemOffsetRangeStart = pBlock->gpuMemOffsetRangeStart;
+            VK_ASSERT(pBlock->gpuMemOffsetRangeEnd == pNextBlock->gpuMemOffsetRangeStart);
 
-            // Unlink the block from the list.
-            pBlock->pNext->pPrev = pBlock->pPrev;
-            if (pBlock->pPrev != nullptr)
+            RemoveFreeDynamicAllocBlock(pNextBlock);
+
+            // Merge the range of the next block into the block.
+            pBlock->gpuMemOffsetRangeEnd = pNextBlock->gpuMemOffsetRangeEnd;
+
+            // Unlink the next block from the list.
+            pBlock->pNext = pNextBlock->pNext;
+            if (pBlock->pNext != nullptr)
             {
-                pBlock->pPrev->pNext = pBlock->pNext;
+                pBlock->pNext->pPrev = pBlock;
             }
 
-            // Then release the block.
-            m_pDynamicAllocBlockIndexStack[m_dynamicAllocBlockIndexStackCount++] = DynamicAllocBlockIndex(pBlock);
-            blockReleased = true;
-
-            // Set the next block as the block.
-            pBlock = pNextBlock;
+            // Then release the next block.
+            m_pDynamicAllocBlockIndexStack[m_dynamicAllocBlockIndexStackCount++] = DynamicAllocBlockIndex(pNextBlock);
         }
 
         // If the previous block is a free one then attach the range of this block to it.
         if (IsDynamicAllocBlockFree(pBlock->pPrev))
         {
-            VK_ASSERT(pBlock->gpuMemOffsetRangeStart == pBlock->pPrev->gpuMemOffsetRangeEnd);
+            DynamicAllocBlock* pPrevBlock = pBlock->pPrev;
 
-            // If this block is on the free list then unlink the block from it.
-            if (pBlock->pPrevFree != nullptr)
-            {
-                pBlock->pPrevFree->pNextFree = pBlock->pNextFree;
-            }
-            if (pBlock->pNextFree != nullptr)
-            {
-                pBlock->pNextFree->pPrevFree = pBlock->pPrevFree;
-            }
+            VK_ASSERT(pBlock->gpuMemOffsetRangeStart == pPrevBlock->gpuMemOffsetRangeEnd);
+
+            RemoveFreeDynamicAllocBlock(pPrevBlock);
 
             // Merge the range of the block into the previous block.
-            pBlock->pPrev->gpuMemOffsetRangeEnd = pBlock->gpuMemOffsetRangeEnd;
+            pPrevBlock->gpuMemOffsetRangeEnd = pBlock->gpuMemOffsetRangeEnd;
 
             // Unlink the block from the list.
-            pBlock->pPrev->pNext = pBlock->pNext;
+            pPrevBlock->pNext = pBlock->pNext;
             if (pBlock->pNext != nullptr)
             {
-                pBlock->pNext->pPrev = pBlock->pPrev;
+                pBlock->pNext->pPrev = pPrevBlock;
             }
 
             // Then release the block.
             m_pDynamicAllocBlockIndexStack[m_dynamicAllocBlockIndexStackCount++] = DynamicAllocBlockIndex(pBlock);
-            blockReleased = true;
-        }
-
-        // If we didn't release the block so far then let's just link it to the list of free blocks
-        if (!blockReleased)
-        {
-            pBlock->pNextFree = m_dynamicAllocBlockFreeListHeader.pNextFree;
 
-            if (pBlock->pNextFree != nullptr)
-            {
-                pBlock->pNextFree->pPrevFree = pBlock;
-            }
-
-            pBlock->pPrevFree = &m_dynamicAllocBlockFreeListHeader;
-
-            m_dynamicAllocBlockFreeListHeader.pNextFree = pBlock;
+            pBlock = pPrevBlock;
         }
 
+        InsertFreeDynamicAllocBlock(pBlock);
+
 #if DEBUG
         // Sanity check the lists after a successful destroy.
         SanityCheckDynamicAllocBlockList();
@@ -929,7 +932,14 @@ void DescriptorGpuMemHeap::Reset()
         VK_ASSERT(m_pDynamicAllocBlockIndexStack != nullptr);
 
         // For dynamic allocations the only thing we have to do is release all blocks by resetting the free index stack
-        // and then reinitializing the free block list with a single entry covering the entire range.
+        // and then reinitializing the free block lists with a single entry covering the entire range.
+
+        memset(m_ppDynamicAllocFreeLists, 0, DynamicAllocFreeListCount * sizeof(DynamicAllocBlock*));
+        memset(m_dynamicAllocSlBitmap, 0, sizeof(m_dynamicAllocSlBitmap));
+
+        m_dynamicAllocFlBitmap       = 0;
+        m_dynamicAllocFreeSize       = 0;
+        m_dynamicAllocFreeBlockCount = 0;
 
         m_dynamicAllocBlockIndexStackCount = m_dynamicAllocBlockCount;
 
@@ -941,14 +951,218 @@ void DescriptorGpuMemHeap::Reset()
         uint32_t blockIndex = m_pDynamicAllocBlockIndexStack[--m_dynamicAllocBlockIndexStackCount];
 
         DynamicAllocBlock* pBlock      = &m_pDynamicAllocBlocks[blockIndex];
-        pBlock->pPrevFree              = &m_dynamicAllocBlockFreeListHeader;
-        pBlock->pNextFree              = nullptr;
         pBlock->pPrev                  = nullptr;
         pBlock->pNext                  = nullptr;
         pBlock->gpuMemOffsetRangeStart = m_gpuMemOffsetRangeStart;
         pBlock->gpuMemOffsetRangeEnd   = m_gpuMemOffsetRangeEnd;
 
-        m_dynamicAllocBlockFreeListHeader.pNextFree = pBlock;
+        if (m_gpuMemOffsetRangeEnd > m_gpuMemOffsetRangeStart)
+        {
+            InsertFreeDynamicAllocBlock(pBlock);
+        }
+        else
+        {
+            pBlock->freeListIndex = NotFreeListIndex;
+        }
+    }
+}
+
+// =====================================================================================================================
+// Returns the size class free list index of a free block of the given size in units of the set alignment.
+uint32_t DescriptorGpuMemHeap::DynamicAllocFreeListIndex(
+    uint32_t sizeInUnits)
+{
+    VK_ASSERT(sizeInUnits > 0);
+
+    const uint32_t fl = Util::Log2(sizeInUnits);
+    const uint32_t sl = (fl >= DynamicAllocSlBits) ? (sizeInUnits >> (fl - DynamicAllocSlBits))
+                                                   : (sizeInUnits << (DynamicAllocSlBits - fl));
+
+    return (fl * DynamicAllocSlCount) + (sl & (DynamicAllocSlCount - 1));
+}
+
+// =====================================================================================================================
+// Links a free block to the head of the free list of its size class.
+void DescriptorGpuMemHeap::InsertFreeDynamicAllocBlock(
+    DynamicAllocBlock* pBlock)
+{
+    const Pal::gpusize size    = pBlock->gpuMemOffsetRangeEnd - pBlock->gpuMemOffsetRangeStart;
+    const uint32_t     listIdx = DynamicAllocFreeListIndex(static_cast<uint32_t>(size / m_gpuMemAddrAlignment));
+    const uint32_t     fl      = listIdx / DynamicAllocSlCount;
+    const uint32_t     sl      = listIdx % DynamicAllocSlCount;
+
+    pBlock->freeListIndex = listIdx;
+    pBlock->pPrevFree     = nullptr;
+    pBlock->pNextFree     = m_ppDynamicAllocFreeLists[listIdx];
+
+    if (pBlock->pNextFree != nullptr)
+    {
+        pBlock->pNextFree->pPrevFree = pBlock;
+    }
+
+    m_ppDynamicAllocFreeLists[listIdx] = pBlock;
+
+    m_dynamicAllocSlBitmap[fl] |= (1u << sl);
+    m_dynamicAllocFlBitmap     |= (1u << fl);
+
+    m_dynamicAllocFreeSize += size;
+    m_dynamicAllocFreeBlockCount++;
+}
+
+// =====================================================================================================================
+// Unlinks a free block from the free list of its size class and marks it as allocated.
+void DescriptorGpuMemHeap::RemoveFreeDynamicAllocBlock(
+    DynamicAllocBlock* pBlock)
+{
+    VK_ASSERT(IsDynamicAllocBlockFree(pBlock));
+
+    const uint32_t listIdx = pBlock->freeListIndex;
+
+    if (pBlock->pPrevFree != nullptr)
+    {
+        pBlock->pPrevFree->pNextFree = pBlock->pNextFree;
+    }
+    else
+    {
+        m_ppDynamicAllocFreeLists[listIdx] = pBlock->pNextFree;
+    }
+
+    if (pBlock->pNextFree != nullptr)
+    {
+        pBlock->pNextFree->pPrevFree = pBlock->pPrevFree;
+    }
+
+    if (m_ppDynamicAllocFreeLists[listIdx] == nullptr)
+    {
+        const uint32_t fl = listIdx / DynamicAllocSlCount;
+        const uint32_t sl = listIdx % DynamicAllocSlCount;
+
+        m_dynamicAllocSlBitmap[fl] &= ~(1u << sl);
+
+        if (m_dynamicAllocSlBitmap[fl] == 0)
+        {
+            m_dynamicAllocFlBitmap &= ~(1u << fl);
+        }
+    }
+
+    pBlock->pPrevFree     = nullptr;
+    pBlock->pNextFree     = nullptr;
+    pBlock->freeListIndex = NotFreeListIndex;
+
+    m_dynamicAllocFreeSize -= (pBlock->gpuMemOffsetRangeEnd - pBlock->gpuMemOffsetRangeStart);
+    m_dynamicAllocFreeBlockCount--;
+}
+
+// =====================================================================================================================
+// Returns a free block of at least byteSize bytes, or null if there is none.  The request is rounded up to the next
+// size class boundary so that the head of any non-empty list at or above that class fits, which the bitmaps find in
+// constant time.  Only when that fails is the list of the request's own size class searched for a block that fits.
+DescriptorGpuMemHeap::DynamicAllocBlock* DescriptorGpuMemHeap::FindFreeDynamicAllocBlock(
+    Pal::gpusize byteSize) const
+{
+    DynamicAllocBlock* pBlock = nullptr;
+
+    const uint32_t sizeInUnits = static_cast<uint32_t>(byteSize / m_gpuMemAddrAlignment);
+    const uint32_t sizeFl      = Util::Log2(sizeInUnits);
+    const uint64_t roundUp     = (sizeFl >= DynamicAllocSlBits) ? ((1ull << (sizeFl - DynamicAllocSlBits)) - 1) : 0;
+    const uint64_t searchUnits = sizeInUnits + roundUp;
+
+    if (searchUnits <= UINT32_MAX)
+    {
+        const uint32_t searchIdx = DynamicAllocFreeListIndex(static_cast<uint32_t>(searchUnits));
+
+        uint32_t fl    = searchIdx / DynamicAllocSlCount;
+        uint32_t slMap = m_dynamicAllocSlBitmap[fl] & (~0u << (searchIdx % DynamicAllocSlCount));
+
+        if (slMap == 0)
+        {
+            // Nothing in the remaining second level classes, so look for the next non-empty first level class.
+            const uint32_t flMap = (fl + 1 < DynamicAllocFlCount) ? (m_dynamicAllocFlBitmap & (~0u << (fl + 1))) : 0;
+
+            if (Util::BitMaskScanForward(&fl, flMap))
+            {
+                slMap = m_dynamicAllocSlBitmap[fl];
+            }
+        }
+
+        uint32_t sl = 0;
+
+        if (Util::BitMaskScanForward(&sl, slMap))
+        {
+            pBlock = m_ppDynamicAllocFreeLists[(fl * DynamicAllocSlCount) + sl];
+        }
+    }
+
+    if (pBlock == nullptr)
+    {
+        // Blocks of the request's own size class may still be large enough.
+        pBlock = m_ppDynamicAllocFreeLists[DynamicAllocFreeListIndex(sizeInUnits)];
+
+        while ((pBlock != nullptr) && ((pBlock->gpuMemOffsetRangeEnd - pBlock->gpuMemOffsetRangeStart) < byteSize))
+        {
+            pBlock = pBlock->pNextFree;
+        }
+    }
+
+    return pBlock;
+}
+
+// =====================================================================================================================
+// Returns statistics about the free memory of a heap with dynamic allocations.
+void DescriptorGpuMemHeap::GetDynamicAllocStats(
+    DescriptorGpuMemHeapStats* pStats) const
+{
+    VK_ASSERT(pStats != nullptr);
+
+    pStats->freeSize         = m_dynamicAllocFreeSize;
+    pStats->largestFreeBlock = 0;
+    pStats->freeBlockCount   = m_dynamicAllocFreeBlockCount;
+    pStats->fragmentation    = 0.0f;
+
+    uint32_t fl = 0;
+
+    // The largest free block is in the highest non-empty size class.
+    if (Util::BitMaskScanReverse(&fl, m_dynamicAllocFlBitmap))
+    {
+        uint32_t sl = 0;
+
+        Util::BitMaskScanReverse(&sl, static_cast<uint32_t>(m_dynamicAllocSlBitmap[fl]));
+
+        for (const DynamicAllocBlock* pBlock = m_ppDynamicAllocFreeLists[(fl * DynamicAllocSlCount) + sl];
+             pBlock != nullptr;
+             pBlock = pBlock->pNextFree)
+        {
+            pStats->largestFreeBlock = Util::Max(pStats->largestFreeBlock,
+                                                 pBlock->gpuMemOffsetRangeEnd - pBlock->gpuMemOffsetRangeStart);
+        }
+
+        pStats->fragmentation = 1.0f - static_cast<float>(static_cast<double>(pStats->largestFreeBlock) /
+                                                          static_cast<double>(pStats->freeSize));
+    }
+}
+
+// =====================================================================================================================
+// Logs the free memory statistics of a heap with dynamic allocations before it is reset or destroyed.
+void DescriptorGpuMemHeap::LogDynamicAllocStats(
+    uint64_t logTagIdMask) const
+{
+    const bool oneShot = (m_usage & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT) == 0;
+
+    if ((oneShot == false) && ((logTagIdMask & (1ull << DescriptorPoolStats)) != 0))
+    {
+        DescriptorGpuMemHeapStats stats = {};
+
+        GetDynamicAllocStats(&stats);
+
+        // Logged as totalSize-freeSize-largestFreeBlock-freeBlockCount-fragmentation
+        AmdvlkLog(logTagIdMask,
+                  DescriptorPoolStats,
+                  "%llu-%llu-%llu-%u-%0.3f",
+                  static_cast<unsigned long long>(m_gpuMemOffsetRangeEnd - m_gpuMemOffsetRangeStart),
+                  static_cast<unsigned long long>(stats.freeSize),
+                  static_cast<unsigned long long>(stats.largestFreeBlock),
+                  stats.freeBlockCount,
+                  stats.fragmentation);
     }
 }
 
@@ -39,9 +39,59 @@
 #include "vk_conv.h"
 #include "vk_framebuffer.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 namespace vk
 {
 
+// =====================================================================================================================
+// Copies a contiguous run of descriptor data into descriptor set memory.  Descriptor pool memory is persistently mapped
+// and usually write-combined, so the whole cache lines covered by the run are written with non-temporal stores in
+// address order; the unaligned head and tail are written with regular stores.
+static void CopyToDescriptorMemory(
+    void*       pDestAddr,
+    const void* pSrcAddr,
+    size_t      sizeInBytes)
+{
+#if defined(__SSE2__) || defined(_M_X64)
+    constexpr size_t CacheLineSize = 64;
+
+    const size_t headSize = Util::Pow2Align(reinterpret_cast<size_t>(pDestAddr), CacheLineSize) -
+                            reinterpret_cast<size_t>(pDestAddr);
+
+    if (sizeInBytes >= (headSize + CacheLineSize))
+    {
+        memcpy(pDestAddr, pSrcAddr, headSize);
+
+        __m128i*       pDest = static_cast<__m128i*>(Util::VoidPtrInc(pDestAddr, headSize));
+        const __m128i* pSrc  = static_cast<const __m128i*>(Util::VoidPtrInc(pSrcAddr, headSize));
+
+        const size_t numLines = (sizeInBytes - headSize) / CacheLineSize;
+
+        for (size_t line = 0; line < numLines; ++line, pDest += 4, pSrc += 4)
+        {
+            _mm_stream_si128(pDest + 0, _mm_loadu_si128(pSrc + 0));
+            _mm_stream_si128(pDest + 1, _mm_loadu_si128(pSrc + 1));
+            _mm_stream_si128(pDest + 2, _mm_loadu_si128(pSrc + 2));
+            _mm_stream_si128(pDest + 3, _mm_loadu_si128(pSrc + 3));
+        }
+
+        // Order the streaming stores before any later write that may publish this memory to the GPU.
+        _mm_sfence();
+
+        const size_t copiedSize = headSize + (numLines * CacheLineSize);
+
+        memcpy(pDest, pSrc, sizeInBytes - copiedSize);
+    }
+    else
+#endif
+    {
+        memcpy(pDestAddr, pSrcAddr, sizeInBytes);
+    }
+}
+
 // =====================================================================================================================
 template <uint32_t numPalDevices>
 DescriptorSet<numPalDevices>::DescriptorSet(
@@ -104,18 +154,29 @@ void DescriptorSet<numPalDevices>::WriteImmutableSamplers(
                 const size_t srcArrayStrideInDW = bindingInfo.imm.dwArrayStride;
                 uint32_t numOfSamplers = bindingInfo.info.descriptorCount;
 
-                for (uint32_t descriptorIdx = 0; descriptorIdx < numOfSamplers; ++descriptorIdx)
+                if ((bindingInfo.info.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER) &&
+                    (bindingInfo.sta.dwArrayStride == srcArrayStrideInDW))
                 {
-                  size_t destOffset = Layout()->GetDstStaOffset(bindingInfo, descriptorIdx);
-                  uint32_t* pDestAddr = StaticCpuAddress(deviceIdx) + destOffset;
-                  if (bindingInfo.info.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
-                  {
-                    pDestAddr += (imageDescSizeInBytes / sizeof(uint32_t));
-                  }
+                    // The immutable sampler data has the same layout as the binding, so copy the array in one run.
+                    uint32_t* pDestAddr = StaticCpuAddress(deviceIdx) + Layout()->GetDstStaOffset(bindingInfo, 0);
 
-                  memcpy(pDestAddr, pSamplerDesc,(sizeof(uint32) * bindingInfo.imm.dwSize) / numOfSamplers);
+                    CopyToDescriptorMemory(pDestAddr, pSamplerDesc, sizeof(uint32_t) * bindingInfo.imm.dwSize);
+                }
+                else
+                {
+                    for (uint32_t descriptorIdx = 0; descriptorIdx < numOfSamplers; ++descriptorIdx)
+                    {
+                      size_t destOffset = Layout()->GetDstStaOffset(bindingInfo, descriptorIdx);
+                      uint32_t* pDestAddr = StaticCpuAddress(deviceIdx) + destOffset;
+                      if (bindingInfo.info.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+                      {
+                        pDestAddr += (imageDescSizeInBytes / sizeof(uint32_t));
+                      }
+
+                      memcpy(pDestAddr, pSamplerDesc,(sizeof(uint32) * bindingInfo.imm.dwSize) / numOfSamplers);
 
-                  pSamplerDesc += srcArrayStrideInDW;
+                      pSamplerDesc += srcArrayStrideInDW;
+                    }
                 }
             }
         }
@@ -442,7 +503,8 @@ void DescriptorUpdate::WriteBufferInfoDescriptors(
 }
 
 // =====================================================================================================================
-// Write data to the inline uniform block
+// Write data to the inline uniform block.  This is the only contiguous run written by descriptor updates; the other
+// descriptor types are written one SRD at a time, which is too short to benefit from streaming stores.
 void DescriptorUpdate::WriteInlineUniformBlock(
     const void*                     pData,
     uint32_t*                       pDestAddr,
@@ -450,7 +512,7 @@ void DescriptorUpdate::WriteInlineUniformBlock(
     uint32_t                        dwStride
 )
 {
-    memcpy(pDestAddr + dwStride, pData, count);
+    CopyToDescriptorMemory(pDestAddr + dwStride, pData, count);
 }
 
 // =====================================================================================================================
@@ -732,8 +794,8 @@ void DescriptorUpdate::CopyDescriptorSets(
             uint32_t* pDestAddr = pDestSet->StaticCpuAddress(deviceIdx) + destBinding.sta.dwOffset
                                 + (params.dstArrayElement / 4);
 
-            // Just do a straight memcpy covering the entire range.
-            memcpy(pDestAddr, pSrcAddr, count);
+            // Just do a straight copy covering the entire range.
+            CopyToDescriptorMemory(pDestAddr, pSrcAddr, count);
         }
         else
         {
@@ -762,8 +824,8 @@ void DescriptorUpdate::CopyDescriptorSets(
             }
             else
             {
-                // Just to a straight memcpy covering the entire range.
-                memcpy(pDestAddr, pSrcAddr, srcBinding.sta.dwArrayStride * sizeof(uint32_t) * count);
+                // Just do a straight copy covering the entire range.
+                CopyToDescriptorMemory(pDestAddr, pSrcAddr, srcBinding.sta.dwArrayStride * sizeof(uint32_t) * count);
             }
 
             if ((fmaskDescSize != 0) &&
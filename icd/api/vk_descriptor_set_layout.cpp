@@ -115,6 +115,74 @@ uint64_t DescriptorSetLayout::BuildApiHash(
     return hash;
 }
 
+// =====================================================================================================================
+// Builds the key of the descriptor set layout intern table into pKey, if not null, and returns its size in bytes.  The
+// key holds everything the layout is converted from: the create flags, the bindings with their binding flags, and the
+// descriptors of immutable samplers in place of their handles.
+size_t DescriptorSetLayout::BuildInternKey(
+    const Device*                          pDevice,
+    const VkDescriptorSetLayoutCreateInfo* pCreateInfo,
+    void*                                  pKey)
+{
+    const auto* pBindingFlagsInfo = utils::GetExtensionStructure<VkDescriptorSetLayoutBindingFlagsCreateInfo>(
+        pCreateInfo,
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO);
+
+    const size_t samplerDescSize = pDevice->GetProperties().descriptorSizes.sampler;
+
+    size_t keySize = 0;
+
+    const uint32_t header[] = { pCreateInfo->flags, pCreateInfo->bindingCount };
+
+    if (pKey != nullptr)
+    {
+        memcpy(pKey, header, sizeof(header));
+    }
+
+    keySize += sizeof(header);
+
+    for (uint32_t i = 0; i < pCreateInfo->bindingCount; ++i)
+    {
+        const VkDescriptorSetLayoutBinding& desc = pCreateInfo->pBindings[i];
+
+        const uint32_t bindingKey[] =
+        {
+            desc.binding,
+            desc.descriptorType,
+            desc.descriptorCount,
+            desc.stageFlags,
+            ((pBindingFlagsInfo != nullptr) && (i < pBindingFlagsInfo->bindingCount)) ?
+                pBindingFlagsInfo->pBindingFlags[i] : 0
+        };
+
+        if (pKey != nullptr)
+        {
+            memcpy(Util::VoidPtrInc(pKey, keySize), bindingKey, sizeof(bindingKey));
+        }
+
+        keySize += sizeof(bindingKey);
+
+        if ((desc.pImmutableSamplers != nullptr) &&
+            ((desc.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER) ||
+             (desc.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)))
+        {
+            for (uint32_t j = 0; j < desc.descriptorCount; ++j)
+            {
+                if (pKey != nullptr)
+                {
+                    memcpy(Util::VoidPtrInc(pKey, keySize),
+                           Sampler::ObjectFromHandle(desc.pImmutableSamplers[j])->Descriptor(),
+                           samplerDescSize);
+                }
+
+                keySize += samplerDescSize;
+            }
+        }
+    }
+
+    return keySize;
+}
+
 // =====================================================================================================================
 DescriptorSetLayout::DescriptorSetLayout(
     const Device*     pDevice,
@@ -122,7 +190,9 @@ DescriptorSetLayout::DescriptorSetLayout(
     uint64_t          apiHash) :
     m_info(info),
     m_pDevice(pDevice),
-    m_apiHash(apiHash)
+    m_apiHash(apiHash),
+    m_pInternKey(nullptr),
+    m_internKeySize(0)
 {
 
 }
@@ -633,6 +703,42 @@ VkResult DescriptorSetLayout::Create(
         bindingCount = Util::Max(bindingCount, desc.binding + 1);
     }
 
+    // Identical layouts share one immutable object through the device's intern table.  Layouts with YCbCr immutable
+    // samplers are not interned as their conversion metadata is taken from the samplers' current state.  Interned
+    // objects outlive the handle they are created for, so only layouts allocated from the device's own allocator
+    // (i.e. created without application allocation callbacks) are shared.
+    const bool intern = pDevice->UseLayoutInterning()                             &&
+                        (pAllocator == pDevice->VkInstance()->GetAllocCallbacks()) &&
+                        (immYCbCrMetaDataCount == 0);
+
+    size_t keySize = 0;
+    void*  pKey    = nullptr;
+
+    if (intern)
+    {
+        keySize = BuildInternKey(pDevice, pCreateInfo, nullptr);
+        pKey    = pDevice->VkInstance()->AllocMem(keySize, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+
+        if (pKey == nullptr)
+        {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        BuildInternKey(pDevice, pCreateInfo, pKey);
+
+        void* pInterned = pDevice->AcquireInternedLayout(
+            Device::InternedLayoutType::DescriptorSet, apiHash, pKey, keySize);
+
+        if (pInterned != nullptr)
+        {
+            pDevice->VkInstance()->FreeMem(pKey);
+
+            *pLayout = DescriptorSetLayout::HandleFromVoidPointer(pInterned);
+
+            return VK_SUCCESS;
+        }
+    }
+
     const size_t bindingInfoAuxSize     = bindingCount          * sizeof(BindingInfo);
     const size_t immSamplerAuxSize      = immSamplerCount       * pDevice->GetProperties().descriptorSizes.sampler;
     const size_t immYCbCrMetaDataSize   = immYCbCrMetaDataCount * sizeof(Vkgc::SamplerYCbCrConversionMetaData);
@@ -641,10 +747,13 @@ VkResult DescriptorSetLayout::Create(
     const size_t auxSize = bindingInfoAuxSize + immSamplerAuxSize + immYCbCrMetaDataSize;
     const size_t objSize = apiSize + auxSize;
 
-    void* pSysMem = pDevice->AllocApiObject(pAllocator, objSize);
+    // The intern key is stored after the layout data.
+    void* pSysMem = pDevice->AllocApiObject(pAllocator, objSize + keySize);
 
     if (pSysMem == nullptr)
     {
+        pDevice->VkInstance()->FreeMem(pKey);
+
         return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
 
@@ -674,13 +783,48 @@ VkResult DescriptorSetLayout::Create(
     if (result != VK_SUCCESS)
     {
         pDevice->FreeApiObject(pAllocator, pSysMem);
+        pDevice->VkInstance()->FreeMem(pKey);
 
         return result;
     }
 
-    VK_PLACEMENT_NEW (pSysMem) DescriptorSetLayout (pDevice, info, apiHash);
+    DescriptorSetLayout* pObject = VK_PLACEMENT_NEW (pSysMem) DescriptorSetLayout (pDevice, info, apiHash);
+
+    if (intern)
+    {
+        void* pInterned = pSysMem;
+
+        pObject->m_pInternKey    = Util::VoidPtrInc(pSysMem, objSize);
+        pObject->m_internKeySize = keySize;
 
-    *pLayout = DescriptorSetLayout::HandleFromVoidPointer(pSysMem);
+        memcpy(Util::VoidPtrInc(pSysMem, objSize), pKey, keySize);
+
+        pDevice->VkInstance()->FreeMem(pKey);
+
+        result = pDevice->InternLayout(
+            Device::InternedLayoutType::DescriptorSet, apiHash, pObject->m_pInternKey, keySize, &pInterned);
+
+        if ((result == VK_SUCCESS) && (pInterned == nullptr))
+        {
+            // A different layout with the same hash is interned, so this one stays private to its handle.
+            pObject->m_pInternKey    = nullptr;
+            pObject->m_internKeySize = 0;
+        }
+        else if (pInterned != pSysMem)
+        {
+            // Drop this object if an identical layout was interned concurrently or the intern table is out of memory.
+            pObject->~DescriptorSetLayout();
+
+            pDevice->FreeApiObject(pAllocator, pSysMem);
+
+            pSysMem = pInterned;
+        }
+    }
+
+    if (result == VK_SUCCESS)
+    {
+        *pLayout = DescriptorSetLayout::HandleFromVoidPointer(pSysMem);
+    }
 
     return result;
 }
@@ -997,11 +1141,16 @@ VkResult DescriptorSetLayout::Destroy(
     const VkAllocationCallbacks*    pAllocator,
     bool                            freeMemory)
 {
-    this->~DescriptorSetLayout();
-
-    if (freeMemory)
+    // An interned layout is shared by all of its API handles and is only destroyed together with the last of them.
+    if ((m_pInternKey == nullptr) ||
+        pDevice->ReleaseInternedLayout(Device::InternedLayoutType::DescriptorSet, m_apiHash, this))
     {
-        pDevice->FreeApiObject(pAllocator, this);
+        this->~DescriptorSetLayout();
+
+        if (freeMemory)
+        {
+            pDevice->FreeApiObject(pAllocator, this);
+        }
     }
 
     return VK_SUCCESS;
@@ -60,7 +60,9 @@ VkResult DescriptorUpdateTemplate::Create(
 
     if (result == VK_SUCCESS)
     {
-        TemplateUpdateInfo* pEntries = static_cast<TemplateUpdateInfo*>(Util::VoidPtrInc(pSysMem, apiSize));
+        TemplateUpdateInfo* pEntries       = static_cast<TemplateUpdateInfo*>(Util::VoidPtrInc(pSysMem, apiSize));
+        uint32_t            numMerged      = 0;
+        VkDescriptorType    prevDescType   = VK_DESCRIPTOR_TYPE_MAX_ENUM;
 
         for (uint32_t ii = 0; ii < numEntries; ii++)
         {
@@ -85,25 +87,42 @@ VkResult DescriptorUpdateTemplate::Create(
                 dstArrayElement = srcEntry.dstArrayElement;
             }
 
-            pEntries[ii].descriptorCount                = srcEntry.descriptorCount;
-            pEntries[ii].srcOffset                      = srcEntry.offset;
-            pEntries[ii].srcStride                      = srcEntry.stride;
-            pEntries[ii].dstBindStaDwArrayStride        = dstBinding.sta.dwArrayStride;
-            pEntries[ii].dstBindDynDataDwArrayStride    = dstBinding.dyn.dwArrayStride;
+            TemplateUpdateInfo entry = {};
 
-            pEntries[ii].dstStaOffset                   =
+            entry.descriptorCount                = srcEntry.descriptorCount;
+            entry.srcOffset                      = srcEntry.offset;
+            entry.srcStride                      = srcEntry.stride;
+            entry.dstBindStaDwArrayStride        = dstBinding.sta.dwArrayStride;
+            entry.dstBindDynDataDwArrayStride    = dstBinding.dyn.dwArrayStride;
+
+            entry.dstStaOffset                   =
                 pLayout->GetDstStaOffset(dstBinding, dstArrayElement);
 
-            pEntries[ii].dstDynOffset                   =
+            entry.dstDynOffset                   =
                 pLayout->GetDstDynOffset(dstBinding, dstArrayElement);
 
-            pEntries[ii].pFunc                          =
+            entry.pFunc                          =
                 GetUpdateEntryFunc(pDevice, srcEntry.descriptorType, dstBinding);
+
+            // Fold the entry into the previous one when it continues the same kind of write in both the source data
+            // and the destination set, so that one loop of the descriptor writer covers both.
+            if ((numMerged > 0) &&
+                CanMergeEntries(pEntries[numMerged - 1], prevDescType, entry, srcEntry.descriptorType))
+            {
+                pEntries[numMerged - 1].descriptorCount += entry.descriptorCount;
+            }
+            else
+            {
+                pEntries[numMerged++] = entry;
+            }
+
+            prevDescType = srcEntry.descriptorType;
         }
 
         VK_PLACEMENT_NEW(pSysMem) DescriptorUpdateTemplate(
             pCreateInfo->pipelineBindPoint,
-            pCreateInfo->descriptorUpdateEntryCount);
+            numMerged,
+            GetUpdateSetFunc(pDevice));
 
         *pDescriptorUpdateTemplate = DescriptorUpdateTemplate::HandleFromVoidPointer(pSysMem);
     }
@@ -273,13 +292,89 @@ DescriptorUpdateTemplate::PfnUpdateEntry DescriptorUpdateTemplate::GetUpdateEntr
     return pFunc;
 }
 
+// =====================================================================================================================
+// Returns true if an entry directly continues the previous one: the same update function with the same strides, and
+// both its source data and its destination descriptors start right where those of the previous entry end.
+bool DescriptorUpdateTemplate::CanMergeEntries(
+    const TemplateUpdateInfo&   prevEntry,
+    VkDescriptorType            prevDescriptorType,
+    const TemplateUpdateInfo&   entry,
+    VkDescriptorType            descriptorType)
+{
+    bool canMerge = (prevDescriptorType == descriptorType) &&
+                    (descriptorType != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) &&
+                    (prevEntry.pFunc == entry.pFunc) &&
+                    (prevEntry.srcStride == entry.srcStride) &&
+                    ((prevEntry.srcOffset + (prevEntry.descriptorCount * prevEntry.srcStride)) == entry.srcOffset);
+
+    if (canMerge)
+    {
+        if ((descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) ||
+            (descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC))
+        {
+            const size_t prevDynEnd = prevEntry.dstDynOffset +
+                                      (prevEntry.descriptorCount * prevEntry.dstBindDynDataDwArrayStride);
+
+            canMerge = (prevEntry.dstBindDynDataDwArrayStride == entry.dstBindDynDataDwArrayStride) &&
+                       (prevDynEnd == entry.dstDynOffset);
+        }
+        else
+        {
+            const size_t prevStaEnd = prevEntry.dstStaOffset +
+                                      (prevEntry.descriptorCount * prevEntry.dstBindStaDwArrayStride);
+
+            canMerge = (prevEntry.dstBindStaDwArrayStride == entry.dstBindStaDwArrayStride) &&
+                       (prevStaEnd == entry.dstStaOffset);
+        }
+    }
+
+    return canMerge;
+}
+
+// =====================================================================================================================
+DescriptorUpdateTemplate::PfnUpdateSet DescriptorUpdateTemplate::GetUpdateSetFunc(
+    const Device*                           pDevice)
+{
+    DescriptorUpdateTemplate::PfnUpdateSet pFunc = nullptr;
+
+    switch (pDevice->NumPalDevices())
+    {
+        case 1:
+            pFunc = &UpdateSet<1>;
+            break;
+#if (VKI_BUILD_MAX_NUM_GPUS > 1)
+        case 2:
+            pFunc = &UpdateSet<2>;
+            break;
+#endif
+#if (VKI_BUILD_MAX_NUM_GPUS > 2)
+        case 3:
+            pFunc = &UpdateSet<3>;
+            break;
+#endif
+#if (VKI_BUILD_MAX_NUM_GPUS > 3)
+        case 4:
+            pFunc = &UpdateSet<4>;
+            break;
+#endif
+        default:
+            VK_NEVER_CALLED();
+            pFunc = nullptr;
+            break;
+    }
+
+    return pFunc;
+}
+
 // =====================================================================================================================
 DescriptorUpdateTemplate::DescriptorUpdateTemplate(
     VkPipelineBindPoint         pipelineBindPoint,
-    uint32_t                    numEntries)
+    uint32_t                    numEntries,
+    PfnUpdateSet                pfnUpdateSet)
     :
     m_pipelineBindPoint(pipelineBindPoint),
-    m_numEntries(numEntries)
+    m_numEntries(numEntries),
+    m_pfnUpdateSet(pfnUpdateSet)
 {
 }
 
@@ -306,13 +401,35 @@ void DescriptorUpdateTemplate::Update(
     VkDescriptorSet descriptorSet,
     const void*     pData)
 {
-    auto pEntries = GetEntries();
+    m_pfnUpdateSet(this, pDevice, descriptorSet, pData);
+}
+
+// =====================================================================================================================
+template <uint32_t numPalDevices>
+void DescriptorUpdateTemplate::UpdateSet(
+    const DescriptorUpdateTemplate* pTemplate,
+    const Device*                   pDevice,
+    VkDescriptorSet                 descriptorSet,
+    const void*                     pData)
+{
+    DescriptorSet<numPalDevices>* pDstSet = DescriptorSet<numPalDevices>::ObjectFromHandle(descriptorSet);
+
+    UpdateDestination dest;
+
+    for (uint32_t deviceIdx = 0; deviceIdx < numPalDevices; deviceIdx++)
+    {
+        dest.pStaticCpuAddr[deviceIdx] = pDstSet->StaticCpuAddress(deviceIdx);
+        dest.pFmaskCpuAddr[deviceIdx]  = pDstSet->FmaskCpuAddress(deviceIdx);
+        dest.pDynamicData[deviceIdx]   = pDstSet->DynamicDescriptorData(deviceIdx);
+    }
+
+    auto pEntries = pTemplate->GetEntries();
 
-    for (uint32_t i = 0; i < m_numEntries; ++i)
+    for (uint32_t i = 0; i < pTemplate->m_numEntries; ++i)
     {
         const void* pDescriptorInfo = Util::VoidPtrInc(pData, pEntries[i].srcOffset);
 
-        pEntries[i].pFunc(pDevice, descriptorSet, pDescriptorInfo, pEntries[i]);
+        pEntries[i].pFunc(pDevice, dest, pDescriptorInfo, pEntries[i]);
     }
 }
 
@@ -321,19 +438,17 @@ template <size_t imageDescSize, size_t fmaskDescSize, size_t samplerDescSize, bo
     bool ycbcrUsage, uint32_t numPalDevices>
 void DescriptorUpdateTemplate::UpdateEntryCombinedImageSampler(
     const Device*               pDevice,
-    VkDescriptorSet             descriptorSet,
+    const UpdateDestination&    dest,
     const void*                 pDescriptorInfo,
     const TemplateUpdateInfo&   entry)
 {
-    DescriptorSet<numPalDevices>* pDstSet = DescriptorSet<numPalDevices>::ObjectFromHandle(descriptorSet);
-
     const VkDescriptorImageInfo* pImageInfo = static_cast<const VkDescriptorImageInfo*>(pDescriptorInfo);
 
     uint32_t deviceIdx = 0;
 
     do
     {
-        uint32_t* pDestAddr = pDstSet->StaticCpuAddress(deviceIdx) + entry.dstStaOffset;
+        uint32_t* pDestAddr = dest.pStaticCpuAddr[deviceIdx] + entry.dstStaOffset;
 
         if (immutable)
         {
@@ -373,7 +488,7 @@ void DescriptorUpdateTemplate::UpdateEntryCombinedImageSampler(
 
         if (fmaskDescSize != 0)
         {
-            uint32_t* pDestFmaskAddr = pDstSet->FmaskCpuAddress(deviceIdx) + entry.dstStaOffset;
+            uint32_t* pDestFmaskAddr = dest.pFmaskCpuAddr[deviceIdx] + entry.dstStaOffset;
 
             DescriptorUpdate::WriteFmaskDescriptors<imageDescSize, fmaskDescSize>(
                 pImageInfo,
@@ -393,19 +508,17 @@ void DescriptorUpdateTemplate::UpdateEntryCombinedImageSampler(
 template <size_t bufferDescSize, VkDescriptorType descriptorType, uint32_t numPalDevices>
 void DescriptorUpdateTemplate::UpdateEntryTexelBuffer(
     const Device*               pDevice,
-    VkDescriptorSet             descriptorSet,
+    const UpdateDestination&    dest,
     const void*                 pDescriptorInfo,
     const TemplateUpdateInfo&   entry)
 {
-    DescriptorSet<numPalDevices>* pDstSet = DescriptorSet<numPalDevices>::ObjectFromHandle(descriptorSet);
-
     const VkBufferView* pTexelBufferView = static_cast<const VkBufferView*>(pDescriptorInfo);
 
     uint32_t deviceIdx = 0;
 
     do
     {
-        uint32_t* pDestAddr = pDstSet->StaticCpuAddress(deviceIdx) + entry.dstStaOffset;
+        uint32_t* pDestAddr = dest.pStaticCpuAddr[deviceIdx] + entry.dstStaOffset;
 
         DescriptorUpdate::WriteBufferDescriptors<bufferDescSize, descriptorType>(
                 pTexelBufferView,
@@ -424,12 +537,10 @@ void DescriptorUpdateTemplate::UpdateEntryTexelBuffer(
 template <size_t bufferDescSize, VkDescriptorType descriptorType, uint32_t numPalDevices>
 void DescriptorUpdateTemplate::UpdateEntryBuffer(
     const Device*               pDevice,
-    VkDescriptorSet             descriptorSet,
+    const UpdateDestination&    dest,
     const void*                 pDescriptorInfo,
     const TemplateUpdateInfo&   entry)
 {
-    DescriptorSet<numPalDevices>* pDstSet = DescriptorSet<numPalDevices>::ObjectFromHandle(descriptorSet);
-
     const VkDescriptorBufferInfo* pBufferInfo = static_cast<const VkDescriptorBufferInfo*>(pDescriptorInfo);
 
     uint32_t deviceIdx = 0;
@@ -443,12 +554,12 @@ void DescriptorUpdateTemplate::UpdateEntryBuffer(
             (descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC))
         {
             // Dynamic buffer descriptors reside in client memory to be read when the descriptor set is bound.
-            pDestAddr   = pDstSet->DynamicDescriptorData(deviceIdx) + entry.dstDynOffset;
+            pDestAddr   = dest.pDynamicData[deviceIdx] + entry.dstDynOffset;
             stride      = entry.dstBindDynDataDwArrayStride;
         }
         else
         {
-            pDestAddr   = pDstSet->StaticCpuAddress(deviceIdx) + entry.dstStaOffset;
+            pDestAddr   = dest.pStaticCpuAddr[deviceIdx] + entry.dstStaOffset;
             stride      = entry.dstBindStaDwArrayStride;
         }
 
@@ -470,19 +581,17 @@ void DescriptorUpdateTemplate::UpdateEntryBuffer(
 template <size_t samplerDescSize, uint32_t numPalDevices>
 void DescriptorUpdateTemplate::UpdateEntrySampler(
     const Device*               pDevice,
-    VkDescriptorSet             descriptorSet,
+    const UpdateDestination&    dest,
     const void*                 pDescriptorInfo,
     const TemplateUpdateInfo&   entry)
 {
-    DescriptorSet<numPalDevices>* pDstSet = DescriptorSet<numPalDevices>::ObjectFromHandle(descriptorSet);
-
     const VkDescriptorImageInfo* pImageInfo = static_cast<const VkDescriptorImageInfo*>(pDescriptorInfo);
 
     uint32_t deviceIdx = 0;
 
     do
     {
-        uint32_t* pDestAddr = pDstSet->StaticCpuAddress(deviceIdx) + entry.dstStaOffset;
+        uint32_t* pDestAddr = dest.pStaticCpuAddr[deviceIdx] + entry.dstStaOffset;
 
         DescriptorUpdate::WriteSamplerDescriptors<samplerDescSize>(
             pImageInfo,
@@ -500,19 +609,17 @@ void DescriptorUpdateTemplate::UpdateEntrySampler(
 template <size_t imageDescSize, size_t fmaskDescSize, bool isShaderStorageDesc, uint32_t numPalDevices>
 void DescriptorUpdateTemplate::UpdateEntrySampledImage(
     const Device*               pDevice,
-    VkDescriptorSet             descriptorSet,
+    const UpdateDestination&    dest,
     const void*                 pDescriptorInfo,
     const TemplateUpdateInfo&   entry)
 {
-    DescriptorSet<numPalDevices>* pDstSet = DescriptorSet<numPalDevices>::ObjectFromHandle(descriptorSet);
-
     const VkDescriptorImageInfo* pImageInfo = static_cast<const VkDescriptorImageInfo*>(pDescriptorInfo);
 
     uint32_t deviceIdx = 0;
 
     do
     {
-        uint32_t* pDestAddr = pDstSet->StaticCpuAddress(deviceIdx) + entry.dstStaOffset;
+        uint32_t* pDestAddr = dest.pStaticCpuAddr[deviceIdx] + entry.dstStaOffset;
 
         DescriptorUpdate::WriteImageDescriptors<imageDescSize, isShaderStorageDesc>(
                 pImageInfo,
@@ -524,7 +631,7 @@ void DescriptorUpdateTemplate::UpdateEntrySampledImage(
 
          if (fmaskDescSize != 0)
          {
-             uint32_t* pDestFmaskAddr = pDstSet->FmaskCpuAddress(deviceIdx) + entry.dstStaOffset;
+             uint32_t* pDestFmaskAddr = dest.pFmaskCpuAddr[deviceIdx] + entry.dstStaOffset;
 
              DescriptorUpdate::WriteFmaskDescriptors<imageDescSize, fmaskDescSize>(
                  pImageInfo,
@@ -544,19 +651,17 @@ void DescriptorUpdateTemplate::UpdateEntrySampledImage(
 template <uint32_t numPalDevices>
 void DescriptorUpdateTemplate::UpdateEntryInlineUniformBlock(
     const Device*               pDevice,
-    VkDescriptorSet             descriptorSet,
+    const UpdateDestination&    dest,
     const void*                 pDescriptorInfo,
     const TemplateUpdateInfo&   entry)
 {
-    DescriptorSet<numPalDevices>* pDstSet = DescriptorSet<numPalDevices>::ObjectFromHandle(descriptorSet);
-
     const uint8_t* pData = static_cast<const uint8_t*>(pDescriptorInfo);
 
     uint32_t deviceIdx = 0;
 
     do
     {
-        uint32_t* pDestAddr = pDstSet->StaticCpuAddress(deviceIdx) + entry.dstStaOffset;
+        uint32_t* pDestAddr = dest.pStaticCpuAddr[deviceIdx] + entry.dstStaOffset;
 
         DescriptorUpdate::WriteInlineUniformBlock(
             pData,
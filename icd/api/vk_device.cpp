@@ -96,6 +96,7 @@
 #include "palQueue.h"
 #include "palQueueSemaphore.h"
 #include "palAutoBuffer.h"
+#include "palSysUtil.h"
 #include "palBorderColorPalette.h"
 
 #include <cmath>
@@ -274,7 +275,10 @@ Device::Device(
     m_useComputeAsTransferQueue(useComputeAsTransferQueue),
     m_useUniversalAsComputeQueue(pPhysicalDevices[DefaultDeviceIndex]->GetRuntimeSettings().useUniversalAsComputeQueue),
     m_useGlobalGpuVa(false),
-    m_pBorderColorUsedIndexes(nullptr)
+    m_pBorderColorUsedIndexes(nullptr),
+    m_useLayoutInterning(false),
+    m_internedSetLayouts(InternedLayoutBuckets, m_pInstance->Allocator()),
+    m_internedPipelineLayouts(InternedLayoutBuckets, m_pInstance->Allocator())
 {
     memset(m_pBltMsaaState, 0, sizeof(m_pBltMsaaState));
 
@@ -307,6 +311,9 @@ Device::Device(
     m_nextPrivateDataSlot = 0;
     m_privateDataSize = privateDataSize;
     m_privateDataSlotRequestCount = privateDataSlotRequestCount;
+
+    // Interned layouts hand out the same handle for identical create infos, which private data could tell apart.
+    m_useLayoutInterning = m_settings.enableLayoutInterning && (privateDataSize == 0);
 }
 
 // =====================================================================================================================
@@ -1264,6 +1271,17 @@ VkResult Device::Initialize(
         result = m_renderStateCache.Init();
     }
 
+    // Initialize the layout intern tables
+    if (result == VK_SUCCESS)
+    {
+        result = PalToVkResult(m_internedSetLayouts.Init());
+    }
+
+    if (result == VK_SUCCESS)
+    {
+        result = PalToVkResult(m_internedPipelineLayouts.Init());
+    }
+
     memcpy(&m_pQueues, pQueues, sizeof(m_pQueues));
     Pal::DeviceProperties deviceProps = {};
     result = PalToVkResult(PalDevice(DefaultDeviceIndex)->GetProperties(&deviceProps));
@@ -1554,6 +1572,41 @@ void Device::InitDispatchTable()
     ep->vkFreeDescriptorSets        = DescriptorPool::GetFreeDescriptorSetsFunc(this);
     ep->vkResetDescriptorPool       = DescriptorPool::GetResetDescriptorPoolFunc(this);
     ep->vkAllocateDescriptorSets    = DescriptorPool::GetAllocateDescriptorSetsFunc(this);
+    ep->vkCmdBindVertexBuffers      = CmdBuffer::GetCmdBindVertexBuffersFunc(this);
+    ep->vkCmdSetViewport            = CmdBuffer::GetCmdSetViewportFunc(this);
+    ep->vkCmdSetScissor             = CmdBuffer::GetCmdSetScissorFunc(this);
+
+    // The entry points below are only exposed with Vulkan 1.3 or their extensions, so only override the ones that
+    // were populated.
+    if (ep->vkCmdBindVertexBuffers2 != nullptr)
+    {
+        ep->vkCmdBindVertexBuffers2 = CmdBuffer::GetCmdBindVertexBuffers2Func(this);
+    }
+
+    if (ep->vkCmdBindVertexBuffers2EXT != nullptr)
+    {
+        ep->vkCmdBindVertexBuffers2EXT = CmdBuffer::GetCmdBindVertexBuffers2Func(this);
+    }
+
+    if (ep->vkCmdSetViewportWithCount != nullptr)
+    {
+        ep->vkCmdSetViewportWithCount = CmdBuffer::GetCmdSetViewportWithCountFunc(this);
+    }
+
+    if (ep->vkCmdSetViewportWithCountEXT != nullptr)
+    {
+        ep->vkCmdSetViewportWithCountEXT = CmdBuffer::GetCmdSetViewportWithCountFunc(this);
+    }
+
+    if (ep->vkCmdSetScissorWithCount != nullptr)
+    {
+        ep->vkCmdSetScissorWithCount = CmdBuffer::GetCmdSetScissorWithCountFunc(this);
+    }
+
+    if (ep->vkCmdSetScissorWithCountEXT != nullptr)
+    {
+        ep->vkCmdSetScissorWithCountEXT = CmdBuffer::GetCmdSetScissorWithCountFunc(this);
+    }
 
     if (m_enabledExtensions.IsExtensionEnabled(DeviceExtensions::KHR_PUSH_DESCRIPTOR))
     {
@@ -1838,6 +1891,12 @@ VkResult Device::Destroy(const VkAllocationCallbacks* pAllocator)
 
     DestroyInternalPipelines();
 
+    // Don't leave binaries of this device's pipelines queued for the on-disk pipeline cache.
+    for (uint32_t deviceIdx = 0; deviceIdx < NumPalDevices(); deviceIdx++)
+    {
+        GetCompiler(deviceIdx)->FlushPipelineBinaryCache();
+    }
+
     DestroySharedPalCmdAllocator();
 
     for (uint32_t deviceIdx = 0; deviceIdx < NumPalDevices(); deviceIdx++)
@@ -1867,6 +1926,23 @@ VkResult Device::Destroy(const VkAllocationCallbacks* pAllocator)
 
     m_renderStateCache.Destroy();
 
+    // Destroy the interned layouts whose handles were not destroyed by the application.  Dropping the entry's
+    // reference count to one makes Destroy() release the last reference, which also removes the entry.
+    for (auto it = m_internedPipelineLayouts.Begin(); it.Get() != nullptr; it = m_internedPipelineLayouts.Begin())
+    {
+        it.Get()->value.refCount = 1;
+
+        static_cast<PipelineLayout*>(it.Get()->value.pObject)->Destroy(this, VkInstance()->GetAllocCallbacks());
+    }
+
+    for (auto it = m_internedSetLayouts.Begin(); it.Get() != nullptr; it = m_internedSetLayouts.Begin())
+    {
+        it.Get()->value.refCount = 1;
+
+        static_cast<DescriptorSetLayout*>(it.Get()->value.pObject)->Destroy(
+            this, VkInstance()->GetAllocCallbacks(), true);
+    }
+
     Util::Destructor(this);
 
     FreeApiObject(VkInstance()->GetAllocCallbacks(), ApiDevice::FromObject(this));
@@ -2518,6 +2594,232 @@ VkResult Device::CreateImageView(
     return ImageView::Create(this, pCreateInfo, pAllocator, pView);
 }
 
+// =====================================================================================================================
+// State shared by the calling thread and the helper threads of a vkCreate*Pipelines batch that is created in parallel.
+struct PipelineBatchState
+{
+    Device*                      pDevice;
+    PipelineCache*               pPipelineCache;
+    const void*                  pCreateInfos;
+    const VkAllocationCallbacks* pAllocator;
+    VkPipeline*                  pPipelines;
+    VkResult*                    pResults;           // Per-index creation result
+    uint32_t                     count;
+    volatile uint32_t            nextIndex;          // Next create info to be claimed by any thread
+    volatile uint32_t            earlyReturnIndex;   // Lowest index that failed with
+                                                     // VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT, or count
+    void                         (*CreatePipeline)(PipelineBatchState* pState, uint32_t index);
+};
+
+// =====================================================================================================================
+static VkResult CreateBatchPipeline(
+    Device*                             pDevice,
+    PipelineCache*                      pPipelineCache,
+    const VkGraphicsPipelineCreateInfo* pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+    VkPipeline*                         pPipeline)
+{
+    return GraphicsPipelineCommon::Create(pDevice, pPipelineCache, pCreateInfo, pAllocator, pPipeline);
+}
+
+// =====================================================================================================================
+static VkResult CreateBatchPipeline(
+    Device*                            pDevice,
+    PipelineCache*                     pPipelineCache,
+    const VkComputePipelineCreateInfo* pCreateInfo,
+    const VkAllocationCallbacks*       pAllocator,
+    VkPipeline*                        pPipeline)
+{
+    return ComputePipeline::Create(pDevice, pPipelineCache, pCreateInfo, pAllocator, pPipeline);
+}
+
+// =====================================================================================================================
+// Creates the pipeline at the given index of a batch and publishes the lowest index that requests an early return on
+// failure, so that no thread starts work which the sequential path would never have attempted.
+template<typename PipelineCreateInfo>
+static void CreatePipelineInBatch(
+    PipelineBatchState* pState,
+    uint32_t            index)
+{
+    const PipelineCreateInfo* pCreateInfo = static_cast<const PipelineCreateInfo*>(pState->pCreateInfos) + index;
+
+    VkResult result = CreateBatchPipeline(pState->pDevice,
+                                          pState->pPipelineCache,
+                                          pCreateInfo,
+                                          pState->pAllocator,
+                                          &pState->pPipelines[index]);
+
+    pState->pResults[index] = result;
+
+    if ((result != VK_SUCCESS) && ((pCreateInfo->flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT) != 0))
+    {
+        uint32_t earlyReturnIndex = pState->earlyReturnIndex;
+
+        while ((index < earlyReturnIndex) &&
+               (Util::AtomicCompareAndSwap(&pState->earlyReturnIndex, earlyReturnIndex, index) != earlyReturnIndex))
+        {
+            earlyReturnIndex = pState->earlyReturnIndex;
+        }
+    }
+}
+
+// =====================================================================================================================
+// Claims and creates pipelines of the batch until every index has been claimed or an early return has been requested
+// by a lower index.  Runs on the calling thread as well as on the batch helper threads.
+static void ExecutePipelineBatch(
+    void* pPayload)
+{
+    PipelineBatchState* pState = static_cast<PipelineBatchState*>(pPayload);
+
+    uint32_t index = Util::AtomicIncrement(&pState->nextIndex) - 1;
+
+    while ((index < pState->count) && (index < pState->earlyReturnIndex))
+    {
+        pState->CreatePipeline(pState, index);
+
+        index = Util::AtomicIncrement(&pState->nextIndex) - 1;
+    }
+}
+
+// =====================================================================================================================
+// Returns true if the pipelines of a vkCreate*Pipelines call should be created in parallel.  The Vulkan spec only allows
+// allocation callbacks to be called from the thread of the provoking command, so any batch that may reach application
+// callbacks stays on the calling thread.
+bool Device::UseParallelPipelineBatch(
+    uint32_t                     count,
+    const VkAllocationCallbacks* pAllocator
+    ) const
+{
+    return (count > 1) &&
+           (pAllocator == nullptr) &&
+           (m_pInstance->GetAllocCallbacks()->pfnAllocation == allocator::g_DefaultAllocCallback.pfnAllocation) &&
+           (GetCompiler(DefaultDeviceIndex)->GetPipelineBatchThreadCount() > 0);
+}
+
+// =====================================================================================================================
+// Creates the pipelines of a vkCreate*Pipelines call on the calling thread and the pipeline batch helper threads.  The
+// per-index results match the sequential path: pipelines are claimed in index order, the returned error is the one of
+// the lowest failing index and, if a pipeline with VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT fails, every
+// pipeline at a higher index is left as (or reset to) VK_NULL_HANDLE.
+template<typename PipelineCreateInfo>
+VkResult Device::CreatePipelineBatchParallel(
+    PipelineCache*               pPipelineCache,
+    uint32_t                     count,
+    const PipelineCreateInfo*    pCreateInfos,
+    const VkAllocationCallbacks* pAllocator,
+    VkPipeline*                  pPipelines)
+{
+    PipelineCompiler* pCompiler   = GetCompiler(DefaultDeviceIndex);
+    const uint32_t    helperCount = Util::Min(pCompiler->GetPipelineBatchThreadCount(), count - 1);
+
+    const size_t stateSize    = Util::Pow2Align(sizeof(PipelineBatchState), VK_DEFAULT_MEM_ALIGN);
+    const size_t resultsSize  = Util::Pow2Align(sizeof(VkResult) * count, VK_DEFAULT_MEM_ALIGN);
+    const size_t workloadSize = Util::Pow2Align(sizeof(DeferredCompileWorkload) * helperCount, VK_DEFAULT_MEM_ALIGN);
+    const size_t eventSize    = sizeof(Util::Event) * helperCount;
+
+    void* pMemory = m_pInstance->AllocMem(stateSize + resultsSize + workloadSize + eventSize,
+                                          VK_DEFAULT_MEM_ALIGN,
+                                          VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+
+    if (pMemory == nullptr)
+    {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    const uint64_t startTimeTicks = Util::GetPerfCpuTime();
+
+    PipelineBatchState*      pState     = static_cast<PipelineBatchState*>(pMemory);
+    VkResult*                pResults   = static_cast<VkResult*>(Util::VoidPtrInc(pMemory, stateSize));
+    DeferredCompileWorkload* pWorkloads = static_cast<DeferredCompileWorkload*>(
+        Util::VoidPtrInc(pMemory, stateSize + resultsSize));
+    Util::Event*             pEvents    = static_cast<Util::Event*>(
+        Util::VoidPtrInc(pMemory, stateSize + resultsSize + workloadSize));
+
+    pState->pDevice          = this;
+    pState->pPipelineCache   = pPipelineCache;
+    pState->pCreateInfos     = pCreateInfos;
+    pState->pAllocator       = pAllocator;
+    pState->pPipelines       = pPipelines;
+    pState->pResults         = pResults;
+    pState->count            = count;
+    pState->nextIndex        = 0;
+    pState->earlyReturnIndex = count;
+    pState->CreatePipeline   = CreatePipelineInBatch<PipelineCreateInfo>;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        pResults[i] = VK_SUCCESS;
+    }
+
+    Util::EventCreateFlags flags = {};
+    flags.manualReset = true;
+
+    for (uint32_t i = 0; i < helperCount; ++i)
+    {
+        VK_PLACEMENT_NEW(&pEvents[i]) Util::Event();
+        pEvents[i].Init(flags);
+
+        pWorkloads[i].pPayloads = pState;
+        pWorkloads[i].Execute   = ExecutePipelineBatch;
+        pWorkloads[i].pEvent    = &pEvents[i];
+        pWorkloads[i].queueIdx  = DeferCompileThread::InvalidQueueIdx;
+
+        pCompiler->ExecutePipelineBatchWorkload(&pWorkloads[i]);
+    }
+
+    // The calling thread claims pipelines alongside the helpers.
+    ExecutePipelineBatch(pState);
+
+    // Helpers which have not started by now would find no work left, so they are revoked instead of waited for.
+    Util::Result waitResult = Util::Result::Success;
+
+    for (uint32_t i = 0; i < helperCount; ++i)
+    {
+        const Util::Result helperResult = pCompiler->FinishPipelineBatchWorkload(&pWorkloads[i]);
+
+        if (helperResult != Util::Result::Success)
+        {
+            waitResult = helperResult;
+        }
+
+        Util::Destructor(&pEvents[i]);
+    }
+
+    VkResult finalResult = PalToVkResult(waitResult);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (i > pState->earlyReturnIndex)
+        {
+            // Another thread may have finished this pipeline before the early return was published.
+            if (pPipelines[i] != VK_NULL_HANDLE)
+            {
+                Pipeline::BaseObjectFromHandle(pPipelines[i])->Destroy(this, VkInstance()->GetAllocCallbacks());
+                pPipelines[i] = VK_NULL_HANDLE;
+            }
+        }
+        else if (pResults[i] != VK_SUCCESS)
+        {
+            // In case of failure, VK_NULL_HANDLE must be set
+            VK_ASSERT(pPipelines[i] == VK_NULL_HANDLE);
+
+            // Capture the first failure result and save it to be returned
+            finalResult = (finalResult != VK_SUCCESS) ? finalResult : pResults[i];
+        }
+    }
+
+    AmdvlkLog(m_settings.logTagIdMask,
+              PipelineBatchTime,
+              "%u-%u-%llu",
+              count,
+              helperCount + 1,
+              utils::TicksToNano(Util::GetPerfCpuTime() - startTimeTicks));
+
+    m_pInstance->FreeMem(pMemory);
+
+    return finalResult;
+}
+
 // =====================================================================================================================
 VkResult Device::CreateGraphicsPipelines(
     VkPipelineCache                             pipelineCache,
@@ -2538,28 +2840,35 @@ VkResult Device::CreateGraphicsPipelines(
         pPipelines[i] = VK_NULL_HANDLE;
     }
 
-    for (uint32_t i = 0; i < count; ++i)
+    if (UseParallelPipelineBatch(count, pAllocator))
     {
-        const VkGraphicsPipelineCreateInfo* pCreateInfo = &pCreateInfos[i];
-
-        VkResult result = GraphicsPipelineCommon::Create(
-            this,
-            pPipelineCache,
-            pCreateInfo,
-            pAllocator,
-            &pPipelines[i]);
-
-        if (result != VK_SUCCESS)
+        finalResult = CreatePipelineBatchParallel(pPipelineCache, count, pCreateInfos, pAllocator, pPipelines);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; ++i)
         {
-            // In case of failure, VK_NULL_HANDLE must be set
-            VK_ASSERT(pPipelines[i] == VK_NULL_HANDLE);
+            const VkGraphicsPipelineCreateInfo* pCreateInfo = &pCreateInfos[i];
 
-            // Capture the first failure result and save it to be returned
-            finalResult = (finalResult != VK_SUCCESS) ? finalResult : result;
+            VkResult result = GraphicsPipelineCommon::Create(
+                this,
+                pPipelineCache,
+                pCreateInfo,
+                pAllocator,
+                &pPipelines[i]);
 
-            if (pCreateInfo->flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)
+            if (result != VK_SUCCESS)
             {
-                break;
+                // In case of failure, VK_NULL_HANDLE must be set
+                VK_ASSERT(pPipelines[i] == VK_NULL_HANDLE);
+
+                // Capture the first failure result and save it to be returned
+                finalResult = (finalResult != VK_SUCCESS) ? finalResult : result;
+
+                if (pCreateInfo->flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)
+                {
+                    break;
+                }
             }
         }
     }
@@ -2587,30 +2896,37 @@ VkResult Device::CreateComputePipelines(
         pPipelines[i] = VK_NULL_HANDLE;
     }
 
-    for (uint32_t i = 0; i < count; ++i)
+    if (UseParallelPipelineBatch(count, pAllocator))
     {
-        const VkComputePipelineCreateInfo* pCreateInfo = &pCreateInfos[i];
+        finalResult = CreatePipelineBatchParallel(pPipelineCache, count, pCreateInfos, pAllocator, pPipelines);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const VkComputePipelineCreateInfo* pCreateInfo = &pCreateInfos[i];
 
-        VkResult result = VK_SUCCESS;
+            VkResult result = VK_SUCCESS;
 
-            result = ComputePipeline::Create(
-                this,
-                pPipelineCache,
-                pCreateInfo,
-                pAllocator,
-                &pPipelines[i]);
+                result = ComputePipeline::Create(
+                    this,
+                    pPipelineCache,
+                    pCreateInfo,
+                    pAllocator,
+                    &pPipelines[i]);
 
-        if (result != VK_SUCCESS)
-        {
-            // In case of failure, VK_NULL_HANDLE must be set
-            VK_ASSERT(pPipelines[i] == VK_NULL_HANDLE);
+            if (result != VK_SUCCESS)
+            {
+                // In case of failure, VK_NULL_HANDLE must be set
+                VK_ASSERT(pPipelines[i] == VK_NULL_HANDLE);
 
-            // Capture the first failure result and save it to be returned
-            finalResult = (finalResult != VK_SUCCESS) ? finalResult : result;
+                // Capture the first failure result and save it to be returned
+                finalResult = (finalResult != VK_SUCCESS) ? finalResult : result;
 
-            if (pCreateInfo->flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)
-            {
-                break;
+                if (pCreateInfo->flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)
+                {
+                    break;
+                }
             }
         }
     }
@@ -3685,6 +4001,120 @@ void* Device::AllocApiObject(
     return pMemory;
 }
 
+// =====================================================================================================================
+// Looks up a layout object in the intern table by the API hash and the create info data of the layout.  On a hit the
+// shared object gains a reference and is returned; otherwise nullptr is returned and the caller creates the layout.
+void* Device::AcquireInternedLayout(
+    InternedLayoutType              type,
+    uint64_t                        apiHash,
+    const void*                     pKey,
+    size_t                          keySize) const
+{
+    Util::MutexAuto lock(&m_internedLayoutMutex);
+
+    InternedLayout* pEntry  = GetInternedLayoutMap(type)->FindKey(apiHash);
+    void*           pObject = nullptr;
+
+    // The hash only selects the entry; the full create info data decides whether the layouts are identical.
+    if ((pEntry != nullptr)           &&
+        (pEntry->keySize == keySize)  &&
+        (memcmp(pEntry->pKey, pKey, keySize) == 0) &&
+        (pEntry->refCount < UINT_MAX))
+    {
+        pEntry->refCount++;
+
+        pObject = pEntry->pObject;
+    }
+
+    return pObject;
+}
+
+// =====================================================================================================================
+// Adds a newly created layout object to the intern table.  The key must stay valid for the lifetime of the object.
+//
+// On return *ppLayout holds the object to hand out:
+//   - the given object, which is now interned;
+//   - an identical layout interned by another thread in the meantime, in which case the caller destroys its own;
+//   - nullptr if a different layout with the same hash is interned, in which case the caller keeps its object but
+//     must not treat it as interned.
+// On failure *ppLayout is set to nullptr and the caller keeps ownership of its object.
+VkResult Device::InternLayout(
+    InternedLayoutType              type,
+    uint64_t                        apiHash,
+    const void*                     pKey,
+    size_t                          keySize,
+    void**                          ppLayout) const
+{
+    Util::MutexAuto lock(&m_internedLayoutMutex);
+
+    bool            existed = false;
+    InternedLayout* pEntry  = nullptr;
+    VkResult        result  = PalToVkResult(GetInternedLayoutMap(type)->FindAllocate(apiHash, &existed, &pEntry));
+
+    if (result == VK_SUCCESS)
+    {
+        if (existed == false)
+        {
+            pEntry->pObject  = *ppLayout;
+            pEntry->pKey     = pKey;
+            pEntry->keySize  = keySize;
+            pEntry->refCount = 1;
+        }
+        else if ((pEntry->keySize != keySize) || (memcmp(pEntry->pKey, pKey, keySize) != 0))
+        {
+            *ppLayout = nullptr;
+        }
+        else if (pEntry->refCount < UINT_MAX)
+        {
+            pEntry->refCount++;
+
+            *ppLayout = pEntry->pObject;
+        }
+        else
+        {
+            result = VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    if (result != VK_SUCCESS)
+    {
+        *ppLayout = nullptr;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Drops a reference to an interned layout object.  Returns true if this was the last reference; the object has then
+// been removed from the intern table and the caller must destroy it.
+bool Device::ReleaseInternedLayout(
+    InternedLayoutType              type,
+    uint64_t                        apiHash,
+    const void*                     pLayout) const
+{
+    Util::MutexAuto lock(&m_internedLayoutMutex);
+
+    InternedLayoutMap* pMap   = GetInternedLayoutMap(type);
+    InternedLayout*    pEntry = pMap->FindKey(apiHash);
+    bool               isLast = false;
+
+    VK_ASSERT((pEntry != nullptr) && (pEntry->pObject == pLayout) && (pEntry->refCount > 0));
+
+    if (pEntry != nullptr)
+    {
+        pEntry->refCount--;
+
+        if (pEntry->refCount == 0)
+        {
+            pMap->Erase(apiHash);
+
+            isLast = true;
+        }
+    }
+
+    return isLast;
+}
+
 // =====================================================================================================================
 // for extension private_data
 void Device::FreeApiObject(
@@ -591,6 +591,9 @@ void DispatchTable::Init()
                         vkResetQueryPool                                );
     INIT_DISPATCH_ENTRY(vkCmdSetLineStippleEXT                          );
 
+    INIT_DISPATCH_ENTRY(vkCmdDrawMultiEXT                               );
+    INIT_DISPATCH_ENTRY(vkCmdDrawMultiIndexedEXT                        );
+
     INIT_DISPATCH_ENTRY(vkSetDeviceMemoryPriorityEXT                    );
 
     INIT_DISPATCH_ENTRY(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT  );
@@ -182,6 +182,8 @@ VkResult GpaSession::CmdBegin(CmdBuffer* pCmdBuf)
 // =====================================================================================================================
 VkResult GpaSession::CmdEnd(CmdBuffer* pCmdBuf)
 {
+    pCmdBuf->FlushPendingBarriers();
+
     Pal::Result palResult = m_session.End(pCmdBuf->PalCmdBuffer(DefaultDeviceIndex));
 
     VkResult result = PalToVkResult(palResult);
@@ -284,6 +286,8 @@ VkResult GpaSession::CmdBeginSample(
 
     if (result == VK_SUCCESS)
     {
+        pCmdbuf->FlushPendingBarriers();
+
         result = PalToVkResult(
             m_session.BeginSample(pCmdbuf->PalCmdBuffer(DefaultDeviceIndex), sampleConfig, pSampleID));
     }
@@ -303,6 +307,8 @@ void GpaSession::CmdEndSample(
 {
     if (sampleID != GpuUtil::InvalidSampleId)
     {
+        pCmdbuf->FlushPendingBarriers();
+
         m_session.EndSample(pCmdbuf->PalCmdBuffer(DefaultDeviceIndex), sampleID);
     }
 }
@@ -311,6 +317,8 @@ void GpaSession::CmdEndSample(
 void GpaSession::CmdCopyResults(
     CmdBuffer* pCmdBuf)
 {
+    pCmdBuf->FlushPendingBarriers();
+
     m_session.CopyResults(pCmdBuf->PalCmdBuffer(DefaultDeviceIndex));
 }
 
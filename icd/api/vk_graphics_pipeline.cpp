@@ -781,6 +781,7 @@ VkResult GraphicsPipeline::BuildDeferCompileWorkload(
         flags.manualReset = true;
         m_deferWorkload.pEvent->Init(flags);
         m_deferWorkload.Execute = ExecuteDeferCreateOptimizedPipeline;
+        m_deferWorkload.queueIdx = DeferCompileThread::InvalidQueueIdx;
     }
 
     return result;
@@ -1078,7 +1079,11 @@ VkResult GraphicsPipeline::Destroy(
 {
     if (m_deferWorkload.pEvent != nullptr)
     {
-        auto result = m_deferWorkload.pEvent->Wait(10);
+        // A deferred compile which no compile thread has picked up yet is simply dropped.
+        PipelineCompiler* pDefaultCompiler = pDevice->GetCompiler(DefaultDeviceIndex);
+        auto result = pDefaultCompiler->RevokeDeferredWorkload(&m_deferWorkload) ?
+                      Util::Result::Success :
+                      m_deferWorkload.pEvent->Wait(10);
         if (result == Util::Result::Success)
         {
             Util::Destructor(m_deferWorkload.pEvent);
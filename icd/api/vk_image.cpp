@@ -193,7 +193,9 @@ Image::Image(
         extraLayoutUsages),
     m_pSwapChain(nullptr),
     m_ResourceKey(resourceKey),
-    m_memoryRequirements{}
+    m_memoryRequirements{},
+    m_pBoundMemory(nullptr),
+    m_boundMemOffset(0)
 {
     m_internalFlags.u32All = internalFlags.u32All;
 
@@ -1159,6 +1161,8 @@ VkResult Image::CreatePresentableImage(
         const bool multiInstance = (pDevice->NumPalDevices() > 1);
         pMemory = VK_PLACEMENT_NEW(pMemObjMemory) Memory(pDevice, pPalMemory, multiInstance);
 
+        Image::ObjectFromHandle(*pImage)->m_pBoundMemory = pMemory;
+
         *pDeviceMemory = Memory::HandleFromObject(pMemory);
 
         return VK_SUCCESS;
@@ -1367,9 +1371,37 @@ VkResult Image::BindMemory(
         }
     }
 
+    if (result == Pal::Result::Success)
+    {
+        m_pBoundMemory   = pMemory;
+        m_boundMemOffset = memOffset;
+    }
+
     return PalToVkResult(result);
 }
 
+// =====================================================================================================================
+// Returns true if this image and the other one may share memory, in which case their layout transitions must not be
+// reordered.  Sparse images are assumed to alias any image as their pages may be bound to any memory.  Presentable
+// images and images bound to them don't track the size of their range, so they alias everything in the same memory.
+bool Image::MayAliasMemory(
+    const Image* pOther) const
+{
+    bool mayAlias = IsSparse() || pOther->IsSparse();
+
+    if ((mayAlias == false) && (m_pBoundMemory != nullptr) && (m_pBoundMemory == pOther->m_pBoundMemory))
+    {
+        const VkDeviceSize size      = m_memoryRequirements.size;
+        const VkDeviceSize otherSize = pOther->m_memoryRequirements.size;
+
+        mayAlias = (size == 0) || (otherSize == 0) ||
+                   ((m_boundMemOffset < (pOther->m_boundMemOffset + otherSize)) &&
+                    (pOther->m_boundMemOffset < (m_boundMemOffset + size)));
+    }
+
+    return mayAlias;
+}
+
 // =====================================================================================================================
 // Binds to Gpu memory already allocated to a swapchain object
 VkResult Image::BindSwapchainMemory(
@@ -1399,6 +1431,9 @@ VkResult Image::BindSwapchainMemory(
 
     Memory* pMemory = Memory::ObjectFromHandle(properties.imageMemory[swapChainImageIndex]);
 
+    m_pBoundMemory   = pMemory;
+    m_boundMemOffset = 0;
+
     Image*  pSwapchainImage    = Image::ObjectFromHandle(properties.images[swapChainImageIndex]);
     Memory* pSwapchainImageMem = Memory::ObjectFromHandle(properties.imageMemory[swapChainImageIndex]);
 
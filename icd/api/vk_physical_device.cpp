@@ -3900,6 +3900,8 @@ DeviceExtensions::Supported PhysicalDevice::GetAvailableExtensions(
 
      availableExtensions.AddExtension(VK_DEVICE_EXTENSION(EXT_NON_SEAMLESS_CUBE_MAP));
 
+    availableExtensions.AddExtension(VK_DEVICE_EXTENSION(EXT_MULTI_DRAW));
+
     bool disableAMDVendorExtensions = false;
     if (pPhysicalDevice != nullptr)
     {
@@ -6248,6 +6250,19 @@ size_t PhysicalDevice::GetFeatures2(
                 break;
             }
 
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDeviceMultiDrawFeaturesEXT*>(pHeader);
+
+                if (updateFeatures)
+                {
+                    pExtInfo->multiDraw = VK_TRUE;
+                }
+
+                structSize = sizeof(*pExtInfo);
+                break;
+            }
+
             default:
             {
                 // skip any unsupported extension structures
@@ -6974,6 +6989,15 @@ void PhysicalDevice::GetDeviceProperties2(
             break;
         }
 
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_PROPERTIES_EXT:
+        {
+            auto* pProps = static_cast<VkPhysicalDeviceMultiDrawPropertiesEXT*>(pNext);
+
+            // Multi-draws are unrolled into individual PAL draws, so there's no hardware limit.
+            pProps->maxMultiDrawCount = UINT32_MAX;
+            break;
+        }
+
         default:
             break;
         }
@@ -107,7 +107,8 @@ VkResult PipelineCache::Create(
                     if (PipelineBinaryCache::IsValidBlob(pPhysicalDevice->VkInstance()->GetAllocCallbacks(),
                                                          pPhysicalDevice->GetPlatformKey(),
                                                          dataSize,
-                                                         pData))
+                                                         pData,
+                                                         pDevice->GetCompiler(DefaultDeviceIndex)))
                     {
                         usePipelineCacheInitialData = true;
                     }
@@ -329,7 +330,9 @@ VkResult PipelineCache::Merge(
             binaryCaches[cacheIdx] = ppSrcCaches[cacheIdx]->GetPipelineCache();
         }
 
-        result = m_pBinaryCache->Merge(srcCacheCount, &binaryCaches[0]);
+        result = m_pBinaryCache->Merge(srcCacheCount,
+                                       &binaryCaches[0],
+                                       m_pDevice->GetCompiler(DefaultDeviceIndex));
     }
     else
     {
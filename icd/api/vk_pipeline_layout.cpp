@@ -96,6 +96,58 @@ uint64_t PipelineLayout::BuildApiHash(
     return hash;
 }
 
+// =====================================================================================================================
+// Builds the key of the pipeline layout intern table into pKey, if not null, and returns its size in bytes.  The key
+// holds the create flags, the intern keys of the descriptor set layouts and the push constant ranges.  All non-null
+// descriptor set layouts must be interned.
+size_t PipelineLayout::BuildInternKey(
+    const VkPipelineLayoutCreateInfo* pCreateInfo,
+    void*                             pKey)
+{
+    size_t keySize = 0;
+
+    const uint32_t header[] = { pCreateInfo->flags, pCreateInfo->setLayoutCount, pCreateInfo->pushConstantRangeCount };
+
+    if (pKey != nullptr)
+    {
+        memcpy(pKey, header, sizeof(header));
+    }
+
+    keySize += sizeof(header);
+
+    for (uint32_t i = 0; i < pCreateInfo->setLayoutCount; i++)
+    {
+        size_t      setKeySize = 0;
+        const void* pSetKey    = nullptr;
+
+        if (pCreateInfo->pSetLayouts[i] != VK_NULL_HANDLE)
+        {
+            pSetKey = DescriptorSetLayout::ObjectFromHandle(pCreateInfo->pSetLayouts[i])->GetInternKey(&setKeySize);
+
+            VK_ASSERT(pSetKey != nullptr);
+        }
+
+        if (pKey != nullptr)
+        {
+            memcpy(Util::VoidPtrInc(pKey, keySize), &setKeySize, sizeof(setKeySize));
+            memcpy(Util::VoidPtrInc(pKey, keySize + sizeof(setKeySize)), pSetKey, setKeySize);
+        }
+
+        keySize += sizeof(setKeySize) + setKeySize;
+    }
+
+    const size_t rangesSize = pCreateInfo->pushConstantRangeCount * sizeof(VkPushConstantRange);
+
+    if ((pKey != nullptr) && (rangesSize > 0))
+    {
+        memcpy(Util::VoidPtrInc(pKey, keySize), pCreateInfo->pPushConstantRanges, rangesSize);
+    }
+
+    keySize += rangesSize;
+
+    return keySize;
+}
+
 // =====================================================================================================================
 constexpr size_t PipelineLayout::GetMaxResMappingRootNodeSize()
 {
@@ -128,7 +180,8 @@ PipelineLayout::PipelineLayout(
     m_info(info),
     m_pipelineInfo(pipelineInfo),
     m_pDevice(pDevice),
-    m_apiHash(apiHash)
+    m_apiHash(apiHash),
+    m_interned(false)
 {
 
 }
@@ -638,12 +691,48 @@ VkResult PipelineLayout::Create(
 
     size_t setLayoutsArraySize = 0;
 
+    // Identical layouts share one immutable object through the device's intern table.  As for descriptor set layouts,
+    // only layouts created without application allocation callbacks are interned, and only if all of their descriptor
+    // set layouts are interned as well; this also excludes layouts referring to YCbCr immutable samplers.
+    bool intern = pDevice->UseLayoutInterning() && (pAllocator == pDevice->VkInstance()->GetAllocCallbacks());
+
     for (uint32_t i = 0; i < pCreateInfo->setLayoutCount; ++i)
     {
         DescriptorSetLayout* pLayout = DescriptorSetLayout::ObjectFromHandle(pCreateInfo->pSetLayouts[i]);
         if (pLayout != nullptr)
         {
+            size_t setKeySize = 0;
+
             setLayoutsArraySize += pLayout->GetObjectSize(VK_SHADER_STAGE_ALL);
+
+            intern &= (pLayout->GetInternKey(&setKeySize) != nullptr);
+        }
+    }
+
+    size_t keySize = 0;
+    void*  pKey    = nullptr;
+
+    if (intern)
+    {
+        keySize = BuildInternKey(pCreateInfo, nullptr);
+        pKey    = pDevice->VkInstance()->AllocMem(keySize, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+
+        if (pKey == nullptr)
+        {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        BuildInternKey(pCreateInfo, pKey);
+
+        void* pInterned = pDevice->AcquireInternedLayout(Device::InternedLayoutType::Pipeline, apiHash, pKey, keySize);
+
+        if (pInterned != nullptr)
+        {
+            pDevice->VkInstance()->FreeMem(pKey);
+
+            *pPipelineLayout = PipelineLayout::HandleFromVoidPointer(pInterned);
+
+            return VK_SUCCESS;
         }
     }
 
@@ -657,7 +746,8 @@ VkResult PipelineLayout::Create(
 
     size_t objSize = apiSize + setUserDataLayoutSize + descriptorSetLayoutSize + setLayoutsArraySize;
 
-    void* pSysMem = pDevice->AllocApiObject(pAllocator, objSize);
+    // The intern key is stored after the layout data.
+    void* pSysMem = pDevice->AllocApiObject(pAllocator, objSize + keySize);
 
     if (pSysMem == nullptr)
     {
@@ -710,18 +800,47 @@ VkResult PipelineLayout::Create(
             }
         }
 
-        VK_PLACEMENT_NEW(pSysMem) PipelineLayout(pDevice, info, pipelineInfo, apiHash);
+        PipelineLayout* pObject = VK_PLACEMENT_NEW(pSysMem) PipelineLayout(pDevice, info, pipelineInfo, apiHash);
 
-        *pPipelineLayout = PipelineLayout::HandleFromVoidPointer(pSysMem);
-    }
+        if (intern)
+        {
+            void* pInterned = pSysMem;
+            void* pObjKey   = Util::VoidPtrInc(pSysMem, objSize);
 
-    if (result != VK_SUCCESS)
-    {
-        if (pSysMem != nullptr)
+            memcpy(pObjKey, pKey, keySize);
+
+            pObject->m_interned = true;
+
+            result = pDevice->InternLayout(Device::InternedLayoutType::Pipeline, apiHash, pObjKey, keySize, &pInterned);
+
+            if ((result == VK_SUCCESS) && (pInterned == nullptr))
+            {
+                // A different layout with the same hash is interned, so this one stays private to its handle.
+                pObject->m_interned = false;
+            }
+            else if (pInterned != pSysMem)
+            {
+                // Drop this object if an identical layout was interned concurrently or the intern table is out of
+                // memory.
+                pObject->~PipelineLayout();
+
+                pDevice->FreeApiObject(pAllocator, pSysMem);
+
+                pSysMem = pInterned;
+            }
+        }
+
+        if (result == VK_SUCCESS)
         {
-            pDevice->FreeApiObject(pAllocator, pSysMem);
+            *pPipelineLayout = PipelineLayout::HandleFromVoidPointer(pSysMem);
         }
     }
+    else if (pSysMem != nullptr)
+    {
+        pDevice->FreeApiObject(pAllocator, pSysMem);
+    }
+
+    pDevice->VkInstance()->FreeMem(pKey);
 
     return result;
 }
@@ -1378,18 +1497,23 @@ VkResult PipelineLayout::Destroy(
     Device*                         pDevice,
     const VkAllocationCallbacks*    pAllocator)
 {
-    for (uint32_t i = 0; i < m_info.setCount; ++i)
+    // An interned layout is shared by all of its API handles and is only destroyed together with the last of them.
+    if ((m_interned == false) ||
+        pDevice->ReleaseInternedLayout(Device::InternedLayoutType::Pipeline, m_apiHash, this))
     {
-        DescriptorSetLayout* pSetLayout = GetSetLayouts(i);
-        if (pSetLayout != nullptr)
+        for (uint32_t i = 0; i < m_info.setCount; ++i)
         {
-            pSetLayout->Destroy(pDevice, pAllocator, false);
+            DescriptorSetLayout* pSetLayout = GetSetLayouts(i);
+            if (pSetLayout != nullptr)
+            {
+                pSetLayout->Destroy(pDevice, pAllocator, false);
+            }
         }
-    }
 
-    this->~PipelineLayout();
+        this->~PipelineLayout();
 
-    pDevice->FreeApiObject(pAllocator, this);
+        pDevice->FreeApiObject(pAllocator, this);
+    }
 
     return VK_SUCCESS;
 }